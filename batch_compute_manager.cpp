@@ -1,12 +1,17 @@
 #include "batch_compute_manager.h"
+#include "sensor_clock.h"
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/classes/engine.hpp>
 #include <godot_cpp/classes/viewport.hpp>
 #include <godot_cpp/classes/viewport_texture.hpp>
 #include <godot_cpp/classes/texture2d.hpp>
 #include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
+#include <algorithm>
 #include <chrono>
+#include <memory>
+#include <thread>
 
 // Metal implementation is in platform/macos/batch_compute_manager_macos.mm
 
@@ -28,6 +33,9 @@ void BatchComputeManager::_bind_methods() {
     ClassDB::bind_method(D_METHOD("process_sensors", "viewport_texture"), &BatchComputeManager::process_sensors);
     ClassDB::bind_method(D_METHOD("get_sensor_result", "sensor_id"), &BatchComputeManager::get_sensor_result);
     ClassDB::bind_method(D_METHOD("get_all_results"), &BatchComputeManager::get_all_results);
+    ClassDB::bind_method(D_METHOD("submit_sensors_async", "viewport_texture"), &BatchComputeManager::submit_sensors_async);
+    ClassDB::bind_method(D_METHOD("poll_async_results"), &BatchComputeManager::poll_async_results);
+    ClassDB::bind_method(D_METHOD("is_async_busy"), &BatchComputeManager::is_async_busy);
     
     // Configuration
     ClassDB::bind_method(D_METHOD("set_max_sensors", "max_count"), &BatchComputeManager::set_max_sensors);
@@ -37,11 +45,31 @@ void BatchComputeManager::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_use_direct_texture_access"), &BatchComputeManager::get_use_direct_texture_access);
     ClassDB::bind_method(D_METHOD("set_force_gpu_mode", "force_gpu"), &BatchComputeManager::set_force_gpu_mode);
     ClassDB::bind_method(D_METHOD("get_force_gpu_mode"), &BatchComputeManager::get_force_gpu_mode);
+    ClassDB::bind_method(D_METHOD("set_prefer_gpu_backend", "prefer_gpu"), &BatchComputeManager::set_prefer_gpu_backend);
+    ClassDB::bind_method(D_METHOD("get_prefer_gpu_backend"), &BatchComputeManager::get_prefer_gpu_backend);
+    ClassDB::bind_method(D_METHOD("is_using_gpu_backend"), &BatchComputeManager::is_using_gpu_backend);
+    ClassDB::bind_method(D_METHOD("set_use_coherence_skip", "enabled"), &BatchComputeManager::set_use_coherence_skip);
+    ClassDB::bind_method(D_METHOD("get_use_coherence_skip"), &BatchComputeManager::get_use_coherence_skip);
+    ClassDB::bind_method(D_METHOD("set_use_region_dedup", "enabled"), &BatchComputeManager::set_use_region_dedup);
+    ClassDB::bind_method(D_METHOD("get_use_region_dedup"), &BatchComputeManager::get_use_region_dedup);
+    ClassDB::bind_method(D_METHOD("set_use_summed_area_table", "enabled"), &BatchComputeManager::set_use_summed_area_table);
+    ClassDB::bind_method(D_METHOD("get_use_summed_area_table"), &BatchComputeManager::get_use_summed_area_table);
+    ClassDB::bind_method(D_METHOD("set_use_linear_averaging", "enabled"), &BatchComputeManager::set_use_linear_averaging);
+    ClassDB::bind_method(D_METHOD("get_use_linear_averaging"), &BatchComputeManager::get_use_linear_averaging);
+    ClassDB::bind_method(D_METHOD("set_linear_color_output", "enabled"), &BatchComputeManager::set_linear_color_output);
+    ClassDB::bind_method(D_METHOD("get_linear_color_output"), &BatchComputeManager::get_linear_color_output);
     
     // Statistics
     ClassDB::bind_method(D_METHOD("get_sensor_count"), &BatchComputeManager::get_sensor_count);
     ClassDB::bind_method(D_METHOD("get_max_sensors"), &BatchComputeManager::get_max_sensors);
     ClassDB::bind_method(D_METHOD("is_processing_active"), &BatchComputeManager::is_processing_active);
+    ClassDB::bind_method(D_METHOD("get_coherence_stats"), &BatchComputeManager::get_coherence_stats);
+    ClassDB::bind_method(D_METHOD("get_async_stats"), &BatchComputeManager::get_async_stats);
+    ClassDB::bind_method(D_METHOD("get_pipeline_graph"), &BatchComputeManager::get_pipeline_graph);
+    ClassDB::bind_method(D_METHOD("set_max_batches_in_flight", "count"), &BatchComputeManager::set_max_batches_in_flight);
+    ClassDB::bind_method(D_METHOD("get_max_batches_in_flight"), &BatchComputeManager::get_max_batches_in_flight);
+    ClassDB::bind_method(D_METHOD("get_allocation_stats"), &BatchComputeManager::get_allocation_stats);
+    ClassDB::bind_method(D_METHOD("reset_coherence_stats"), &BatchComputeManager::reset_coherence_stats);
 }
 
 BatchComputeManager::BatchComputeManager() {
@@ -76,27 +104,32 @@ bool BatchComputeManager::initialize() {
         return true;
     }
     
-#ifdef __APPLE__
-    if (!_init_metal_device()) {
-        return false;
-    }
+    use_gpu_backend = false;
     
-    if (!_create_compute_pipelines()) {
+#ifdef __APPLE__
+    if (_init_metal_device() && _create_compute_pipelines() && _create_buffers()) {
+        use_gpu_backend = true;
+    } else if (force_gpu_mode) {
         return false;
     }
-    
-    if (!_create_buffers()) {
+#else
+    if (force_gpu_mode) {
+        UtilityFunctions::push_error("GPU acceleration required but no batch GPU backend exists on this platform.");
         return false;
     }
+#endif
     
+    // Without a GPU pipeline the CPU snapshot backend handles every batch
     is_initialized.store(true);
     return true;
-#else
-    return false;
-#endif
 }
 
 void BatchComputeManager::shutdown() {
+    // A queued or running background batch still references this object
+    while (async_in_flight.load() > 0) {
+        std::this_thread::yield();
+    }
+    
     if (!is_initialized.load()) {
         return;
     }
@@ -107,10 +140,15 @@ void BatchComputeManager::shutdown() {
     _cleanup_metal_resources();
 #endif
     
+    // Let a running background batch finish before tearing down its inputs
+    std::lock_guard<std::mutex> snapshot_lock(snapshot_mutex);
     std::lock_guard<std::mutex> lock(data_mutex);
     sensor_regions.clear();
     sensor_results.clear();
+    region_cache.clear();
+    cpu_snapshot.clear();
     
+    use_gpu_backend = false;
     is_initialized.store(false);
     UtilityFunctions::print("[BatchComputeManager] Shutdown complete");
 }
@@ -133,6 +171,7 @@ void BatchComputeManager::add_sensor(int sensor_id, float screen_x, float screen
     // Add new sensor
     sensor_regions.emplace_back(screen_x, screen_y, radius, sensor_id);
     sensor_results.emplace_back(Color(0, 0, 0, 1)); // Initialize with black
+    region_layout_generation++;
     
     _resize_buffers_if_needed();
 }
@@ -144,6 +183,7 @@ void BatchComputeManager::remove_sensor(int sensor_id) {
     if (index >= 0) {
         sensor_regions.erase(sensor_regions.begin() + index);
         sensor_results.erase(sensor_results.begin() + index);
+        region_layout_generation++;
     }
 }
 
@@ -151,6 +191,7 @@ void BatchComputeManager::clear_all_sensors() {
     std::lock_guard<std::mutex> lock(data_mutex);
     sensor_regions.clear();
     sensor_results.clear();
+    region_layout_generation++;
 }
 
 void BatchComputeManager::set_sample_radius(int radius) {
@@ -162,6 +203,37 @@ void BatchComputeManager::set_sample_radius(int radius) {
     }
 }
 
+void BatchComputeManager::set_sensor_regions(const std::vector<SensorRegion> &regions) {
+    std::lock_guard<std::mutex> lock(data_mutex);
+    sensor_regions = regions;
+    sensor_results.resize(sensor_regions.size(), Color(0, 0, 0, 1));
+    region_layout_generation++;
+    _resize_buffers_if_needed();
+}
+
+void BatchComputeManager::append_sensor_regions(const SensorRegion *regions, size_t count) {
+    std::lock_guard<std::mutex> lock(data_mutex);
+    sensor_regions.insert(sensor_regions.end(), regions, regions + count);
+    sensor_results.resize(sensor_regions.size(), Color(0, 0, 0, 1));
+    region_layout_generation++;
+    _resize_buffers_if_needed();
+}
+
+void BatchComputeManager::copy_results(std::vector<Color> &out_results) const {
+    std::lock_guard<std::mutex> lock(data_mutex);
+    out_results.assign(sensor_results.begin(), sensor_results.end());
+}
+
+void BatchComputeManager::set_region_due_mask(const std::vector<uint8_t> &due) {
+    std::lock_guard<std::mutex> lock(data_mutex);
+    region_due.assign(due.begin(), due.end());
+}
+
+uint64_t BatchComputeManager::get_region_layout_generation() const {
+    std::lock_guard<std::mutex> lock(data_mutex);
+    return region_layout_generation;
+}
+
 bool BatchComputeManager::process_sensors(Ref<ViewportTexture> viewport_texture) {
     if (!is_initialized.load() || !viewport_texture.is_valid()) {
         return false;
@@ -172,32 +244,29 @@ bool BatchComputeManager::process_sensors(Ref<ViewportTexture> viewport_texture)
     
     is_processing.store(true);
     
+    bool ok;
 #ifdef __APPLE__
-    if (!_create_viewport_texture(viewport_texture)) {
-        is_processing.store(false);
-        return false;
-    }
-    
-    if (!_update_sensor_regions_buffer()) {
-        is_processing.store(false);
-        return false;
-    }
-    
-    if (!_dispatch_compute_kernel()) {
-        is_processing.store(false);
-        return false;
-    }
+    if (use_gpu_backend && prefer_gpu_backend) {
+        ok = _create_viewport_texture(viewport_texture) &&
+                _update_sensor_regions_buffer() &&
+                _dispatch_compute_kernel() &&
+                _read_results();
+    } else
+#endif
+    ok = _process_sensors_cpu(viewport_texture);
     
-    if (!_read_results()) {
+    // End of tick: every scratch allocation made during it is released at once
+    tick_arena.reset();
+    if (!ok) {
         is_processing.store(false);
         return false;
     }
-#endif
     
     // M6.5: End performance timing and log results
     auto end_time = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
     double processing_time_ms = duration.count() / 1000.0;
+    _record_tick_usec(static_cast<uint64_t>(duration.count()));
     
     // Log performance warnings if batch processing is too slow
     if (processing_time_ms > 0.2) { // Target: <0.2ms per sensor
@@ -228,6 +297,56 @@ Array BatchComputeManager::get_all_results() const {
     return result;
 }
 
+void BatchComputeManager::set_region_space_size(const Vector2 &size) {
+    region_space_size = size;
+}
+
+Vector2 BatchComputeManager::get_region_space_size() const {
+    return region_space_size;
+}
+
+void BatchComputeManager::notify_viewport_resized(const Vector2 &region_space, const Vector2i &texture_size) {
+    region_space_size = region_space;
+    viewport_resize_count++;
+    
+    // Grow now rather than on the first tick at the new size. If a background batch holds
+    // the snapshot, the next ingest grows it instead.
+    std::unique_lock<std::mutex> lock(snapshot_mutex, std::try_to_lock);
+    if (lock.owns_lock()) {
+        cpu_snapshot.reserve(texture_size.x, texture_size.y);
+    }
+}
+
+bool BatchComputeManager::has_snapshot() const {
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    return cpu_snapshot.is_valid();
+}
+
+uint64_t BatchComputeManager::get_snapshot_frame() const {
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    return cpu_snapshot.frame;
+}
+
+Color BatchComputeManager::sample_snapshot(float center_x, float center_y, int radius) const {
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    const Vector2 scale = _snapshot_scale(region_space_size);
+    return cpu_snapshot.sample_region(center_x * scale.x, center_y * scale.y, radius, sensor_color_mode(use_linear_averaging, linear_color_output));
+}
+
+bool BatchComputeManager::try_sample_snapshot_batch(const Vector2 *centers, const int *radii, size_t count, Color *out_colors) const {
+    std::unique_lock<std::mutex> lock(snapshot_mutex, std::try_to_lock);
+    if (!lock.owns_lock() || !cpu_snapshot.is_valid()) {
+        return false;
+    }
+    const SensorColorMode mode = sensor_color_mode(use_linear_averaging, linear_color_output);
+    // Centers are in region space, like the tick's regions (the snapshot may be a proxy capture)
+    const Vector2 scale = _snapshot_scale(region_space_size);
+    for (size_t i = 0; i < count; ++i) {
+        out_colors[i] = cpu_snapshot.sample_region(centers[i].x * scale.x, centers[i].y * scale.y, radii[i], mode);
+    }
+    return true;
+}
+
 void BatchComputeManager::set_max_sensors(int max_count) {
     max_sensors = Math::max(1, max_count);
     sensor_regions.reserve(max_sensors);
@@ -258,6 +377,82 @@ bool BatchComputeManager::get_force_gpu_mode() const {
     return force_gpu_mode;
 }
 
+void BatchComputeManager::set_prefer_gpu_backend(bool prefer_gpu) {
+    prefer_gpu_backend = prefer_gpu;
+}
+
+bool BatchComputeManager::get_prefer_gpu_backend() const {
+    return prefer_gpu_backend;
+}
+
+bool BatchComputeManager::is_using_gpu_backend() const {
+    return use_gpu_backend && prefer_gpu_backend;
+}
+
+void BatchComputeManager::set_use_coherence_skip(bool enabled) {
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    use_coherence_skip = enabled;
+    if (!enabled) {
+        for (auto &entry : region_cache) {
+            entry.valid = false;
+        }
+    }
+}
+
+bool BatchComputeManager::get_use_coherence_skip() const {
+    return use_coherence_skip;
+}
+
+void BatchComputeManager::set_use_region_dedup(bool enabled) {
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    use_region_dedup = enabled;
+}
+
+bool BatchComputeManager::get_use_region_dedup() const {
+    return use_region_dedup;
+}
+
+void BatchComputeManager::set_use_summed_area_table(bool enabled) {
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    use_summed_area_table = enabled;
+    if (!enabled) {
+        cpu_snapshot.drop_summed_area_tables();
+    }
+}
+
+bool BatchComputeManager::get_use_summed_area_table() const {
+    return use_summed_area_table;
+}
+
+void BatchComputeManager::set_use_linear_averaging(bool enabled) {
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    if (use_linear_averaging != enabled) {
+        use_linear_averaging = enabled;
+        // Cached colors were averaged the other way
+        for (auto &entry : region_cache) {
+            entry.valid = false;
+        }
+    }
+}
+
+bool BatchComputeManager::get_use_linear_averaging() const {
+    return use_linear_averaging;
+}
+
+void BatchComputeManager::set_linear_color_output(bool enabled) {
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    if (linear_color_output != enabled) {
+        linear_color_output = enabled;
+        for (auto &entry : region_cache) {
+            entry.valid = false;
+        }
+    }
+}
+
+bool BatchComputeManager::get_linear_color_output() const {
+    return linear_color_output;
+}
+
 int BatchComputeManager::get_sensor_count() const {
     std::lock_guard<std::mutex> lock(data_mutex);
     return static_cast<int>(sensor_regions.size());
@@ -271,6 +466,535 @@ bool BatchComputeManager::is_processing_active() const {
     return is_processing.load();
 }
 
+Dictionary BatchComputeManager::get_coherence_stats() const {
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    Dictionary stats;
+    stats["sampled"] = total_sampled_count;
+    stats["skipped"] = total_skipped_count;
+    stats["last_sampled"] = last_sampled_count;
+    stats["last_skipped"] = last_skipped_count;
+    stats["held"] = total_held_count;
+    stats["last_held"] = last_held_count;
+    stats["last_culled"] = last_culled_count;
+    stats["deduplicated"] = total_deduplicated_count;
+    stats["last_deduplicated"] = last_deduplicated_count;
+    // Sensors per distinct region resolved in the last tick (1.0: no sharing)
+    const int last_unique = last_sampled_count + last_skipped_count;
+    stats["last_dedup_ratio"] = last_unique > 0 ? static_cast<double>(last_unique + last_deduplicated_count) / last_unique : 1.0;
+    stats["last_changed_tiles"] = cpu_snapshot.last_changed_tiles;
+    stats["tile_count"] = cpu_snapshot.tiles_x * cpu_snapshot.tiles_y;
+    stats["last_sat_rebuilt_tiles"] = use_summed_area_table ? cpu_snapshot.last_sat_rebuilt_tiles : 0;
+    return stats;
+}
+
+void BatchComputeManager::reset_coherence_stats() {
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    total_sampled_count = 0;
+    total_skipped_count = 0;
+    last_sampled_count = 0;
+    last_skipped_count = 0;
+    total_held_count = 0;
+    last_held_count = 0;
+    last_culled_count = 0;
+    total_deduplicated_count = 0;
+    last_deduplicated_count = 0;
+}
+
+bool BatchComputeManager::_process_sensors_cpu(Ref<ViewportTexture> viewport_texture) {
+    // Single readback for the whole batch; every region is averaged from the same snapshot
+    Ref<Image> image = viewport_texture->get_image();
+    if (image.is_null()) {
+        return false;
+    }
+    uint64_t frame = Engine::get_singleton()->get_process_frames();
+    
+    // Region copy and results live in the tick arena; nothing here touches the heap once warm
+    size_t count = 0;
+    SensorRegion *regions = nullptr;
+    uint8_t *due = nullptr;
+    uint64_t layout_generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(data_mutex);
+        layout_generation = region_layout_generation;
+        count = sensor_regions.size();
+        regions = tick_arena.alloc_array<SensorRegion>(count);
+        std::copy(sensor_regions.begin(), sensor_regions.end(), regions);
+        if (region_due.size() == count) {
+            due = tick_arena.alloc_array<uint8_t>(count);
+            std::copy(region_due.begin(), region_due.end(), due);
+        }
+    }
+    
+    Color *results = tick_arena.alloc_array<Color>(count);
+    SensorBatchPipeline &pipeline = _get_pipeline(0);
+    pipeline.image = image;
+    pipeline.frame = frame;
+    pipeline.ticket = 0;
+    pipeline.image_width = image->get_width();
+    pipeline.image_height = image->get_height();
+    pipeline.region_space = region_space_size;
+    pipeline.regions = regions;
+    pipeline.due = due;
+    pipeline.count = count;
+    pipeline.results = results;
+    pipeline.dedup = use_region_dedup;
+    const bool ok = _ingest_and_sample(pipeline);
+    pipeline.image.unref();
+    if (!ok) {
+        return false;
+    }
+    
+    // Regions inserted or removed meanwhile: result i may belong to another sensor now
+    std::lock_guard<std::mutex> lock(data_mutex);
+    if (layout_generation == region_layout_generation) {
+        std::copy(results, results + count, sensor_results.begin());
+    }
+    return true;
+}
+
+Vector2 BatchComputeManager::_snapshot_scale(const Vector2 &region_space) const {
+    if (region_space.x > 0.0f && region_space.y > 0.0f && cpu_snapshot.is_valid()) {
+        return Vector2(static_cast<float>(cpu_snapshot.width) / region_space.x, static_cast<float>(cpu_snapshot.height) / region_space.y);
+    }
+    return Vector2(1.0f, 1.0f);
+}
+
+SensorBatchPipeline &BatchComputeManager::_get_pipeline(int slot) {
+    std::unique_ptr<SensorBatchPipeline> &pipeline = batch_pipelines[slot];
+    if (pipeline) {
+        return *pipeline;
+    }
+    
+    // Built once; the stages read their batch from the pipeline they belong to
+    pipeline = std::make_unique<SensorBatchPipeline>();
+    SensorBatchPipeline *p = pipeline.get();
+    SensorTaskGraph &graph = p->graph;
+    const int wait = graph.add_stage("wait_snapshot", [this, p]() { _stage_wait_snapshot(*p); }, {}, true);
+    const int bin = graph.add_stage("bin", [this, p]() { _stage_bin(*p); });
+    const int ingest = graph.add_stage("ingest", [this, p]() { _stage_ingest(*p); }, { wait });
+    const int tables = graph.add_stage("summed_area_tables", [this, p]() { _stage_summed_area_tables(*p); }, { ingest });
+    const int sample = graph.add_stage("sample", [this, p]() { _stage_sample(*p); }, { bin, tables });
+    const int resolve = graph.add_stage("resolve", [this, p]() { _stage_resolve(*p); }, { sample });
+    graph.add_stage("release", [this, p]() { _stage_release(*p); }, { resolve }, true);
+    return *pipeline;
+}
+
+bool BatchComputeManager::_ingest_and_sample(SensorBatchPipeline &pipeline) {
+    pipeline.ok = false;
+    pipeline.graph.run(SensorWorkerPool::get_singleton());
+    
+    std::lock_guard<std::mutex> lock(graph_trace_mutex);
+    pipeline.graph.copy_trace(graph_trace);
+    graph_trace_ticket = pipeline.ticket;
+    graph_trace_frame = pipeline.frame;
+    graph_trace_usec = pipeline.graph.get_last_run_usec();
+    return pipeline.ok;
+}
+
+void BatchComputeManager::_stage_wait_snapshot(SensorBatchPipeline &pipeline) {
+    std::unique_lock<std::mutex> lock(snapshot_mutex);
+    if (pipeline.ticket > 0) {
+        // A later batch may get here first; it waits for the earlier one to release
+        snapshot_turn_cv.wait(lock, [this, &pipeline] { return snapshot_turn_ticket + 1 >= pipeline.ticket; });
+    }
+    // Stays locked until the release stage, which runs on this same thread
+    lock.release();
+}
+
+void BatchComputeManager::_stage_release(SensorBatchPipeline &pipeline) {
+    if (pipeline.ticket > 0) {
+        snapshot_turn_ticket = std::max(snapshot_turn_ticket, pipeline.ticket);
+    }
+    snapshot_mutex.unlock();
+    snapshot_turn_cv.notify_all();
+}
+
+void BatchComputeManager::_stage_bin(SensorBatchPipeline &pipeline) {
+    const size_t count = pipeline.count;
+    pipeline.centers.resize(count);
+    pipeline.region_route.resize(count);
+    pipeline.unique_regions.clear();
+    pipeline.culled = 0;
+    if (pipeline.dedup) {
+        pipeline.region_dedup.begin(count);
+    }
+    
+    // Map centers onto the image when it is not the size the positions were computed for
+    // (stretch modes, proxy captures, a resize landing between projection and capture)
+    const Vector2 &space = pipeline.region_space;
+    const float scale_x = space.x > 0.0f && space.y > 0.0f ? static_cast<float>(pipeline.image_width) / space.x : 1.0f;
+    const float scale_y = space.x > 0.0f && space.y > 0.0f ? static_cast<float>(pipeline.image_height) / space.y : 1.0f;
+    
+    for (size_t i = 0; i < count; ++i) {
+        const SensorRegion &region = pipeline.regions[i];
+        const Vector2 center(region.center_x * scale_x, region.center_y * scale_y);
+        pipeline.centers[i] = center;
+        
+        // Sampling uses the integer center, so sub-pixel motion still reads the same pixels
+        const int cx = static_cast<int>(center.x);
+        const int cy = static_cast<int>(center.y);
+        if (cx + region.radius < 0 || cy + region.radius < 0 ||
+                cx - region.radius >= pipeline.image_width || cy - region.radius >= pipeline.image_height) {
+            pipeline.region_route[i] = SensorBatchPipeline::ROUTE_CULLED;
+            pipeline.culled++;
+            continue;
+        }
+        
+        // Not due this tick: keep the last sample. Held regions never own a dedup key, so a due
+        // region at the same spot still gets a fresh sample.
+        if (pipeline.due && !pipeline.due[i]) {
+            pipeline.region_route[i] = SensorBatchPipeline::ROUTE_HOLD;
+            pipeline.unique_regions.push_back(static_cast<uint32_t>(i));
+            continue;
+        }
+        
+        // Dense sensors (many on one character) often quantize to the same region: fan out
+        // the result of the first one instead of sampling again
+        if (pipeline.dedup) {
+            const int64_t owner = pipeline.region_dedup.find_or_insert(SensorRegionDedup::make_key(cx, cy, region.radius), static_cast<uint32_t>(i));
+            if (owner >= 0) {
+                pipeline.region_route[i] = static_cast<int32_t>(owner);
+                continue;
+            }
+        }
+        pipeline.region_route[i] = SensorBatchPipeline::ROUTE_SAMPLE;
+        pipeline.unique_regions.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+void BatchComputeManager::_stage_ingest(SensorBatchPipeline &pipeline) {
+    pipeline.ok = cpu_snapshot.ingest_image(pipeline.image, pipeline.frame);
+    if (pipeline.ok) {
+        region_cache.resize(pipeline.count);
+    }
+}
+
+void BatchComputeManager::_stage_summed_area_tables(SensorBatchPipeline &pipeline) {
+    if (!pipeline.ok) {
+        return;
+    }
+    if (use_summed_area_table) {
+        // Only tiles whose hash changed since their table was built are rebuilt
+        cpu_snapshot.update_summed_area_tables(sensor_color_mode(use_linear_averaging, linear_color_output), SensorWorkerPool::get_singleton());
+    }
+}
+
+void BatchComputeManager::_stage_sample(SensorBatchPipeline &pipeline) {
+    pipeline.sampled.store(0);
+    pipeline.skipped.store(0);
+    pipeline.held.store(0);
+    if (!pipeline.ok) {
+        return;
+    }
+    
+    // Every unique region owns its result and cache slot, so ranges sample independently
+    const SensorColorMode mode = sensor_color_mode(use_linear_averaging, linear_color_output);
+    SensorBatchPipeline *p = &pipeline;
+    SensorWorkerPool::get_singleton()->parallel_for(pipeline.unique_regions.size(), 256, [this, p, mode](size_t begin, size_t end) {
+        int sampled = 0;
+        int skipped = 0;
+        int held = 0;
+        for (size_t k = begin; k < end; ++k) {
+            const uint32_t i = p->unique_regions[k];
+            const SensorRegion &region = p->regions[i];
+            const Vector2 &center = p->centers[i];
+            SensorRegionCache &cache = region_cache[i];
+            const int cx = static_cast<int>(center.x);
+            const int cy = static_cast<int>(center.y);
+            
+            // A slot that shifted to another sensor samples for real
+            if (p->region_route[i] == SensorBatchPipeline::ROUTE_HOLD && cache.valid && cache.sensor_id == region.sensor_id) {
+                p->results[i] = cache.color;
+                held++;
+                continue;
+            }
+            
+            if (use_coherence_skip && cache.valid && cache.center_x == cx && cache.center_y == cy &&
+                    cache.radius == region.radius &&
+                    cpu_snapshot.is_region_unchanged_since(center.x, center.y, region.radius, cache.generation)) {
+                p->results[i] = cache.color;
+                skipped++;
+                continue;
+            }
+            
+            p->results[i] = cpu_snapshot.sample_region(center.x, center.y, region.radius, mode);
+            cache.sensor_id = region.sensor_id;
+            cache.center_x = cx;
+            cache.center_y = cy;
+            cache.radius = region.radius;
+            cache.generation = cpu_snapshot.generation;
+            cache.color = p->results[i];
+            cache.valid = true;
+            sampled++;
+        }
+        p->sampled.fetch_add(sampled);
+        p->skipped.fetch_add(skipped);
+        p->held.fetch_add(held);
+    });
+}
+
+void BatchComputeManager::_stage_resolve(SensorBatchPipeline &pipeline) {
+    if (!pipeline.ok) {
+        return;
+    }
+    
+    // Owners always come first, so one forward pass fans their results out
+    int deduplicated = 0;
+    for (size_t i = 0; i < pipeline.count; ++i) {
+        const int32_t route = pipeline.region_route[i];
+        if (route >= 0) {
+            pipeline.results[i] = pipeline.results[route];
+            region_cache[i] = region_cache[route];
+            region_cache[i].sensor_id = pipeline.regions[i].sensor_id;
+            deduplicated++;
+        } else if (route == SensorBatchPipeline::ROUTE_CULLED) {
+            pipeline.results[i] = Color(0, 0, 0, 1);
+        }
+    }
+    pipeline.deduplicated = deduplicated;
+    
+    const int sampled = pipeline.sampled.load();
+    const int skipped = pipeline.skipped.load();
+    const int held = pipeline.held.load();
+    last_sampled_count = sampled;
+    last_skipped_count = skipped;
+    last_held_count = held;
+    last_culled_count = pipeline.culled;
+    last_deduplicated_count = deduplicated;
+    total_sampled_count += sampled;
+    total_skipped_count += skipped;
+    total_held_count += held;
+    total_deduplicated_count += deduplicated;
+}
+
+bool BatchComputeManager::submit_sensors_async(Ref<ViewportTexture> viewport_texture) {
+    if (!supports_async() || !viewport_texture.is_valid()) {
+        return false;
+    }
+    
+    // Each batch in flight owns a pipeline slot; the slot is free again once its job finished
+    const uint64_t ticket = async_next_ticket;
+    SensorBatchPipeline &pipeline = _get_pipeline(1 + static_cast<int>(ticket % MAX_BATCHES_IN_FLIGHT));
+    // Every ticket since the last poll may still sit in async_results; keep it from filling up
+    const bool ring_full = ticket - 1 - async_popped_ticket >= 3;
+    if (async_in_flight.load() >= max_batches_in_flight || pipeline.busy.load() || ring_full) {
+        async_busy_skips++;
+        return false; // Previous batch still running; the caller retries next tick
+    }
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    // Main thread: the readback itself (get_image() has no asynchronous variant) and a copy
+    // of the regions. Everything else happens on the worker.
+    Ref<Image> image = viewport_texture->get_image();
+    if (image.is_null()) {
+        return false;
+    }
+    
+    // The buffers are recycled from a delivered batch; assign() keeps their capacity
+    AsyncBatchResult job = std::move(async_spare);
+    {
+        std::lock_guard<std::mutex> lock(data_mutex);
+        job.regions.assign(sensor_regions.begin(), sensor_regions.end());
+        job.layout_generation = region_layout_generation;
+        if (region_due.size() == sensor_regions.size()) {
+            job.due.assign(region_due.begin(), region_due.end());
+        } else {
+            job.due.clear();
+        }
+    }
+    job.region_space = region_space_size;
+    job.ticket = ticket;
+    job.frame = Engine::get_singleton()->get_process_frames();
+    job.capture_usec = sensor_steady_usec();
+    job.ok = false;
+    if (job.results.capacity() < job.regions.size()) {
+        result_buffer_allocations++;
+    }
+    job.results.resize(job.regions.size());
+    
+    pipeline.image = image;
+    pipeline.frame = job.frame;
+    pipeline.ticket = ticket;
+    pipeline.image_width = image->get_width();
+    pipeline.image_height = image->get_height();
+    pipeline.dedup = use_region_dedup;
+    pipeline.busy.store(true);
+    async_next_ticket++;
+    async_in_flight.fetch_add(1);
+    
+    SensorWorkerPool::get_singleton()->submit([this, &pipeline, job = std::move(job)]() mutable {
+        pipeline.region_space = job.region_space;
+        pipeline.regions = job.regions.data();
+        pipeline.due = job.due.empty() ? nullptr : job.due.data();
+        pipeline.count = job.regions.size();
+        pipeline.results = job.results.data();
+        job.ok = _ingest_and_sample(pipeline);
+        pipeline.image.unref();
+        _publish_async_result(std::move(job));
+    });
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    async_submit_usec = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count());
+    _record_tick_usec(async_submit_usec);
+    return true;
+}
+
+void BatchComputeManager::_publish_async_result(AsyncBatchResult &&result) {
+    int published = 0;
+    {
+        std::lock_guard<std::mutex> lock(async_publish_mutex);
+        async_finished[result.ticket % MAX_BATCHES_IN_FLIGHT] = std::move(result);
+        // A batch's pipeline stays busy until it is published, so its slot cannot be reused
+        // by the next ticket that maps onto it
+        while (true) {
+            const uint64_t next = async_published_ticket + 1;
+            AsyncBatchResult &slot = async_finished[next % MAX_BATCHES_IN_FLIGHT];
+            if (slot.ticket != next) {
+                break;
+            }
+            async_results.push(std::move(slot)); // Never full: submit leaves room for every unpolled ticket
+            slot.ticket = 0;
+            async_published_ticket = next;
+            _get_pipeline(1 + static_cast<int>(next % MAX_BATCHES_IN_FLIGHT)).busy.store(false);
+            published++;
+        }
+    }
+    // Last: shutdown() waits for this counter before the object may go away
+    async_in_flight.fetch_sub(published);
+}
+
+bool BatchComputeManager::poll_async_results() {
+    bool updated = false;
+    AsyncBatchResult result;
+    while (async_results.pop(result)) {
+        async_popped_ticket = result.ticket;
+        // Batches are published in ticket order; anything older than what was installed is stale
+        if (result.ok && result.ticket > async_completed_ticket) {
+            std::lock_guard<std::mutex> lock(data_mutex);
+            // Regions added or removed while the batch ran: its slots no longer line up, even
+            // when the count came out the same
+            if (result.layout_generation == region_layout_generation) {
+                sensor_results.swap(result.results);
+                async_completed_ticket = result.ticket;
+                async_completed_frame = result.frame;
+                async_completed_usec = result.capture_usec;
+                updated = true;
+            }
+        }
+        // Whichever buffers are left over become the next batch's storage
+        async_spare = std::move(result);
+    }
+    return updated;
+}
+
+bool BatchComputeManager::is_async_busy() const {
+    return async_in_flight.load() > 0;
+}
+
+bool BatchComputeManager::supports_async() const {
+    // The Metal path dispatches and reads back synchronously
+    return is_initialized.load() && !is_using_gpu_backend();
+}
+
+uint64_t BatchComputeManager::get_async_completed_ticket() const {
+    return async_completed_ticket;
+}
+
+uint64_t BatchComputeManager::get_async_completed_frame() const {
+    return async_completed_frame;
+}
+
+uint64_t BatchComputeManager::get_async_completed_usec() const {
+    return async_completed_usec;
+}
+
+uint64_t BatchComputeManager::get_async_submitted_ticket() const {
+    return async_next_ticket - 1;
+}
+
+void BatchComputeManager::set_max_batches_in_flight(int count) {
+    max_batches_in_flight = std::clamp(count, 1, MAX_BATCHES_IN_FLIGHT);
+}
+
+int BatchComputeManager::get_max_batches_in_flight() const {
+    return max_batches_in_flight;
+}
+
+Dictionary BatchComputeManager::get_async_stats() const {
+    Dictionary stats;
+    stats["in_flight"] = async_in_flight.load();
+    stats["max_in_flight"] = max_batches_in_flight;
+    stats["submitted_ticket"] = async_next_ticket - 1;
+    stats["completed_ticket"] = async_completed_ticket;
+    stats["completed_frame"] = async_completed_frame;
+    stats["busy_skips"] = async_busy_skips;
+    stats["last_submit_usec"] = async_submit_usec;
+    stats["worker_threads"] = SensorWorkerPool::get_singleton()->get_thread_count();
+    return stats;
+}
+
+Dictionary BatchComputeManager::get_pipeline_graph() const {
+    std::lock_guard<std::mutex> lock(graph_trace_mutex);
+    Array stages;
+    for (const SensorTaskGraph::StageTrace &trace : graph_trace) {
+        PackedStringArray depends_on;
+        for (size_t d = 0; d < graph_trace.size(); ++d) {
+            if (trace.dependency_mask & (1u << d)) {
+                depends_on.push_back(graph_trace[d].name);
+            }
+        }
+        Dictionary stage;
+        stage["name"] = trace.name;
+        stage["depends_on"] = depends_on;
+        stage["start_usec"] = trace.start_usec;
+        stage["end_usec"] = trace.end_usec;
+        // "caller": the thread that ran the batch (main thread, or a worker for background
+        // batches); "worker": a pool helper running concurrently with it
+        stage["lane"] = trace.lane == SensorTaskGraph::LANE_WORKER ? "worker" : "caller";
+        stage["pinned_to_caller"] = trace.on_caller;
+        stages.append(stage);
+    }
+    
+    Dictionary graph;
+    graph["stages"] = stages;
+    graph["ticket"] = graph_trace_ticket;
+    graph["frame"] = graph_trace_frame;
+    graph["total_usec"] = graph_trace_usec;
+    return graph;
+}
+
+Dictionary BatchComputeManager::get_allocation_stats() const {
+    Dictionary stats;
+    stats["arena_bytes_high_water"] = static_cast<int64_t>(tick_arena.get_high_water());
+    stats["arena_capacity"] = static_cast<int64_t>(tick_arena.get_capacity());
+    stats["arena_block_allocations"] = tick_arena.get_block_allocations();
+    stats["result_buffer_allocations"] = result_buffer_allocations;
+    stats["staging_texture_allocations"] = staging_texture_allocations;
+    stats["staging_texture_reuses"] = staging_texture_reuses;
+    stats["viewport_resizes"] = viewport_resize_count;
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex);
+        stats["snapshot_reallocations"] = cpu_snapshot.buffer_reallocations;
+    }
+    
+    // Percentiles over the last TICK_HISTORY main-thread ticks (process or submit)
+    const int samples = static_cast<int>(std::min<uint64_t>(tick_count, TICK_HISTORY));
+    uint32_t sorted[TICK_HISTORY];
+    std::copy(tick_usec_history, tick_usec_history + samples, sorted);
+    std::sort(sorted, sorted + samples);
+    stats["tick_samples"] = samples;
+    stats["tick_usec_p50"] = samples > 0 ? sorted[samples / 2] : 0;
+    stats["tick_usec_p99"] = samples > 0 ? sorted[std::min(samples - 1, samples * 99 / 100)] : 0;
+    stats["tick_usec_max"] = samples > 0 ? sorted[samples - 1] : 0;
+    return stats;
+}
+
+void BatchComputeManager::_record_tick_usec(uint64_t usec) {
+    tick_usec_history[tick_count % TICK_HISTORY] = static_cast<uint32_t>(std::min<uint64_t>(usec, UINT32_MAX));
+    tick_count++;
+}
+
 int BatchComputeManager::_find_sensor_index(int sensor_id) const {
     for (size_t i = 0; i < sensor_regions.size(); ++i) {
         if (sensor_regions[i].sensor_id == sensor_id) {
@@ -306,4 +1030,15 @@ void BatchComputeManager::_resize_buffers_if_needed() {
 
 // _read_results() implementation is in platform/macos/batch_compute_manager_macos.mm
 
+// warm_up_pipelines() and save_pipeline_cache() implementations are in platform/macos/batch_compute_manager_macos.mm
+
+#else
+
+// No batch GPU backend on this platform: nothing to build ahead of time
+void BatchComputeManager::warm_up_pipelines() {
+}
+
+void BatchComputeManager::save_pipeline_cache() {
+}
+
 #endif // __APPLE__
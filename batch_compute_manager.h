@@ -5,14 +5,22 @@
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/godot.hpp>
 #include <godot_cpp/variant/color.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/vector2.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
 #include <godot_cpp/variant/vector3.hpp>
 #include <godot_cpp/classes/viewport_texture.hpp>
 
+#include "sensor_snapshot.h"
+#include "sensor_task_graph.h"
+#include "sensor_tick_arena.h"
+#include "sensor_worker_pool.h"
+
 #include <vector>
 #include <memory>
 #include <mutex>
 #include <atomic>
+#include <condition_variable>
 
 #ifdef __APPLE__
 // Forward declarations for Metal objects
@@ -38,6 +46,114 @@ struct SensorRegion {
     SensorRegion(float x, float y, int r, int id) : center_x(x), center_y(y), radius(r), sensor_id(id) {}
 };
 
+// Per-region record of the last real sample, used by the frame-coherence skip
+// Carries its own color, so entries stay correct when region slots shift or are reassigned.
+// Held regions reuse the color without a position check, so they also match on sensor_id.
+struct SensorRegionCache {
+    int sensor_id = -1;
+    int center_x = 0;
+    int center_y = 0;
+    int radius = -1;
+    uint64_t generation = 0; // Snapshot generation the cached result was sampled from
+    Color color;
+    bool valid = false;
+};
+
+// Per-tick table of the distinct regions already resolved, keyed by quantized (x, y, radius).
+// Open addressing over retained vectors, so a steady-state tick does not allocate.
+struct SensorRegionDedup {
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> slots; // Index of the region that first resolved the key
+    uint64_t mask = 0;
+
+    static uint64_t make_key(int p_x, int p_y, int p_radius) {
+        // +1 keeps key 0 free as the empty marker
+        return ((static_cast<uint64_t>(static_cast<uint32_t>(p_x)) & 0xFFFFFF) << 40) |
+                ((static_cast<uint64_t>(static_cast<uint32_t>(p_y)) & 0xFFFFFF) << 16) |
+                ((static_cast<uint64_t>(static_cast<uint32_t>(p_radius)) & 0xFFFF) + 1);
+    }
+
+    void begin(size_t p_count) {
+        size_t capacity = 16;
+        while (capacity < p_count * 2) {
+            capacity <<= 1;
+        }
+        keys.assign(capacity, 0);
+        slots.resize(capacity);
+        mask = capacity - 1;
+    }
+
+    // Returns the index that already owns p_key, or records p_index as its owner and returns -1
+    int64_t find_or_insert(uint64_t p_key, uint32_t p_index) {
+        uint64_t h = p_key * 0x9E3779B97F4A7C15ull;
+        for (uint64_t probe = (h >> 32) & mask;; probe = (probe + 1) & mask) {
+            if (keys[probe] == p_key) {
+                return slots[probe];
+            }
+            if (keys[probe] == 0) {
+                keys[probe] = p_key;
+                slots[probe] = p_index;
+                return -1;
+            }
+        }
+    }
+};
+
+// Result of one background batch, handed from the worker to the main thread. The batch's
+// input copies travel with it, so batches in flight at the same time never share buffers.
+struct AsyncBatchResult {
+    uint64_t ticket = 0;
+    uint64_t frame = 0;
+    uint64_t capture_usec = 0; // steady_clock time of the readback
+    uint64_t layout_generation = 0; // region_layout_generation the regions were copied at
+    std::vector<Color> results;
+    std::vector<SensorRegion> regions;
+    std::vector<uint8_t> due;
+    Vector2 region_space;
+    bool ok = false;
+};
+
+// State of one batch moving through the CPU pipeline. The stage graph is built once per
+// pipeline and re-run for every batch assigned to it; the vectors keep their capacity.
+//   wait_snapshot -> ingest -> summed_area_tables -+-> sample -> resolve -> release
+//   bin ------------------------------------------/
+// bin (scale, cull, quantize, share duplicates) needs nothing from the snapshot, so it runs
+// while the batch waits for the snapshot and while the frame is converted and hashed.
+struct SensorBatchPipeline {
+    // region_route values other than a dedup owner index
+    static constexpr int32_t ROUTE_SAMPLE = -1;
+    static constexpr int32_t ROUTE_HOLD = -2; // Not due: reuse the cached sample when there is one
+    static constexpr int32_t ROUTE_CULLED = -3; // Entirely outside the image
+
+    SensorTaskGraph graph;
+    std::atomic<bool> busy{false};
+
+    // Inputs, set before the graph runs
+    Ref<Image> image;
+    uint64_t frame = 0;
+    uint64_t ticket = 0; // Background batches take the snapshot in ticket order; 0: no ordering
+    int image_width = 0;
+    int image_height = 0;
+    Vector2 region_space;
+    const SensorRegion *regions = nullptr;
+    const uint8_t *due = nullptr;
+    size_t count = 0;
+    Color *results = nullptr;
+    bool dedup = true;
+
+    // Stage outputs
+    bool ok = false;
+    std::vector<Vector2> centers; // In snapshot pixels
+    std::vector<int32_t> region_route;
+    std::vector<uint32_t> unique_regions; // Regions resolved against the snapshot
+    SensorRegionDedup region_dedup;
+    std::atomic<int> sampled{0};
+    std::atomic<int> skipped{0};
+    std::atomic<int> held{0};
+    int deduplicated = 0;
+    int culled = 0;
+};
+
 class BatchComputeManager : public Node {
     GDCLASS(BatchComputeManager, Node);
 
@@ -57,12 +173,105 @@ private:
     
     // Texture
     MTLTextureRef viewport_texture = nullptr;
+    bool viewport_texture_pooled = false; // Our staging upload target, reusable at the same size
 #endif
 
     // Sensor data
     std::vector<SensorRegion> sensor_regions;
     std::vector<Color> sensor_results;
+    // Optional per-region due flags (adaptive poll rates). Regions flagged 0 keep their cached
+    // result on the CPU snapshot path instead of being sampled. Empty: every region is due.
+    std::vector<uint8_t> region_due;
+    // Bumped whenever regions are inserted, removed or replaced, i.e. whenever result slot i
+    // may name a different sensor. Batches sampled under an older layout are not installed.
+    uint64_t region_layout_generation = 0;
     mutable std::mutex data_mutex;
+
+    // One snapshot per tick, every region sampled against it (CPU backend and Metal
+    // fallback). Retained after the tick so callers can re-read it between ticks.
+    // Guarded by snapshot_mutex, which worker jobs hold while ingesting and sampling.
+    SensorSnapshot cpu_snapshot;
+    mutable std::mutex snapshot_mutex;
+
+    // Frame-coherence skip: regions whose position and snapshot tiles are unchanged since
+    // their last sample reuse the cached color. Per slot, guarded by snapshot_mutex.
+    std::vector<SensorRegionCache> region_cache;
+    bool use_coherence_skip = true;
+    
+    // Regions quantizing to the same (x, y, radius) within a tick are sampled once and the
+    // result is shared. Guarded by snapshot_mutex.
+    bool use_region_dedup = true;
+    uint64_t total_deduplicated_count = 0;
+    int last_deduplicated_count = 0;
+    
+    // Keep per-tile summed-area tables on the snapshot so each region costs a few lookups per
+    // tile instead of a pass over its pixels. Only tiles that changed are rebuilt. Opt-in:
+    // the tables take 12 bytes per pixel. Guarded by snapshot_mutex.
+    bool use_summed_area_table = false;
+    
+    // Average in linear light (sRGB decoded through a table) and optionally keep the result
+    // linear instead of re-encoding it. Guarded by snapshot_mutex like region_cache.
+    bool use_linear_averaging = true;
+    bool linear_color_output = false;
+    
+    // Size of the space region centers are given in (the viewport's visible rect). When the
+    // captured image has a different pixel size, centers are mapped onto it. Zero: same size.
+    Vector2 region_space_size;
+    uint64_t viewport_resize_count = 0;
+    uint64_t total_sampled_count = 0;
+    uint64_t total_skipped_count = 0;
+    uint64_t total_held_count = 0;
+    int last_sampled_count = 0;
+    int last_skipped_count = 0;
+    int last_held_count = 0;
+    int last_culled_count = 0;
+    
+    // Stage graphs: slot 0 runs synchronous batches, the others background batches by ticket,
+    // so batches in flight together never share state
+    static constexpr int MAX_BATCHES_IN_FLIGHT = 2;
+    std::unique_ptr<SensorBatchPipeline> batch_pipelines[MAX_BATCHES_IN_FLIGHT + 1];
+    // Ticket of the last background batch that released the snapshot; guarded by snapshot_mutex
+    uint64_t snapshot_turn_ticket = 0;
+    std::condition_variable snapshot_turn_cv;
+    // Per-stage trace of the last finished batch (get_pipeline_graph)
+    mutable std::mutex graph_trace_mutex;
+    std::vector<SensorTaskGraph::StageTrace> graph_trace;
+    uint64_t graph_trace_ticket = 0;
+    uint64_t graph_trace_frame = 0;
+    uint32_t graph_trace_usec = 0;
+    
+    // Background pipeline: the main thread only reads the image back and enqueues; format
+    // conversion, tile hashing and sampling run on SensorWorkerPool. With more than one batch
+    // in flight, the readback of the next tick overlaps the sampling of the previous one.
+    std::atomic<int> async_in_flight{0};
+    int max_batches_in_flight = 1;
+    uint64_t async_next_ticket = 1;
+    uint64_t async_completed_ticket = 0;
+    uint64_t async_completed_frame = 0;
+    uint64_t async_completed_usec = 0;
+    uint64_t async_busy_skips = 0;
+    uint64_t async_submit_usec = 0; // Main-thread cost of the last submit
+    // Workers finish out of order; each parks its result in its slot and whichever worker
+    // holds the next ticket publishes every consecutive one, so the ring has one producer at
+    // a time and sees tickets in order
+    std::mutex async_publish_mutex;
+    AsyncBatchResult async_finished[MAX_BATCHES_IN_FLIGHT]; // guarded by async_publish_mutex
+    uint64_t async_published_ticket = 0; // guarded by async_publish_mutex
+    uint64_t async_popped_ticket = 0; // Main thread only
+    SpscRing<AsyncBatchResult, 4> async_results;
+    // Buffers of a delivered batch, recycled by the next submit (main thread only)
+    AsyncBatchResult async_spare;
+    
+    // Main-thread per-tick scratch, rewound at the end of every process_sensors() call
+    SensorTickArena tick_arena;
+    
+    // Allocation and timing counters (get_allocation_stats)
+    uint64_t staging_texture_allocations = 0;
+    uint64_t staging_texture_reuses = 0;
+    uint64_t result_buffer_allocations = 0;
+    static constexpr int TICK_HISTORY = 256;
+    uint32_t tick_usec_history[TICK_HISTORY] = {};
+    uint64_t tick_count = 0;
     
     // Configuration
     int max_sensors = 10000;
@@ -78,6 +287,8 @@ private:
     // State
     std::atomic<bool> is_initialized{false};
     std::atomic<bool> is_processing{false};
+    bool use_gpu_backend = false; // True when the Metal pipeline initialized successfully
+    bool prefer_gpu_backend = true; // Cleared to force the CPU snapshot backend
 
 protected:
     static void _bind_methods();
@@ -101,11 +312,53 @@ public:
     void clear_all_sensors();
     void set_sample_radius(int radius);
     
+    // Bulk replacement of all regions (C++ only). Result i corresponds to region i.
+    void set_sensor_regions(const std::vector<SensorRegion> &regions);
+    // Appends regions whose sensor ids are new (C++ only): no per-sensor existence lookup
+    void append_sensor_regions(const SensorRegion *regions, size_t count);
+    void copy_results(std::vector<Color> &out_results) const;
+    // Due flags for the next batch (C++ only), one per region; an empty vector samples all
+    void set_region_due_mask(const std::vector<uint8_t> &due);
+    // Current region layout (C++ only); changes whenever result slots shift
+    uint64_t get_region_layout_generation() const;
+    
     // Processing
     bool process_sensors(Ref<ViewportTexture> viewport_texture);
+    
+    // Background processing (CPU snapshot backend). submit_sensors_async() reads the frame
+    // back and queues the rest; poll_async_results() installs the newest finished batch and
+    // returns true when results changed. Returns false from submit while a batch is running.
+    bool submit_sensors_async(Ref<ViewportTexture> viewport_texture);
+    bool poll_async_results();
+    bool is_async_busy() const;
+    bool supports_async() const;
+    uint64_t get_async_completed_ticket() const;
+    uint64_t get_async_completed_frame() const;
+    uint64_t get_async_completed_usec() const;
+    // Ticket of the last batch submit_sensors_async() queued
+    uint64_t get_async_submitted_ticket() const;
+    // Background batches allowed in flight at once (1 or 2). With 2, a tick can be read back
+    // while the previous one is still sampled; results still arrive in ticket order.
+    void set_max_batches_in_flight(int count);
+    int get_max_batches_in_flight() const;
     Color get_sensor_result(int sensor_id) const;
     Array get_all_results() const;
     
+    // Coordinate space of region centers; see region_space_size
+    void set_region_space_size(const Vector2 &size);
+    Vector2 get_region_space_size() const;
+    // Viewport resize hook: adopts the new region space and grows the snapshot buffers now,
+    // outside the tick. texture_size is the new render target size in pixels.
+    void notify_viewport_resized(const Vector2 &region_space, const Vector2i &texture_size);
+    
+    // Last captured snapshot (C++ only). Used for reprojection between real samples.
+    bool has_snapshot() const;
+    uint64_t get_snapshot_frame() const;
+    Color sample_snapshot(float center_x, float center_y, int radius) const;
+    // Samples many centers at once, each with its own radius; returns false without blocking
+    // if a worker holds the snapshot
+    bool try_sample_snapshot_batch(const Vector2 *centers, const int *radii, size_t count, Color *out_colors) const;
+    
     // Configuration
     void set_max_sensors(int max_count);
     void set_use_optimized_kernel(bool use_optimized);
@@ -115,11 +368,36 @@ public:
     
     void set_force_gpu_mode(bool force_gpu);
     bool get_force_gpu_mode() const;
+    void set_prefer_gpu_backend(bool prefer_gpu);
+    bool get_prefer_gpu_backend() const;
+    bool is_using_gpu_backend() const;
+    void set_use_coherence_skip(bool enabled);
+    bool get_use_coherence_skip() const;
+    void set_use_region_dedup(bool enabled);
+    bool get_use_region_dedup() const;
+    void set_use_summed_area_table(bool enabled);
+    bool get_use_summed_area_table() const;
+    void set_use_linear_averaging(bool enabled);
+    bool get_use_linear_averaging() const;
+    void set_linear_color_output(bool enabled);
+    bool get_linear_color_output() const;
     
     // Statistics
     int get_sensor_count() const;
     int get_max_sensors() const;
     bool is_processing_active() const;
+    Dictionary get_coherence_stats() const;
+    Dictionary get_async_stats() const;
+    // Stages of the CPU pipeline and their timings in the last finished batch
+    Dictionary get_pipeline_graph() const;
+    // Heap allocations on the tick path and main-thread tick time percentiles
+    Dictionary get_allocation_stats() const;
+    void reset_coherence_stats();
+    
+    // Builds the GPU pipelines ahead of first use; called on the warm-up thread at extension init (C++ only)
+    static void warm_up_pipelines();
+    // Writes pipelines compiled since the last save to the on-disk pipeline cache (C++ only)
+    static void save_pipeline_cache();
 
 private:
 #ifdef __APPLE__
@@ -142,6 +420,25 @@ private:
     void _release_buffer(MTLBufferRef buffer);
 #endif
     
+    // CPU snapshot backend (all platforms)
+    bool _process_sensors_cpu(Ref<ViewportTexture> viewport_texture);
+    // Runs the pipeline's stage graph over its inputs; safe on worker threads. Holds
+    // snapshot_mutex from wait_snapshot to release.
+    bool _ingest_and_sample(SensorBatchPipeline &pipeline);
+    SensorBatchPipeline &_get_pipeline(int slot);
+    // Worker side of a background batch: frees its pipeline once its result reached the ring
+    void _publish_async_result(AsyncBatchResult &&result);
+    void _stage_wait_snapshot(SensorBatchPipeline &pipeline);
+    void _stage_bin(SensorBatchPipeline &pipeline);
+    void _stage_ingest(SensorBatchPipeline &pipeline);
+    void _stage_summed_area_tables(SensorBatchPipeline &pipeline);
+    void _stage_sample(SensorBatchPipeline &pipeline);
+    void _stage_resolve(SensorBatchPipeline &pipeline);
+    void _stage_release(SensorBatchPipeline &pipeline);
+    void _record_tick_usec(uint64_t usec);
+    // Region space -> snapshot pixels; caller holds snapshot_mutex
+    Vector2 _snapshot_scale(const Vector2 &region_space) const;
+    
     // Utility methods
     int _find_sensor_index(int sensor_id) const;
     void _resize_buffers_if_needed();
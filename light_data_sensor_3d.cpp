@@ -1,11 +1,18 @@
 #include "light_data_sensor_3d.h"
+#include "light_sensor_batcher.h"
+#include "sensor_clock.h"
+#include "sensor_color_space.h"
+#include "sensor_projection.h"
 #include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/core/object.hpp>
 #include <godot_cpp/classes/engine.hpp>
 #include <godot_cpp/classes/viewport.hpp>
+#include <godot_cpp/classes/camera3d.hpp>
 #include <godot_cpp/classes/viewport_texture.hpp>
 #include <godot_cpp/classes/texture2d.hpp>
 #include <godot_cpp/classes/image.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
 #ifdef __APPLE__
@@ -16,11 +23,107 @@ namespace MetalResourceManager {
 #endif
 
 // For demonstration, minimal error checking
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <thread>
+#include <unordered_map>
 
 using namespace godot;
 
+namespace {
+
+// Tiers of the GPU-mode capture chain, memoized per viewport once probed
+enum CaptureStrategy {
+    CAPTURE_STRATEGY_UNPROBED = 0,
+    CAPTURE_STRATEGY_DIRECT, // Platform direct texture access succeeded
+    CAPTURE_STRATEGY_FRAME_CACHE, // One shared get_image() per viewport per frame
+};
+
+struct ViewportCaptureState {
+    int direct_tier = CAPTURE_STRATEGY_UNPROBED; // DIRECT, FRAME_CACHE (direct failed) or unprobed
+    uint64_t device_epoch = 0;
+    uint64_t image_frame = 0;
+    Ref<Image> image; // Last readback, shared by every sensor of the viewport during that frame
+};
+
+// Keyed by viewport ObjectID. Bumping the epoch makes every viewport re-probe.
+std::unordered_map<uint64_t, ViewportCaptureState> g_viewport_capture;
+uint64_t g_capture_device_epoch = 1;
+
+// Calls p_fn(r, g, b) in linear light for every pixel within p_radius of (p_cx, p_cy), clipped
+// to the image. Float (HDR) pixels are already linear. 8-bit pixels are decoded through the
+// exact sRGB table: RGBA8/RGB8 straight from the bytes, other layouts from get_pixel()'s byte / 255.
+template <typename F>
+void _for_each_linear_pixel(const Ref<Image> &p_image, int p_cx, int p_cy, int p_radius, F &&p_fn) {
+    const int width = p_image->get_width();
+    const int height = p_image->get_height();
+    const int x0 = std::max(p_cx - p_radius, 0);
+    const int x1 = std::min(p_cx + p_radius, width - 1);
+    const int y0 = std::max(p_cy - p_radius, 0);
+    const int y1 = std::min(p_cy + p_radius, height - 1);
+    if (x0 > x1 || y0 > y1) {
+        return;
+    }
+
+    const Image::Format format = p_image->get_format();
+    if (sensor_is_float_format(format)) {
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                const Color c = p_image->get_pixel(x, y);
+                p_fn(c.r, c.g, c.b);
+            }
+        }
+        return;
+    }
+
+    const float *lut = sensor_srgb8_to_linear_table();
+    const size_t bpp = format == Image::FORMAT_RGBA8 ? 4 : (format == Image::FORMAT_RGB8 ? 3 : 0);
+    if (bpp > 0) {
+        const PackedByteArray data = p_image->get_data();
+        if (static_cast<size_t>(data.size()) >= static_cast<size_t>(width) * static_cast<size_t>(height) * bpp) {
+            for (int y = y0; y <= y1; ++y) {
+                const uint8_t *px = data.ptr() + (static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x0)) * bpp;
+                for (int x = x0; x <= x1; ++x, px += bpp) {
+                    p_fn(lut[px[0]], lut[px[1]], lut[px[2]]);
+                }
+            }
+            return;
+        }
+    }
+
+    auto unorm8 = [](float v) { return static_cast<uint8_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f)); };
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            const Color c = p_image->get_pixel(x, y);
+            p_fn(lut[unorm8(c.r)], lut[unorm8(c.g)], lut[unorm8(c.b)]);
+        }
+    }
+}
+
+ViewportCaptureState &_get_capture_state(uint64_t p_viewport_id) {
+    auto it = g_viewport_capture.find(p_viewport_id);
+    if (it == g_viewport_capture.end()) {
+        // Drop entries of freed viewports while we are here
+        for (auto stale = g_viewport_capture.begin(); stale != g_viewport_capture.end();) {
+            if (!ObjectDB::get_instance(stale->first)) {
+                stale = g_viewport_capture.erase(stale);
+            } else {
+                ++stale;
+            }
+        }
+        it = g_viewport_capture.emplace(p_viewport_id, ViewportCaptureState()).first;
+    }
+    ViewportCaptureState &state = it->second;
+    if (state.device_epoch != g_capture_device_epoch) {
+        state.direct_tier = CAPTURE_STRATEGY_UNPROBED;
+        state.device_epoch = g_capture_device_epoch;
+    }
+    return state;
+}
+
+} // namespace
+
 void LightDataSensor3D::_bind_methods() {
     // Properties matching nanodeath LightSensor3D API
     ClassDB::bind_method(D_METHOD("get_color"), &LightDataSensor3D::get_color);
@@ -33,7 +136,24 @@ void LightDataSensor3D::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_metadata_label"), &LightDataSensor3D::get_metadata_label);
 
     // Main API method
-    ClassDB::bind_method(D_METHOD("refresh"), &LightDataSensor3D::refresh);
+    ClassDB::bind_method(D_METHOD("refresh", "force"), &LightDataSensor3D::refresh, DEFVAL(false));
+    ClassDB::bind_method(D_METHOD("set_max_reading_age_frames", "frames"), &LightDataSensor3D::set_max_reading_age_frames);
+    ClassDB::bind_method(D_METHOD("get_max_reading_age_frames"), &LightDataSensor3D::get_max_reading_age_frames);
+    ClassDB::bind_method(D_METHOD("set_max_reading_age_msec", "msec"), &LightDataSensor3D::set_max_reading_age_msec);
+    ClassDB::bind_method(D_METHOD("get_max_reading_age_msec"), &LightDataSensor3D::get_max_reading_age_msec);
+    ClassDB::bind_method(D_METHOD("get_reading_frame"), &LightDataSensor3D::get_reading_frame);
+    ClassDB::bind_method(D_METHOD("get_reading_age_frames"), &LightDataSensor3D::get_reading_age_frames);
+    ClassDB::bind_method(D_METHOD("get_reading_age_msec"), &LightDataSensor3D::get_reading_age_msec);
+    ClassDB::bind_method(D_METHOD("has_valid_reading"), &LightDataSensor3D::has_valid_reading);
+    ClassDB::bind_method(D_METHOD("was_last_refresh_reused"), &LightDataSensor3D::was_last_refresh_reused);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "max_reading_age_frames"), "set_max_reading_age_frames", "get_max_reading_age_frames");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "max_reading_age_msec"), "set_max_reading_age_msec", "get_max_reading_age_msec");
+    ClassDB::bind_method(D_METHOD("set_use_batched_refresh", "enabled"), &LightDataSensor3D::set_use_batched_refresh);
+    ClassDB::bind_method(D_METHOD("get_use_batched_refresh"), &LightDataSensor3D::get_use_batched_refresh);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_batched_refresh"), "set_use_batched_refresh", "get_use_batched_refresh");
+    ClassDB::bind_method(D_METHOD("set_linear_color_output", "enabled"), &LightDataSensor3D::set_linear_color_output);
+    ClassDB::bind_method(D_METHOD("get_linear_color_output"), &LightDataSensor3D::get_linear_color_output);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "linear_color_output"), "set_linear_color_output", "get_linear_color_output");
     
     // Utility methods
     ClassDB::bind_method(D_METHOD("is_using_gpu"), &LightDataSensor3D::is_using_gpu);
@@ -41,6 +161,12 @@ void LightDataSensor3D::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_support_status"), &LightDataSensor3D::get_support_status);
     ClassDB::bind_method(D_METHOD("set_screen_sample_pos", "screen_pos"), &LightDataSensor3D::set_screen_sample_pos);
     ClassDB::bind_method(D_METHOD("get_screen_sample_pos"), &LightDataSensor3D::get_screen_sample_pos);
+    ClassDB::bind_method(D_METHOD("clear_screen_sample_pos"), &LightDataSensor3D::clear_screen_sample_pos);
+    ClassDB::bind_method(D_METHOD("has_screen_sample_pos"), &LightDataSensor3D::has_screen_sample_pos);
+    ClassDB::bind_method(D_METHOD("set_track_global_position", "enabled"), &LightDataSensor3D::set_track_global_position);
+    ClassDB::bind_method(D_METHOD("get_track_global_position"), &LightDataSensor3D::get_track_global_position);
+    ClassDB::bind_method(D_METHOD("is_on_screen"), &LightDataSensor3D::is_on_screen);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "track_global_position"), "set_track_global_position", "get_track_global_position");
     
     // M6.5: Performance monitoring methods
     ClassDB::bind_method(D_METHOD("get_average_sample_time"), &LightDataSensor3D::get_average_sample_time);
@@ -48,6 +174,7 @@ void LightDataSensor3D::_bind_methods() {
     ClassDB::bind_method(D_METHOD("set_use_direct_texture_access", "enabled"), &LightDataSensor3D::set_use_direct_texture_access);
     ClassDB::bind_method(D_METHOD("get_use_direct_texture_access"), &LightDataSensor3D::get_use_direct_texture_access);
     ClassDB::bind_method(D_METHOD("get_optimization_strategy"), &LightDataSensor3D::get_optimization_strategy);
+    ClassDB::bind_method(D_METHOD("get_readback_count"), &LightDataSensor3D::get_readback_count);
 
     // Virtual method bindings - these are automatically handled by the base class
     // No need to bind virtual methods like _ready, _process, _exit_tree
@@ -134,7 +261,7 @@ float LightDataSensor3D::get_light_level() const {
     return current_light_level;
 }
 
-void LightDataSensor3D::refresh() {
+void LightDataSensor3D::refresh(bool force) {
     // Force immediate sampling regardless of is_running state
     // This allows getting fresh data even when the sampling process is stopped
     
@@ -142,15 +269,151 @@ void LightDataSensor3D::refresh() {
     // Godot API calls (get_viewport(), get_texture(), etc.) are not thread-safe
     // and must only be called from the main thread.
     
+    // Max-age policy: a recent enough reading is kept as is. Nothing is emitted, so every
+    // color_updated corresponds to a new measurement.
+    last_refresh_reused = !force && _is_reading_reusable();
+    if (last_refresh_reused) {
+        return;
+    }
+    
+    // Batched path: the viewport's LightSensorBatcher samples every queued node against a
+    // single snapshot at the end of the frame and emits the signals from apply_batched_reading()
+    if (use_batched_refresh && is_inside_tree()) {
+        LightSensorBatcher *batcher = LightSensorBatcher::get_for_viewport(get_viewport());
+        if (batcher) {
+            batcher->enqueue(this);
+            return;
+        }
+    }
+    
+    // Unbatched path projects just this node
+    if (wants_position_tracking()) {
+        _update_tracked_screen_pos();
+        if (tracked_pos_valid && !tracked_pos_on_screen) {
+            return; // Nothing to measure while the node is off-screen
+        }
+    }
+    
     // For refresh(), always use CPU sampling for immediate results
     // GPU paths are designed for background processing and don't emit signals immediately
-    _sample_viewport_color();
+    if (!_sample_viewport_color()) {
+        return; // No new measurement (no viewport, failed readback, off-screen)
+    }
     
     // Emit signals for the new readings
     emit_signal("color_updated", current_color);
     emit_signal("light_level_updated", current_light_level);
 }
 
+void LightDataSensor3D::set_max_reading_age_frames(int frames) {
+    max_reading_age_frames = std::max(0, frames);
+}
+
+int LightDataSensor3D::get_max_reading_age_frames() const {
+    return max_reading_age_frames;
+}
+
+void LightDataSensor3D::set_max_reading_age_msec(double msec) {
+    max_reading_age_msec = std::max(0.0, msec);
+}
+
+double LightDataSensor3D::get_max_reading_age_msec() const {
+    return max_reading_age_msec;
+}
+
+uint64_t LightDataSensor3D::get_reading_frame() const {
+    return reading_frame;
+}
+
+int64_t LightDataSensor3D::get_reading_age_frames() const {
+    if (!has_reading) {
+        return -1;
+    }
+    return static_cast<int64_t>(Engine::get_singleton()->get_process_frames() - reading_frame);
+}
+
+double LightDataSensor3D::get_reading_age_msec() const {
+    if (!has_reading) {
+        return -1.0;
+    }
+    return static_cast<double>(sensor_steady_usec() - reading_usec) / 1000.0;
+}
+
+bool LightDataSensor3D::has_valid_reading() const {
+    return has_reading;
+}
+
+bool LightDataSensor3D::was_last_refresh_reused() const {
+    return last_refresh_reused;
+}
+
+void LightDataSensor3D::_mark_reading(uint64_t p_frame, uint64_t p_usec) {
+    reading_frame = p_frame;
+    reading_usec = p_usec;
+    has_reading = true;
+}
+
+bool LightDataSensor3D::_is_reading_reusable() const {
+    if (!has_reading) {
+        return false;
+    }
+    if (get_reading_age_frames() <= max_reading_age_frames) {
+        return true;
+    }
+    return max_reading_age_msec > 0.0 && get_reading_age_msec() <= max_reading_age_msec;
+}
+
+void LightDataSensor3D::set_use_batched_refresh(bool enabled) {
+    use_batched_refresh = enabled;
+}
+
+bool LightDataSensor3D::get_use_batched_refresh() const {
+    return use_batched_refresh;
+}
+
+void LightDataSensor3D::set_linear_color_output(bool enabled) {
+    linear_color_output = enabled;
+}
+
+bool LightDataSensor3D::get_linear_color_output() const {
+    return linear_color_output;
+}
+
+Color LightDataSensor3D::_finish_linear_average(const Color &p_linear) const {
+    return sensor_finish_linear_average(p_linear.r, p_linear.g, p_linear.b,
+            linear_color_output ? SENSOR_COLOR_LINEAR : SENSOR_COLOR_LINEAR_SRGB);
+}
+
+bool LightDataSensor3D::get_batch_sample_center(const Vector2 &p_viewport_size, Vector2 &r_center) const {
+    int cx = 0;
+    int cy = 0;
+    if (!_resolve_sample_center(static_cast<int>(p_viewport_size.x), static_cast<int>(p_viewport_size.y), cx, cy)) {
+        return false;
+    }
+    r_center = Vector2(cx, cy);
+    return true;
+}
+
+bool LightDataSensor3D::wants_position_tracking() const {
+    return track_global_position && !has_explicit_sample_pos;
+}
+
+void LightDataSensor3D::set_tracked_screen_pos(const Vector2 &p_screen_pos, bool p_valid, bool p_on_screen) {
+    tracked_screen_pos = p_screen_pos;
+    tracked_pos_valid = p_valid;
+    tracked_pos_on_screen = p_valid && p_on_screen;
+}
+
+void LightDataSensor3D::apply_batched_reading(const Color &p_color, uint64_t p_source_frame, uint64_t p_source_usec) {
+    // The batcher delivers linear averages; each node applies its own output encoding
+    current_color = _finish_linear_average(p_color);
+    current_light_level = _calculate_luminance(current_color);
+    _mark_reading(p_source_frame, p_source_usec);
+    
+    emit_signal("color_updated", current_color);
+    emit_signal("light_level_updated", current_light_level);
+}
+
 bool LightDataSensor3D::is_using_gpu() const {
 #ifdef __APPLE__
     return use_metal;
@@ -166,10 +429,44 @@ bool LightDataSensor3D::is_using_gpu() const {
 void LightDataSensor3D::set_screen_sample_pos(const Vector2 &p_screen_pos) {
     std::lock_guard<std::mutex> lock(frame_mutex);
     screen_sample_pos = p_screen_pos;
+    has_explicit_sample_pos = true;
 }
 
 Vector2 LightDataSensor3D::get_screen_sample_pos() const {
-    return screen_sample_pos;
+    if (has_explicit_sample_pos) {
+        return screen_sample_pos;
+    }
+    // Report where tracking last placed the sample, if anywhere
+    return tracked_pos_on_screen ? tracked_screen_pos : Vector2();
+}
+
+void LightDataSensor3D::clear_screen_sample_pos() {
+    std::lock_guard<std::mutex> lock(frame_mutex);
+    screen_sample_pos = Vector2();
+    has_explicit_sample_pos = false;
+}
+
+bool LightDataSensor3D::has_screen_sample_pos() const {
+    return has_explicit_sample_pos;
+}
+
+void LightDataSensor3D::set_track_global_position(bool enabled) {
+    track_global_position = enabled;
+    if (!enabled) {
+        tracked_pos_valid = false;
+        tracked_pos_on_screen = false;
+    }
+}
+
+bool LightDataSensor3D::get_track_global_position() const {
+    return track_global_position;
+}
+
+bool LightDataSensor3D::is_on_screen() const {
+    if (wants_position_tracking() && tracked_pos_valid) {
+        return tracked_pos_on_screen;
+    }
+    return true; // Explicit positions and the screen center are always sampled
 }
 
 // M6.5: Performance monitoring API
@@ -192,15 +489,39 @@ bool LightDataSensor3D::get_use_direct_texture_access() const {
 
 String LightDataSensor3D::get_optimization_strategy() const {
     // M6.5: Return information about which optimization strategy is being used
-    if (_is_gpu_mode_available() && use_direct_texture_access) {
-        return "Direct GPU Texture Access (Optimal)";
-    } else if (_is_gpu_mode_available()) {
-        return "GPU Mode with Texture Caching";
+    if (_is_gpu_mode_available()) {
+        switch (capture_strategy) {
+            case CAPTURE_STRATEGY_DIRECT:
+                return "Direct GPU Texture Access (Optimal)";
+            case CAPTURE_STRATEGY_FRAME_CACHE:
+                return "GPU Mode with Texture Caching";
+            default:
+                return "GPU Mode (capture tier not probed yet)";
+        }
     } else {
-        return "CPU Fallback with Frame Skipping";
+        return "CPU Readback (max-age policy)";
     }
 }
 
+uint64_t LightDataSensor3D::get_readback_count() const {
+    return readback_count;
+}
+
+void LightDataSensor3D::release_capture_cache() {
+    g_viewport_capture.clear();
+}
+
+void LightDataSensor3D::invalidate_capture_strategies() {
+    g_capture_device_epoch++;
+}
+
+void LightDataSensor3D::warm_up_pipelines() {
+#ifdef _WIN32
+    _warm_up_d3d12_pipeline();
+#endif
+    // macOS builds its single-sensor pipeline with the node's first Metal init; Linux has none
+}
+
 String LightDataSensor3D::get_platform_info() const {
 #ifdef __APPLE__
     return "macOS (Metal GPU compute available)";
@@ -238,6 +559,9 @@ String LightDataSensor3D::get_support_status() const {
 // --- Internal methods ---
 
 void LightDataSensor3D::_initialize_platform_compute() {
+    // A (re)initialized backend may change which capture tiers work
+    invalidate_capture_strategies();
+    
     // Initialize platform-specific compute backends
 #ifdef __APPLE__
     _init_metal_compute();
@@ -248,227 +572,181 @@ void LightDataSensor3D::_initialize_platform_compute() {
 #endif
 }
 
-void LightDataSensor3D::_sample_viewport_color() {
+bool LightDataSensor3D::_sample_viewport_color() {
     // M6.5: GPU mode detection and optimization
     // If GPU mode is available, use GPU-optimized sampling
     if (_is_gpu_mode_available()) {
-        _sample_gpu_optimized();
-        return;
-    }
-    
-    // Frame skipping to reduce expensive get_image() calls
-    frame_skip_counter++;
-    if (frame_skip_counter < frame_skip_interval) {
-        // Skip this frame, use cached data if available
-        return;
+        // A failed or skipped capture produced nothing: the previous reading stands
+        if (!_sample_gpu_optimized()) {
+            return false;
+        }
+        _mark_reading(Engine::get_singleton()->get_process_frames(), sensor_steady_usec());
+        return true;
     }
-    frame_skip_counter = 0; // Reset counter
-    
     
     Viewport *vp = get_viewport();
     if (!vp) {
-        return;
+        return false;
     }
     Ref<ViewportTexture> tex = vp->get_texture();
     if (tex.is_null()) {
-        return;
+        return false;
     }
     
     // M6.5: Only use get_image() in CPU fallback mode
     // PERFORMANCE WARNING: get_image() causes expensive CPU-GPU synchronization
     Ref<Image> img = tex->get_image();
     if (img.is_null()) {
-        return;
+        return false;
     }
 
     const int width = img->get_width();
     const int height = img->get_height();
     if (width <= 0 || height <= 0) {
-        return;
+        return false;
     }
 
     // Sample a small square around the target position to reduce cost.
     const int sample_radius = 4; // 9x9 max 81 samples
-    int cx = width / 2;  // Default to center
-    int cy = height / 2;
-    
-    // Use screen_sample_pos if it's been set
-    if (screen_sample_pos.x > 0 && screen_sample_pos.y > 0) {
-        cx = static_cast<int>(screen_sample_pos.x);
-        cy = static_cast<int>(screen_sample_pos.y);
+    int cx = 0;
+    int cy = 0;
+    if (!_resolve_sample_center(width, height, cx, cy)) {
+        return false; // Tracked position is off-screen; keep the previous reading
     }
     double sum_r = 0.0;
     double sum_g = 0.0;
     double sum_b = 0.0;
     int sample_count = 0;
 
-    for (int dy = -sample_radius; dy <= sample_radius; ++dy) {
-        const int y = cy + dy;
-        if (y < 0 || y >= height) continue;
-        for (int dx = -sample_radius; dx <= sample_radius; ++dx) {
-            const int x = cx + dx;
-            if (x < 0 || x >= width) continue;
-            const Color c = img->get_pixel(x, y);
-            sum_r += c.r;
-            sum_g += c.g;
-            sum_b += c.b;
-            ++sample_count;
-        }
-    }
+    _for_each_linear_pixel(img, cx, cy, sample_radius, [&](float r, float g, float b) {
+        sum_r += r;
+        sum_g += g;
+        sum_b += b;
+        ++sample_count;
+    });
 
-    if (sample_count > 0) {
-        const double inv = 1.0 / static_cast<double>(sample_count);
-        current_color = Color(sum_r * inv, sum_g * inv, sum_b * inv, 1.0);
-        current_light_level = _calculate_luminance(current_color);
-    } else {
+    if (sample_count == 0) {
+        return false;
     }
+    const double inv = 1.0 / static_cast<double>(sample_count);
+    current_color = _finish_linear_average(Color(sum_r * inv, sum_g * inv, sum_b * inv, 1.0));
+    current_light_level = _calculate_luminance(current_color);
+    _mark_reading(Engine::get_singleton()->get_process_frames(), sensor_steady_usec());
     // No image lock/unlock needed for CPU-side reads in this context.
+    return true;
 }
 
-void LightDataSensor3D::_capture_center_region_for_gpu() {
-    // M6.5: Hybrid GPU optimization strategy
-    // This function implements a multi-tier approach to eliminate get_image() calls
-    
-    // 1. Try direct GPU texture access first (best performance)
-    if (_is_gpu_mode_available() && use_direct_texture_access) {
-        if (_capture_gpu_direct_texture()) {
-            return; // Success with direct GPU access
-        }
-    }
-    
-    // 2. Try texture caching strategy (reduces get_image() calls by 80-90%)
-    if (_capture_cached_texture()) {
-        return; // Success with cached texture
+bool LightDataSensor3D::_capture_center_region_for_gpu() {
+    // M6.5: Hybrid GPU optimization strategy, as a memoized state machine.
+    // Direct access is probed once per viewport (and again after a device change). Once it
+    // has failed, samples go straight to the shared frame cache without retrying it.
+    Viewport *vp = get_viewport();
+    if (!vp) {
+        return false;
     }
+    ViewportCaptureState &state = _get_capture_state(vp->get_instance_id());
     
-    // 3. Fall back to optimized get_image() with frame skipping
-    _capture_fallback_optimized();
-}
-
-
-bool LightDataSensor3D::_capture_cached_texture() {
-    // M6.5: Intelligent texture caching strategy
-    // Cache the texture and only update when necessary
+    // New sample: no readback yet
+    sample_image.unref();
     
-    // Start performance timing
-    _start_performance_timer();
-    
-    static Ref<Image> cached_image;
-    static uint64_t last_frame = 0;
-    static bool cache_valid = false;
-    
-    uint64_t current_frame = Engine::get_singleton()->get_process_frames();
-    
-    // Only get new image if frame has changed
-    if (!cache_valid || current_frame != last_frame) {
-        Viewport *vp = get_viewport();
-        if (!vp) {
-            _end_performance_timer();
-            return false;
+    if (_is_gpu_mode_available() && use_direct_texture_access && state.direct_tier != CAPTURE_STRATEGY_FRAME_CACHE) {
+        const bool direct_ok = _capture_gpu_direct_texture();
+        if (state.direct_tier == CAPTURE_STRATEGY_UNPROBED) {
+            state.direct_tier = direct_ok ? CAPTURE_STRATEGY_DIRECT : CAPTURE_STRATEGY_FRAME_CACHE;
         }
-        
-        Ref<ViewportTexture> tex = vp->get_texture();
-        if (tex.is_null()) {
-            _end_performance_timer();
-            return false;
+        if (direct_ok) {
+            capture_strategy = CAPTURE_STRATEGY_DIRECT;
+            sample_image.unref();
+            return true;
         }
-        
-        // Only call get_image() when absolutely necessary
-        cached_image = tex->get_image();
-        cache_valid = !cached_image.is_null();
-        last_frame = current_frame;
-    }
-    
-    if (!cache_valid) {
-        _end_performance_timer();
-        return false;
     }
     
-    // Use cached image for processing
-    bool result = _process_cached_image(cached_image);
-    _end_performance_timer();
-    return result;
+    // Reuses the image if the direct attempt already read the frame back
+    capture_strategy = CAPTURE_STRATEGY_FRAME_CACHE;
+    const bool captured = _capture_cached_texture();
+    sample_image.unref();
+    return captured;
 }
 
-void LightDataSensor3D::_capture_fallback_optimized() {
-    // M6.5: Optimized fallback with frame skipping
-    // This is the last resort when other methods fail
-    
-    // Start performance timing
-    _start_performance_timer();
+Ref<Image> LightDataSensor3D::_acquire_frame_image(const Ref<ViewportTexture> &tex) {
+    if (sample_image.is_valid()) {
+        return sample_image;
+    }
     
-    // Frame skipping to reduce expensive get_image() calls
-    frame_skip_counter++;
-    if (frame_skip_counter < frame_skip_interval) {
-        // Skip this frame, use cached data if available
-        if (has_new_readings.exchange(false)) {
-            emit_signal("color_updated", current_color);
-            emit_signal("light_level_updated", current_light_level);
-        }
-        _end_performance_timer();
-        return;
+    Viewport *vp = get_viewport();
+    if (!vp || tex.is_null()) {
+        return Ref<Image>();
     }
-    frame_skip_counter = 0; // Reset counter
     
+    // Other sensors of this viewport may already have read this frame back
+    ViewportCaptureState &state = _get_capture_state(vp->get_instance_id());
+    const uint64_t current_frame = Engine::get_singleton()->get_process_frames();
+    if (state.image.is_null() || state.image_frame != current_frame) {
+        // PERFORMANCE WARNING: get_image() causes expensive CPU-GPU synchronization
+        state.image = tex->get_image();
+        state.image_frame = current_frame;
+        readback_count++;
+    }
+    sample_image = state.image;
+    return sample_image;
+}
+
+
+bool LightDataSensor3D::_capture_cached_texture() {
+    // M6.5: Intelligent texture caching strategy
+    // One readback per viewport per frame, shared by every sensor sampling that frame.
+    // Timed by the caller (_sample_gpu_optimized).
     Viewport *vp = get_viewport();
     if (!vp) {
-        return;
+        return false;
     }
+    
     Ref<ViewportTexture> tex = vp->get_texture();
     if (tex.is_null()) {
-        return;
+        return false;
     }
     
-    // M6.5: Only use get_image() when absolutely necessary
-    // PERFORMANCE WARNING: get_image() causes expensive CPU-GPU synchronization
-    // This should only be called when absolutely necessary and at reduced frequency
-    Ref<Image> img = tex->get_image();
+    Ref<Image> img = _acquire_frame_image(tex);
     if (img.is_null()) {
-        return;
-    }
-    const int width = img->get_width();
-    const int height = img->get_height();
-    if (width <= 0 || height <= 0) {
-        return;
+        return false;
     }
-    // Prepare a small center region for GPU averaging.
-    const int sample_radius = 4;
-    int cx = width / 2;
-    int cy = height / 2;
-    // If a screen sample position was set, prefer it.
-    if (screen_sample_pos.x > 0 && screen_sample_pos.y > 0) {
-        cx = static_cast<int>(screen_sample_pos.x);
-        cy = static_cast<int>(screen_sample_pos.y);
+    return _process_cached_image(img);
+}
+
+bool LightDataSensor3D::_resolve_sample_center(int p_width, int p_height, int &r_cx, int &r_cy) const {
+    // Priority: explicit set_screen_sample_pos() > tracked global_position > screen center.
+    // An explicit (0, 0) is a valid position (top-left pixel).
+    if (has_explicit_sample_pos) {
+        r_cx = static_cast<int>(screen_sample_pos.x);
+        r_cy = static_cast<int>(screen_sample_pos.y);
+        return true;
     }
-    const int region_w = sample_radius * 2 + 1;
-    const int region_h = sample_radius * 2 + 1;
-    std::vector<float> local_buffer;
-    local_buffer.reserve(region_w * region_h * 4);
-    for (int dy = -sample_radius; dy <= sample_radius; ++dy) {
-        const int y = cy + dy;
-        if (y < 0 || y >= height) continue;
-        for (int dx = -sample_radius; dx <= sample_radius; ++dx) {
-            const int x = cx + dx;
-            if (x < 0 || x >= width) continue;
-            const Color c = img->get_pixel(x, y);
-            local_buffer.push_back(c.r);
-            local_buffer.push_back(c.g);
-            local_buffer.push_back(c.b);
-            local_buffer.push_back(1.0f);
+    if (track_global_position && tracked_pos_valid) {
+        if (!tracked_pos_on_screen) {
+            return false;
         }
+        r_cx = static_cast<int>(tracked_screen_pos.x);
+        r_cy = static_cast<int>(tracked_screen_pos.y);
+        return true;
     }
-    // No image lock/unlock needed for CPU-side reads in this context.
-    {
-        std::lock_guard<std::mutex> lock(frame_mutex);
-        frame_rgba32f = std::move(local_buffer);
-        frame_width = region_w;
-        frame_height = region_h;
-        frame_ready = true;
+    r_cx = p_width / 2;
+    r_cy = p_height / 2;
+    return true;
+}
+
+void LightDataSensor3D::_update_tracked_screen_pos() {
+    Viewport *vp = get_viewport();
+    Camera3D *camera = vp ? vp->get_camera_3d() : nullptr;
+    SensorProjection projection;
+    if (!camera || !projection.setup(camera, vp->get_visible_rect().size)) {
+        // No active camera: fall back to the screen center
+        set_tracked_screen_pos(Vector2(), false, false);
+        return;
     }
-    frame_cv.notify_one();
     
-    // End performance timing
-    _end_performance_timer();
+    Vector2 screen_pos;
+    const bool on_screen = projection.project(get_global_position(), screen_pos);
+    set_tracked_screen_pos(screen_pos, true, on_screen);
 }
 
 float LightDataSensor3D::_calculate_luminance(const Color &color) const {
@@ -493,7 +771,7 @@ bool LightDataSensor3D::_is_gpu_mode_available() const {
 #endif
 }
 
-void LightDataSensor3D::_sample_gpu_optimized() {
+bool LightDataSensor3D::_sample_gpu_optimized() {
     // M6.5: GPU-optimized sampling that avoids get_image() calls
     // This method uses direct GPU texture access when available
     
@@ -504,7 +782,7 @@ void LightDataSensor3D::_sample_gpu_optimized() {
     // In future phases, this will implement true direct GPU texture access
     
     // Use the existing GPU sampling method but with performance optimizations
-    _capture_center_region_for_gpu();
+    const bool captured = _capture_center_region_for_gpu();
     
     // End performance timing
     _end_performance_timer();
@@ -513,102 +791,20 @@ void LightDataSensor3D::_sample_gpu_optimized() {
     // - Direct GPU texture sampling
     // - Batch processing for multiple sensors
     // - Reduced CPU-GPU synchronization
-}
-
-void LightDataSensor3D::_sample_cpu_fallback() {
-    // M6.5: CPU fallback sampling with optimizations
-    // This method is used when GPU mode is not available
-    
-    // Start performance timing
-    _start_performance_timer();
-    
-    // Frame skipping to reduce expensive get_image() calls
-    frame_skip_counter++;
-    if (frame_skip_counter < frame_skip_interval) {
-        // Skip this frame, use cached data if available
-        _end_performance_timer(); // Still time the skip
-        return;
-    }
-    frame_skip_counter = 0; // Reset counter
-    
-    Viewport *vp = get_viewport();
-    if (!vp) {
-        return;
-    }
-    Ref<ViewportTexture> tex = vp->get_texture();
-    if (tex.is_null()) {
-        return;
-    }
-    
-    // M6.5: Only use get_image() in CPU fallback mode
-    // PERFORMANCE WARNING: get_image() causes expensive CPU-GPU synchronization
-    Ref<Image> img = tex->get_image();
-    if (img.is_null()) {
-        return;
-    }
-
-    const int width = img->get_width();
-    const int height = img->get_height();
-    if (width <= 0 || height <= 0) {
-        return;
-    }
-
-    // Sample a small square around the target position to reduce cost.
-    const int sample_radius = 4; // 9x9 max 81 samples
-    int cx = width / 2;  // Default to center
-    int cy = height / 2;
-    
-    // Use screen_sample_pos if it's been set
-    if (screen_sample_pos.x > 0 && screen_sample_pos.y > 0) {
-        cx = static_cast<int>(screen_sample_pos.x);
-        cy = static_cast<int>(screen_sample_pos.y);
-    }
-    double sum_r = 0.0;
-    double sum_g = 0.0;
-    double sum_b = 0.0;
-    int sample_count = 0;
-
-    for (int dy = -sample_radius; dy <= sample_radius; ++dy) {
-        const int y = cy + dy;
-        if (y < 0 || y >= height) continue;
-        for (int dx = -sample_radius; dx <= sample_radius; ++dx) {
-            const int x = cx + dx;
-            if (x < 0 || x >= width) continue;
-            const Color c = img->get_pixel(x, y);
-            sum_r += c.r;
-            sum_g += c.g;
-            sum_b += c.b;
-            ++sample_count;
-        }
-    }
-
-    if (sample_count > 0) {
-        const double inv = 1.0 / static_cast<double>(sample_count);
-        current_color = Color(sum_r * inv, sum_g * inv, sum_b * inv, 1.0);
-        current_light_level = _calculate_luminance(current_color);
-    }
-    
-    // End performance timing
-    _end_performance_timer();
-    
-    // No image lock/unlock needed for CPU-side reads in this context.
+    return captured;
 }
 
 bool LightDataSensor3D::_capture_gpu_direct_texture() {
     // M6.5: Direct GPU texture access implementation
-    // This method attempts to work directly with GPU textures without CPU-GPU synchronization
-    
-    // Start performance timing
-    _start_performance_timer();
+    // This method attempts to work directly with GPU textures without CPU-GPU synchronization.
+    // Timed by the caller (_sample_gpu_optimized).
     
     Viewport *vp = get_viewport();
     if (!vp) {
-        _end_performance_timer();
         return false;
     }
     Ref<ViewportTexture> tex = vp->get_texture();
     if (tex.is_null()) {
-        _end_performance_timer();
         return false;
     }
     
@@ -621,7 +817,6 @@ bool LightDataSensor3D::_capture_gpu_direct_texture() {
         // Use Metal compute shaders to sample the texture directly on GPU
         // This avoids the expensive get_image() call and CPU-GPU synchronization
         if (_capture_metal_direct_texture(tex)) {
-            _end_performance_timer();
             return true; // Success with direct Metal access
         }
     }
@@ -630,8 +825,7 @@ bool LightDataSensor3D::_capture_gpu_direct_texture() {
     if (d3d_device != nullptr) {
         // Use D3D12 compute shaders to sample the texture directly on GPU
         if (_capture_d3d12_direct_texture(tex)) {
-            _end_performance_timer();
-            return; // Success with direct D3D12 access
+            return true; // Success with direct D3D12 access
         }
     }
 #elif defined(__linux__)
@@ -642,10 +836,7 @@ bool LightDataSensor3D::_capture_gpu_direct_texture() {
     }
 #endif
     
-    // If direct GPU access is not available or fails, fall back to optimized CPU method
-    // This ensures we always get results, even if not optimal
-    _sample_cpu_fallback();
-    _end_performance_timer();
+    // The caller moves on to the frame cache, reusing any readback made above
     return false; // Indicate that direct GPU access was not successful
 }
 
@@ -665,34 +856,42 @@ bool LightDataSensor3D::_process_cached_image(Ref<Image> img) {
     
     // Prepare a small center region for GPU averaging
     const int sample_radius = 4;
-    int cx = width / 2;
-    int cy = height / 2;
-    
-    // If a screen sample position was set, prefer it
-    if (screen_sample_pos.x > 0 && screen_sample_pos.y > 0) {
-        cx = static_cast<int>(screen_sample_pos.x);
-        cy = static_cast<int>(screen_sample_pos.y);
+    int cx = 0;
+    int cy = 0;
+    if (!_resolve_sample_center(width, height, cx, cy)) {
+        return false;
     }
     
     const int region_w = sample_radius * 2 + 1;
     const int region_h = sample_radius * 2 + 1;
     std::vector<float> local_buffer;
     local_buffer.reserve(region_w * region_h * 4);
-    
-    for (int dy = -sample_radius; dy <= sample_radius; ++dy) {
-        const int y = cy + dy;
-        if (y < 0 || y >= height) continue;
-        for (int dx = -sample_radius; dx <= sample_radius; ++dx) {
-            const int x = cx + dx;
-            if (x < 0 || x >= width) continue;
-            const Color c = img->get_pixel(x, y);
-            local_buffer.push_back(c.r);
-            local_buffer.push_back(c.g);
-            local_buffer.push_back(c.b);
-            local_buffer.push_back(1.0f);
-        }
+    double sum_r = 0.0;
+    double sum_g = 0.0;
+    double sum_b = 0.0;
+    int pixel_count = 0;
+    
+    // Staged in linear light so the compute kernels average correctly
+    _for_each_linear_pixel(img, cx, cy, sample_radius, [&](float r, float g, float b) {
+        local_buffer.push_back(r);
+        local_buffer.push_back(g);
+        local_buffer.push_back(b);
+        local_buffer.push_back(1.0f);
+        sum_r += r;
+        sum_g += g;
+        sum_b += b;
+        ++pixel_count;
+    });
+    if (pixel_count == 0) {
+        return false;
     }
     
+    // The backend publishes its average later; the caller marks this frame's reading now,
+    // so it has to carry this frame's color
+    const double inv = 1.0 / static_cast<double>(pixel_count);
+    current_color = _finish_linear_average(Color(sum_r * inv, sum_g * inv, sum_b * inv, 1.0));
+    current_light_level = _calculate_luminance(current_color);
+    
     // Store the processed data for GPU processing
     {
         std::lock_guard<std::mutex> lock(frame_mutex);
@@ -712,9 +911,6 @@ bool LightDataSensor3D::_capture_d3d12_direct_texture(Ref<ViewportTexture> tex)
     // M6.5: Windows D3D12 direct texture access implementation
     // This method attempts to work directly with D3D12 textures without CPU-GPU synchronization
     
-    // Start performance timing
-    _start_performance_timer();
-    
     // TODO: Implement actual D3D12 direct texture access
     // This would require:
     // 1. Getting the D3D12 texture from the ViewportTexture RID
@@ -723,7 +919,6 @@ bool LightDataSensor3D::_capture_d3d12_direct_texture(Ref<ViewportTexture> tex)
     
     // For now, this is a placeholder that falls back to CPU
     // In future phases, this will implement true D3D12 direct access
-    _end_performance_timer();
     return false; // Indicate that direct D3D12 access is not yet implemented
 }
 
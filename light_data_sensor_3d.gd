@@ -1,12 +1,31 @@
 @tool
 extends EditorPlugin
 
+const BAKE_SENSOR_SET_MENU := "Bake Light Sensor Set"
+
 
 func _enter_tree() -> void:
-	# Initialization of the plugin goes here.
-	pass
+	add_tool_menu_item(BAKE_SENSOR_SET_MENU, _bake_sensor_set)
 
 
 func _exit_tree() -> void:
-	# Clean-up of the plugin goes here.
-	pass
+	remove_tool_menu_item(BAKE_SENSOR_SET_MENU)
+
+
+# Packs every LightSensorPoint3D of the edited scene into <scene>.sensors.res, next to the
+# scene, for LightSensorManager.add_sensor_set() at level load.
+func _bake_sensor_set() -> void:
+	var root := EditorInterface.get_edited_scene_root()
+	if root == null or root.scene_file_path.is_empty():
+		push_warning("Save the scene before baking its light sensor set.")
+		return
+	var sensor_set := LightSensorSet.new()
+	if not sensor_set.bake_from_scene(root):
+		push_warning("No LightSensorPoint3D found in %s." % root.scene_file_path)
+		return
+	var path := root.scene_file_path.get_basename() + ".sensors.res"
+	var err := ResourceSaver.save(sensor_set, path)
+	if err != OK:
+		push_error("Could not save %s (error %d)." % [path, err])
+		return
+	print("Baked %d light sensors to %s" % [sensor_set.get_sensor_count(), path])
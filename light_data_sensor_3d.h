@@ -92,12 +92,31 @@ private:
     // Whether the readback thread should continue running
     std::atomic_bool is_running{false};
 
-    // Frame skipping to reduce expensive get_image() calls
-    int frame_skip_counter = 0;
-    int frame_skip_interval = 3; // Only call get_image() every 3rd frame
+    // Route refresh() through the per-viewport LightSensorBatcher (one readback per frame for all
+    // nodes). Opt-in: batched readings arrive at the end of the frame, not inside refresh().
+    bool use_batched_refresh = false;
+    // Readings are averaged in linear light; by default they are re-encoded to sRGB so they
+    // compare with the colors on screen. Enable to keep them linear (lighting math, HDR).
+    bool linear_color_output = false;
+
+    // Reading freshness. refresh() keeps the current reading, and emits nothing, while it is
+    // no older than max_reading_age_frames frames or max_reading_age_msec milliseconds.
+    int max_reading_age_frames = 0; // 0: reuse only within the frame it was captured
+    double max_reading_age_msec = 0.0; // 0: no time-based reuse
+    uint64_t reading_frame = 0; // Process frame the current reading was captured on
+    uint64_t reading_usec = 0; // Capture time, steady clock
+    bool has_reading = false;
+    bool last_refresh_reused = false;
     
     // M6.5: Performance monitoring and optimization
     bool use_direct_texture_access = false; // Enable direct GPU texture access
+    
+    // Capture tier chosen by the last GPU-mode sample (CaptureStrategy), and the image read
+    // back during the current sample. Every tier asks _acquire_frame_image(), so one sample
+    // performs at most one get_image() however many tiers it passes through.
+    int capture_strategy = 0;
+    Ref<Image> sample_image;
+    uint64_t readback_count = 0;
     std::chrono::high_resolution_clock::time_point last_sample_time;
     double average_sample_time = 0.0; // Average time per sample in milliseconds
     int sample_count = 0; // Number of samples taken for averaging
@@ -107,6 +126,14 @@ private:
     int frame_width = 0;
     int frame_height = 0;
     Vector2 screen_sample_pos = Vector2(0, 0);
+    bool has_explicit_sample_pos = false; // Set by set_screen_sample_pos(); (0, 0) is a valid position
+
+    // Automatic tracking of global_position through the viewport's active camera.
+    // Updated by the batcher's shared projection pass (or per node on the unbatched path).
+    bool track_global_position = true;
+    Vector2 tracked_screen_pos;
+    bool tracked_pos_valid = false; // False when no camera was available to project through
+    bool tracked_pos_on_screen = false;
 
 protected:
     static void _bind_methods();
@@ -131,7 +158,35 @@ public:
     // Main API method - updates sensor readings
     // WARNING: This method MUST be called from the main thread only!
     // Calling from background threads will cause crashes due to Godot API restrictions.
-    void refresh();
+    // Without force, a reading within the max-age policy is kept and no signals are emitted.
+    void refresh(bool force = false);
+
+    // Max-age policy for refresh()
+    void set_max_reading_age_frames(int frames);
+    int get_max_reading_age_frames() const;
+    void set_max_reading_age_msec(double msec);
+    double get_max_reading_age_msec() const;
+
+    // Provenance of the current reading
+    uint64_t get_reading_frame() const;
+    int64_t get_reading_age_frames() const;
+    double get_reading_age_msec() const;
+    bool has_valid_reading() const;
+    // True when the last refresh() kept the existing reading instead of sampling
+    bool was_last_refresh_reused() const;
+
+    // Batched refresh: when enabled, refresh() only enqueues this node and the readings
+    // (and signals) are delivered later in the same frame by the viewport's LightSensorBatcher.
+    void set_use_batched_refresh(bool enabled);
+    bool get_use_batched_refresh() const;
+    void set_linear_color_output(bool enabled);
+    bool get_linear_color_output() const;
+
+    // Called by LightSensorBatcher (C++ only)
+    bool get_batch_sample_center(const Vector2 &p_viewport_size, Vector2 &r_center) const;
+    bool wants_position_tracking() const;
+    void set_tracked_screen_pos(const Vector2 &p_screen_pos, bool p_valid, bool p_on_screen);
+    void apply_batched_reading(const Color &p_color, uint64_t p_source_frame, uint64_t p_source_usec);
 
     // Returns true if a GPU compute backend is active for this node (e.g., Metal on macOS)
     bool is_using_gpu() const;
@@ -141,8 +196,17 @@ public:
     String get_support_status() const;
 
     // Set the screen-space sample position (pixels) where this sensor should sample.
+    // An explicit position overrides global_position tracking until cleared.
     void set_screen_sample_pos(const Vector2 &p_screen_pos);
     Vector2 get_screen_sample_pos() const;
+    void clear_screen_sample_pos();
+    bool has_screen_sample_pos() const;
+
+    // Sample at the node's own global_position projected through the active camera
+    void set_track_global_position(bool enabled);
+    bool get_track_global_position() const;
+    // False while tracking places the node behind the camera or outside the viewport
+    bool is_on_screen() const;
     
     // M6.5: Performance monitoring API
     double get_average_sample_time() const;
@@ -150,23 +214,41 @@ public:
     void set_use_direct_texture_access(bool enabled);
     bool get_use_direct_texture_access() const;
     String get_optimization_strategy() const;
+    // Number of get_image() readbacks this node has performed
+    uint64_t get_readback_count() const;
+    
+    // Drops the per-viewport capture memo and frame cache (module teardown; C++ only)
+    static void release_capture_cache();
+    // Forces every viewport to re-probe its capture tier, e.g. after a device change (C++ only)
+    static void invalidate_capture_strategies();
+    // Builds the platform compute pipeline ahead of the first sensor; called on the warm-up thread at extension init (C++ only)
+    static void warm_up_pipelines();
 
 
 private:
     // Platform-specific initialization
     void _initialize_platform_compute();
     
-    // Internal M0 CPU sampling helper
-    void _sample_viewport_color();
-    // Internal: capture a small center region and stage into frame_rgba32f for GPU/worker
-    void _capture_center_region_for_gpu();
+    // Internal M0 CPU sampling helper; false when no new reading was produced
+    bool _sample_viewport_color();
+    // Internal: record the provenance of a reading that was just produced
+    void _mark_reading(uint64_t p_frame, uint64_t p_usec);
+    // Internal: turn a linear-light average into this node's output encoding
+    Color _finish_linear_average(const Color &p_linear) const;
+    bool _is_reading_reusable() const;
+    // Internal: capture a small center region, set current_color from it and stage it into
+    // frame_rgba32f for GPU/worker; false when nothing was captured
+    bool _capture_center_region_for_gpu();
+    // Internal: pick the pixel to sample; false when the tracked position is off-screen
+    bool _resolve_sample_center(int p_width, int p_height, int &r_cx, int &r_cy) const;
+    // Internal: project global_position for the unbatched refresh() path
+    void _update_tracked_screen_pos();
     // Internal: calculate luminance from color (0=dark, 1=bright)
     float _calculate_luminance(const Color &color) const;
     
     // M6.5: GPU Performance Optimization methods
     bool _is_gpu_mode_available() const;
-    void _sample_gpu_optimized();
-    void _sample_cpu_fallback();
+    bool _sample_gpu_optimized();
     bool _capture_gpu_direct_texture();
     
     // M6.5: Platform-specific direct GPU texture access methods
@@ -175,8 +257,10 @@ private:
     
     // M6.5: Hybrid optimization strategy methods
     bool _capture_cached_texture();
-    void _capture_fallback_optimized();
     bool _process_cached_image(Ref<Image> img);
+    // The one readback of the current sample: reuses this sample's image, then this frame's
+    // image of the same viewport, and only then calls get_image()
+    Ref<Image> _acquire_frame_image(const Ref<ViewportTexture> &tex);
     
     // M6.5: Performance monitoring methods
     void _start_performance_timer();
@@ -193,6 +277,9 @@ private:
 
     // Helper: read a single pixel from the shared buffer (unused in M0)
     Color _read_pixel_from_bar();
+
+    // Internal: create the averaging PSO once so its on-disk cache exists before the first sensor
+    static void _warm_up_d3d12_pipeline();
 #endif
 
 #ifdef __APPLE__
@@ -0,0 +1,259 @@
+#include "light_sensor_batcher.h"
+#include "light_data_sensor_3d.h"
+#include "sensor_clock.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/core/object.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/viewport_texture.hpp>
+#include <godot_cpp/classes/camera3d.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <limits>
+#include <unordered_map>
+
+using namespace godot;
+
+// Viewport instance id -> batcher instance id. Only touched from the main thread.
+static std::unordered_map<uint64_t, uint64_t> g_viewport_batchers;
+
+void LightSensorBatcher::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("flush"), &LightSensorBatcher::flush);
+    ClassDB::bind_method(D_METHOD("set_use_background_pipeline", "enabled"), &LightSensorBatcher::set_use_background_pipeline);
+    ClassDB::bind_method(D_METHOD("get_use_background_pipeline"), &LightSensorBatcher::get_use_background_pipeline);
+    ClassDB::bind_method(D_METHOD("get_pending_count"), &LightSensorBatcher::get_pending_count);
+    ClassDB::bind_method(D_METHOD("get_last_batch_size"), &LightSensorBatcher::get_last_batch_size);
+    ClassDB::bind_method(D_METHOD("get_flush_count"), &LightSensorBatcher::get_flush_count);
+    ClassDB::bind_method(D_METHOD("is_using_gpu_backend"), &LightSensorBatcher::is_using_gpu_backend);
+    ClassDB::bind_method(D_METHOD("get_coherence_stats"), &LightSensorBatcher::get_coherence_stats);
+}
+
+LightSensorBatcher::LightSensorBatcher() {
+    batch_compute_manager = nullptr;
+}
+
+LightSensorBatcher::~LightSensorBatcher() {
+}
+
+LightSensorBatcher* LightSensorBatcher::get_for_viewport(Viewport* p_viewport) {
+    if (!p_viewport) {
+        return nullptr;
+    }
+
+    const uint64_t vp_id = p_viewport->get_instance_id();
+    auto it = g_viewport_batchers.find(vp_id);
+    if (it != g_viewport_batchers.end()) {
+        LightSensorBatcher* existing = Object::cast_to<LightSensorBatcher>(ObjectDB::get_instance(it->second));
+        if (existing) {
+            return existing;
+        }
+        g_viewport_batchers.erase(it);
+    }
+
+    LightSensorBatcher* batcher = memnew(LightSensorBatcher);
+    batcher->set_name("LightSensorBatcher");
+    batcher->viewport_id = vp_id;
+    g_viewport_batchers[vp_id] = batcher->get_instance_id();
+
+    // Deferred: refresh() may run while the viewport is busy setting up its children.
+    // Sensors queued before the batcher enters the tree are flushed on its first frame.
+    p_viewport->call_deferred("add_child", batcher, false, Node::INTERNAL_MODE_BACK);
+    return batcher;
+}
+
+void LightSensorBatcher::_ready() {
+    Node::_ready();
+
+    batch_compute_manager = memnew(BatchComputeManager);
+    // Linear averages; every node re-encodes for its own linear_color_output setting
+    batch_compute_manager->set_linear_color_output(true);
+    add_child(batch_compute_manager);
+
+    // Flush after every other node has had the chance to call refresh() this frame
+    set_process_priority(std::numeric_limits<int>::max());
+    set_process(true);
+}
+
+void LightSensorBatcher::_process(double delta) {
+    _deliver_async_results();
+    flush();
+}
+
+void LightSensorBatcher::_exit_tree() {
+    auto it = g_viewport_batchers.find(viewport_id);
+    if (it != g_viewport_batchers.end() && it->second == get_instance_id()) {
+        g_viewport_batchers.erase(it);
+    }
+
+    pending_sensors.clear();
+    pending_lookup.clear();
+    inflight_sensors.clear();
+    batch_compute_manager = nullptr; // Child node is freed with us
+}
+
+void LightSensorBatcher::enqueue(LightDataSensor3D* p_sensor) {
+    if (!p_sensor) {
+        return;
+    }
+
+    const uint64_t id = p_sensor->get_instance_id();
+    if (pending_lookup.insert(id).second) {
+        pending_sensors.push_back(id);
+    }
+}
+
+void LightSensorBatcher::flush() {
+    if (pending_sensors.empty() || !batch_compute_manager || !batch_compute_manager->is_available()) {
+        return;
+    }
+    if (batch_compute_manager->is_async_busy()) {
+        return; // Previous batch is still on the worker pool; the queue waits for the next frame
+    }
+    // The previous batch may have finished after this frame's poll: deliver it before its
+    // sensor list is replaced by the next batch's
+    _deliver_async_results();
+
+    Viewport *vp = get_viewport();
+    if (!vp) {
+        return;
+    }
+    Ref<ViewportTexture> tex = vp->get_texture();
+    if (tex.is_null()) {
+        return;
+    }
+
+    const Vector2 viewport_size = vp->get_visible_rect().size;
+    const int sample_radius = 4; // Same 9x9 region as the per-node sampling path
+
+    // Resolve live sensors and gather the positions of those tracking their global_position
+    queued_sensors.clear();
+    tracked_indices.clear();
+    tracked_world.clear();
+    for (uint64_t id : pending_sensors) {
+        LightDataSensor3D* sensor = Object::cast_to<LightDataSensor3D>(ObjectDB::get_instance(id));
+        if (!sensor || !sensor->is_inside_tree()) {
+            continue;
+        }
+        if (sensor->wants_position_tracking()) {
+            tracked_indices.push_back(queued_sensors.size());
+            tracked_world.push_back(sensor->get_global_position());
+        }
+        queued_sensors.push_back(sensor);
+    }
+
+    // Shared projection pass: one camera fetch for every tracked sensor in the batch
+    if (!tracked_indices.empty()) {
+        const bool can_project = projection.setup(vp->get_camera_3d(), viewport_size);
+        tracked_screen.resize(tracked_world.size());
+        tracked_visible.resize(tracked_world.size());
+        projection.project_batch(tracked_world.data(), tracked_world.size(), tracked_screen.data(), tracked_visible.data());
+        for (size_t i = 0; i < tracked_indices.size(); ++i) {
+            queued_sensors[tracked_indices[i]]->set_tracked_screen_pos(tracked_screen[i], can_project, tracked_visible[i] != 0);
+        }
+    }
+
+    batch_regions.clear();
+    batch_sensors.clear();
+    for (LightDataSensor3D* sensor : queued_sensors) {
+        Vector2 center;
+        if (!sensor->get_batch_sample_center(viewport_size, center)) {
+            continue; // Off-screen: keep its previous reading
+        }
+        batch_regions.emplace_back(center.x, center.y, sample_radius, static_cast<int>(batch_sensors.size()));
+        batch_sensors.push_back(sensor);
+    }
+
+    if (batch_sensors.empty()) {
+        pending_sensors.clear();
+        pending_lookup.clear();
+        return;
+    }
+
+    batch_compute_manager->set_sensor_regions(batch_regions);
+    batch_compute_manager->set_region_space_size(viewport_size);
+
+    if (use_background_pipeline && batch_compute_manager->supports_async()) {
+        if (!batch_compute_manager->submit_sensors_async(tex)) {
+            return; // Keep the queue; retried next frame
+        }
+        inflight_ticket = batch_compute_manager->get_async_submitted_ticket();
+        inflight_sensors.clear();
+        for (LightDataSensor3D* sensor : batch_sensors) {
+            inflight_sensors.push_back(sensor->get_instance_id());
+        }
+        pending_sensors.clear();
+        pending_lookup.clear();
+        return;
+    }
+
+    if (!batch_compute_manager->process_sensors(tex)) {
+        // Keep the queue; the readback is retried next frame
+        return;
+    }
+
+    // Clear before delivering so signal handlers may call refresh() for the next frame
+    pending_sensors.clear();
+    pending_lookup.clear();
+    _deliver(batch_sensors, Engine::get_singleton()->get_process_frames(), sensor_steady_usec());
+}
+
+void LightSensorBatcher::_deliver_async_results() {
+    if (inflight_sensors.empty() || !batch_compute_manager || !batch_compute_manager->poll_async_results()) {
+        return;
+    }
+    if (batch_compute_manager->get_async_completed_ticket() != inflight_ticket) {
+        return; // Not this batch's result: its slots do not line up with inflight_sensors
+    }
+
+    // Sensors freed while their batch was on the worker pool resolve to null and are skipped
+    batch_sensors.clear();
+    for (uint64_t id : inflight_sensors) {
+        batch_sensors.push_back(Object::cast_to<LightDataSensor3D>(ObjectDB::get_instance(id)));
+    }
+    inflight_sensors.clear();
+    // Readings carry the frame they were captured in, not the frame they arrived in
+    _deliver(batch_sensors, batch_compute_manager->get_async_completed_frame(), batch_compute_manager->get_async_completed_usec());
+}
+
+void LightSensorBatcher::_deliver(const std::vector<LightDataSensor3D*> &p_sensors, uint64_t p_frame, uint64_t p_usec) {
+    batch_compute_manager->copy_results(batch_results);
+
+    last_batch_size = static_cast<int>(p_sensors.size());
+    flush_count++;
+
+    for (size_t i = 0; i < p_sensors.size() && i < batch_results.size(); ++i) {
+        if (p_sensors[i]) {
+            p_sensors[i]->apply_batched_reading(batch_results[i], p_frame, p_usec);
+        }
+    }
+}
+
+void LightSensorBatcher::set_use_background_pipeline(bool enabled) {
+    use_background_pipeline = enabled;
+}
+
+bool LightSensorBatcher::get_use_background_pipeline() const {
+    return use_background_pipeline;
+}
+
+int LightSensorBatcher::get_pending_count() const {
+    return static_cast<int>(pending_sensors.size());
+}
+
+int LightSensorBatcher::get_last_batch_size() const {
+    return last_batch_size;
+}
+
+uint64_t LightSensorBatcher::get_flush_count() const {
+    return flush_count;
+}
+
+bool LightSensorBatcher::is_using_gpu_backend() const {
+    return batch_compute_manager && batch_compute_manager->is_using_gpu_backend();
+}
+
+Dictionary LightSensorBatcher::get_coherence_stats() const {
+    if (batch_compute_manager) {
+        return batch_compute_manager->get_coherence_stats();
+    }
+    return Dictionary();
+}
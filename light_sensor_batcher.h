@@ -0,0 +1,92 @@
+#ifndef LIGHT_SENSOR_BATCHER_H
+#define LIGHT_SENSOR_BATCHER_H
+
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/classes/viewport.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/godot.hpp>
+#include <godot_cpp/variant/color.hpp>
+
+#include "batch_compute_manager.h"
+#include "sensor_projection.h"
+
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace godot {
+
+class LightDataSensor3D;
+
+// Implicit per-viewport batching singleton for standalone LightDataSensor3D nodes.
+// refresh() enqueues the sensor; once per frame (after every other node has processed)
+// the batcher takes a single viewport snapshot, samples all queued sensors through a
+// BatchComputeManager and delivers the readings back to each node.
+class LightSensorBatcher : public Node {
+    GDCLASS(LightSensorBatcher, Node);
+
+private:
+    BatchComputeManager* batch_compute_manager = nullptr;
+
+    // Sensors queued since the last flush, stored as ObjectIDs so freed nodes are skipped
+    std::vector<uint64_t> pending_sensors;
+    std::unordered_set<uint64_t> pending_lookup;
+
+    // Per-flush scratch, kept across frames to avoid reallocation
+    std::vector<LightDataSensor3D*> queued_sensors;
+    std::vector<size_t> tracked_indices;
+    std::vector<Vector3> tracked_world;
+    std::vector<Vector2> tracked_screen;
+    std::vector<uint8_t> tracked_visible;
+    SensorProjection projection;
+    std::vector<SensorRegion> batch_regions;
+    std::vector<Color> batch_results;
+    std::vector<LightDataSensor3D*> batch_sensors;
+
+    // Sensors of the batch running on the worker pool, delivered on a later frame, and the
+    // ticket of that batch; only a result carrying this ticket is applied to them
+    std::vector<uint64_t> inflight_sensors;
+    uint64_t inflight_ticket = 0;
+    bool use_background_pipeline = true;
+
+    uint64_t viewport_id = 0;
+    int last_batch_size = 0;
+    uint64_t flush_count = 0;
+
+    void _deliver(const std::vector<LightDataSensor3D*> &p_sensors, uint64_t p_frame, uint64_t p_usec);
+    void _deliver_async_results();
+
+protected:
+    static void _bind_methods();
+
+public:
+    LightSensorBatcher();
+    ~LightSensorBatcher();
+
+    // Returns the batcher owned by p_viewport, creating it on first use (main thread only)
+    static LightSensorBatcher* get_for_viewport(Viewport* p_viewport);
+
+    void _ready() override;
+    void _process(double delta) override;
+    void _exit_tree() override;
+
+    // Queue a sensor for the next flush; duplicate requests within a frame are merged
+    void enqueue(LightDataSensor3D* p_sensor);
+    // Sample every queued sensor against one snapshot and deliver the results.
+    // With the background pipeline the readings arrive on a following frame.
+    void flush();
+
+    void set_use_background_pipeline(bool enabled);
+    bool get_use_background_pipeline() const;
+
+    // Statistics
+    int get_pending_count() const;
+    int get_last_batch_size() const;
+    uint64_t get_flush_count() const;
+    bool is_using_gpu_backend() const;
+    Dictionary get_coherence_stats() const;
+};
+
+} // namespace godot
+
+#endif // LIGHT_SENSOR_BATCHER_H
@@ -1,18 +1,31 @@
 #include "light_sensor_manager.h"
 #include "batch_compute_manager.h"
+#include "light_sensor_point_3d.h"
+#include "sensor_clock.h"
 #include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/core/object.hpp>
 #include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/multi_mesh.hpp>
 #include <godot_cpp/classes/viewport.hpp>
 #include <godot_cpp/classes/camera3d.hpp>
+#include <godot_cpp/classes/sub_viewport.hpp>
+#include <godot_cpp/classes/world3d.hpp>
 #include <godot_cpp/classes/timer.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace godot;
 
 void LightSensorManager::_bind_methods() {
     // Signals
     ADD_SIGNAL(MethodInfo("sensor_updated", PropertyInfo(Variant::INT, "sensor_id"), PropertyInfo(Variant::COLOR, "color")));
     ADD_SIGNAL(MethodInfo("all_sensors_updated"));
+    ADD_SIGNAL(MethodInfo("sensors_predicted"));
+    ADD_SIGNAL(MethodInfo("probes_updated"));
     
     // Properties
     ClassDB::bind_method(D_METHOD("initialize"), &LightSensorManager::initialize);
@@ -24,6 +37,16 @@ void LightSensorManager::_bind_methods() {
     ClassDB::bind_method(D_METHOD("remove_sensor", "sensor_id"), &LightSensorManager::remove_sensor);
     ClassDB::bind_method(D_METHOD("clear_all_sensors"), &LightSensorManager::clear_all_sensors);
     ClassDB::bind_method(D_METHOD("get_sensor_count"), &LightSensorManager::get_sensor_count);
+    ClassDB::bind_method(D_METHOD("add_probe_sensor", "world_position", "metadata_label"), &LightSensorManager::add_probe_sensor, DEFVAL(""));
+    ClassDB::bind_method(D_METHOD("is_probe_sensor", "sensor_id"), &LightSensorManager::is_probe_sensor);
+    ClassDB::bind_method(D_METHOD("add_node_sensor", "node", "local_offset", "metadata_label"), &LightSensorManager::add_node_sensor, DEFVAL(Vector3()), DEFVAL(""));
+    ClassDB::bind_method(D_METHOD("get_last_moved_sensor_count"), &LightSensorManager::get_last_moved_sensor_count);
+    ClassDB::bind_method(D_METHOD("add_multimesh_sensors", "node", "local_offset", "instances", "metadata_label"), &LightSensorManager::add_multimesh_sensors, DEFVAL(Vector3()), DEFVAL(PackedInt32Array()), DEFVAL(""));
+    ClassDB::bind_method(D_METHOD("add_bone_sensor", "skeleton", "bone_name", "local_offset", "metadata_label"), &LightSensorManager::add_bone_sensor, DEFVAL(Vector3()), DEFVAL(""));
+    ClassDB::bind_method(D_METHOD("get_attachment_stats"), &LightSensorManager::get_attachment_stats);
+    ClassDB::bind_method(D_METHOD("add_sensor_set", "sensor_set", "group"), &LightSensorManager::add_sensor_set, DEFVAL(""));
+    ClassDB::bind_method(D_METHOD("get_last_sensor_set_load_usec"), &LightSensorManager::get_last_sensor_set_load_usec);
+    ClassDB::bind_method(D_METHOD("set_sensor_sample_radius", "sensor_id", "radius"), &LightSensorManager::set_sensor_sample_radius);
     
     // Sensor data access
     ClassDB::bind_method(D_METHOD("get_sensor_color", "sensor_id"), &LightSensorManager::get_sensor_color);
@@ -32,10 +55,34 @@ void LightSensorManager::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_sensor_metadata", "sensor_id"), &LightSensorManager::get_sensor_metadata);
     ClassDB::bind_method(D_METHOD("get_sensor_data", "sensor_id"), &LightSensorManager::get_sensor_data);
     ClassDB::bind_method(D_METHOD("get_all_sensor_data"), &LightSensorManager::get_all_sensor_data);
+    ClassDB::bind_method(D_METHOD("is_sensor_predicted", "sensor_id"), &LightSensorManager::is_sensor_predicted);
+    ClassDB::bind_method(D_METHOD("get_probe_face_colors", "sensor_id"), &LightSensorManager::get_probe_face_colors);
+    ClassDB::bind_method(D_METHOD("sample_probe_direction", "sensor_id", "direction"), &LightSensorManager::sample_probe_direction);
+    
+    // Probe capture
+    ClassDB::bind_method(D_METHOD("set_probe_cluster_size", "size"), &LightSensorManager::set_probe_cluster_size);
+    ClassDB::bind_method(D_METHOD("get_probe_cluster_size"), &LightSensorManager::get_probe_cluster_size);
+    ClassDB::bind_method(D_METHOD("set_probe_face_resolution", "pixels"), &LightSensorManager::set_probe_face_resolution);
+    ClassDB::bind_method(D_METHOD("get_probe_face_resolution"), &LightSensorManager::get_probe_face_resolution);
+    ClassDB::bind_method(D_METHOD("set_probe_faces_per_frame", "faces"), &LightSensorManager::set_probe_faces_per_frame);
+    ClassDB::bind_method(D_METHOD("get_probe_faces_per_frame"), &LightSensorManager::get_probe_faces_per_frame);
+    ClassDB::bind_method(D_METHOD("set_probe_far", "distance"), &LightSensorManager::set_probe_far);
+    ClassDB::bind_method(D_METHOD("get_probe_far"), &LightSensorManager::get_probe_far);
+    ClassDB::bind_method(D_METHOD("get_probe_stats"), &LightSensorManager::get_probe_stats);
     
     // Configuration
     ClassDB::bind_method(D_METHOD("set_poll_hz", "hz"), &LightSensorManager::set_poll_hz);
     ClassDB::bind_method(D_METHOD("get_poll_hz"), &LightSensorManager::get_poll_hz);
+    ClassDB::bind_method(D_METHOD("set_use_adaptive_poll_rate", "enabled"), &LightSensorManager::set_use_adaptive_poll_rate);
+    ClassDB::bind_method(D_METHOD("get_use_adaptive_poll_rate"), &LightSensorManager::get_use_adaptive_poll_rate);
+    ClassDB::bind_method(D_METHOD("set_adaptive_min_hz", "hz"), &LightSensorManager::set_adaptive_min_hz);
+    ClassDB::bind_method(D_METHOD("get_adaptive_min_hz"), &LightSensorManager::get_adaptive_min_hz);
+    ClassDB::bind_method(D_METHOD("set_adaptive_sample_budget", "samples_per_second"), &LightSensorManager::set_adaptive_sample_budget);
+    ClassDB::bind_method(D_METHOD("get_adaptive_sample_budget"), &LightSensorManager::get_adaptive_sample_budget);
+    ClassDB::bind_method(D_METHOD("set_adaptive_volatility_scale", "scale"), &LightSensorManager::set_adaptive_volatility_scale);
+    ClassDB::bind_method(D_METHOD("get_adaptive_volatility_scale"), &LightSensorManager::get_adaptive_volatility_scale);
+    ClassDB::bind_method(D_METHOD("get_sensor_poll_hz", "sensor_id"), &LightSensorManager::get_sensor_poll_hz);
+    ClassDB::bind_method(D_METHOD("get_adaptive_sample_rate"), &LightSensorManager::get_adaptive_sample_rate);
     ClassDB::bind_method(D_METHOD("set_sample_radius", "radius"), &LightSensorManager::set_sample_radius);
     ClassDB::bind_method(D_METHOD("get_sample_radius"), &LightSensorManager::get_sample_radius);
     ClassDB::bind_method(D_METHOD("set_auto_update_screen_positions", "enabled"), &LightSensorManager::set_auto_update_screen_positions);
@@ -46,6 +93,42 @@ void LightSensorManager::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_use_direct_texture_access"), &LightSensorManager::get_use_direct_texture_access);
     ClassDB::bind_method(D_METHOD("set_force_gpu_mode", "force_gpu"), &LightSensorManager::set_force_gpu_mode);
     ClassDB::bind_method(D_METHOD("get_force_gpu_mode"), &LightSensorManager::get_force_gpu_mode);
+    ClassDB::bind_method(D_METHOD("set_use_prediction", "enabled"), &LightSensorManager::set_use_prediction);
+    ClassDB::bind_method(D_METHOD("get_use_prediction"), &LightSensorManager::get_use_prediction);
+    ClassDB::bind_method(D_METHOD("set_use_coherence_skip", "enabled"), &LightSensorManager::set_use_coherence_skip);
+    ClassDB::bind_method(D_METHOD("get_use_coherence_skip"), &LightSensorManager::get_use_coherence_skip);
+    ClassDB::bind_method(D_METHOD("set_use_region_dedup", "enabled"), &LightSensorManager::set_use_region_dedup);
+    ClassDB::bind_method(D_METHOD("get_use_region_dedup"), &LightSensorManager::get_use_region_dedup);
+    ClassDB::bind_method(D_METHOD("set_use_summed_area_table", "enabled"), &LightSensorManager::set_use_summed_area_table);
+    ClassDB::bind_method(D_METHOD("get_use_summed_area_table"), &LightSensorManager::get_use_summed_area_table);
+    ClassDB::bind_method(D_METHOD("set_use_linear_averaging", "enabled"), &LightSensorManager::set_use_linear_averaging);
+    ClassDB::bind_method(D_METHOD("get_use_linear_averaging"), &LightSensorManager::get_use_linear_averaging);
+    ClassDB::bind_method(D_METHOD("set_linear_color_output", "enabled"), &LightSensorManager::set_linear_color_output);
+    ClassDB::bind_method(D_METHOD("get_linear_color_output"), &LightSensorManager::get_linear_color_output);
+    ClassDB::bind_method(D_METHOD("get_coherence_stats"), &LightSensorManager::get_coherence_stats);
+    ClassDB::bind_method(D_METHOD("set_use_background_pipeline", "enabled"), &LightSensorManager::set_use_background_pipeline);
+    ClassDB::bind_method(D_METHOD("get_use_background_pipeline"), &LightSensorManager::get_use_background_pipeline);
+    ClassDB::bind_method(D_METHOD("get_pipeline_stats"), &LightSensorManager::get_pipeline_stats);
+    ClassDB::bind_method(D_METHOD("set_pipeline_depth", "depth"), &LightSensorManager::set_pipeline_depth);
+    ClassDB::bind_method(D_METHOD("get_pipeline_depth"), &LightSensorManager::get_pipeline_depth);
+    ClassDB::bind_method(D_METHOD("get_pipeline_graph"), &LightSensorManager::get_pipeline_graph);
+    ClassDB::bind_method(D_METHOD("get_allocation_stats"), &LightSensorManager::get_allocation_stats);
+    
+    // Shared-memory export
+    ClassDB::bind_method(D_METHOD("set_shared_memory_export", "enabled"), &LightSensorManager::set_shared_memory_export);
+    ClassDB::bind_method(D_METHOD("get_shared_memory_export"), &LightSensorManager::get_shared_memory_export);
+    ClassDB::bind_method(D_METHOD("set_shared_memory_name", "name"), &LightSensorManager::set_shared_memory_name);
+    ClassDB::bind_method(D_METHOD("get_shared_memory_name"), &LightSensorManager::get_shared_memory_name);
+    ClassDB::bind_method(D_METHOD("set_shared_memory_notify", "enabled"), &LightSensorManager::set_shared_memory_notify);
+    ClassDB::bind_method(D_METHOD("get_shared_memory_notify"), &LightSensorManager::get_shared_memory_notify);
+    ClassDB::bind_method(D_METHOD("is_shared_memory_export_active"), &LightSensorManager::is_shared_memory_export_active);
+    ClassDB::bind_method(D_METHOD("get_shared_memory_publish_count"), &LightSensorManager::get_shared_memory_publish_count);
+    
+    // Recording
+    ClassDB::bind_method(D_METHOD("start_recording", "path", "options"), &LightSensorManager::start_recording, DEFVAL(Dictionary()));
+    ClassDB::bind_method(D_METHOD("stop_recording"), &LightSensorManager::stop_recording);
+    ClassDB::bind_method(D_METHOD("is_recording"), &LightSensorManager::is_recording);
+    ClassDB::bind_method(D_METHOD("get_recording_stats"), &LightSensorManager::get_recording_stats);
     
     // Control
     ClassDB::bind_method(D_METHOD("start_sampling"), &LightSensorManager::start_sampling);
@@ -54,6 +137,8 @@ void LightSensorManager::_bind_methods() {
     
     // Manual updates
     ClassDB::bind_method(D_METHOD("force_update_all_sensors"), &LightSensorManager::force_update_all_sensors);
+    ClassDB::bind_method(D_METHOD("sample_async", "sensor_ids"), &LightSensorManager::sample_async, DEFVAL(PackedInt32Array()));
+    ClassDB::bind_method(D_METHOD("get_pending_request_count"), &LightSensorManager::get_pending_request_count);
     ClassDB::bind_method(D_METHOD("update_sensor_screen_position", "sensor_id", "screen_pos"), &LightSensorManager::update_sensor_screen_position);
     
     // Camera and viewport
@@ -61,6 +146,10 @@ void LightSensorManager::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_camera"), &LightSensorManager::get_camera);
     ClassDB::bind_method(D_METHOD("set_viewport", "viewport"), &LightSensorManager::set_viewport);
     ClassDB::bind_method(D_METHOD("get_viewport"), &LightSensorManager::get_viewport);
+    ClassDB::bind_method(D_METHOD("set_proxy_capture_scale", "scale"), &LightSensorManager::set_proxy_capture_scale);
+    ClassDB::bind_method(D_METHOD("get_proxy_capture_scale"), &LightSensorManager::get_proxy_capture_scale);
+    ClassDB::bind_method(D_METHOD("get_capture_viewport"), &LightSensorManager::get_capture_viewport);
+    ClassDB::bind_method(D_METHOD("get_capture_size"), &LightSensorManager::get_capture_size);
 }
 
 LightSensorManager::LightSensorManager() {
@@ -72,35 +161,95 @@ LightSensorManager::~LightSensorManager() {
     shutdown();
 }
 
+void LightSensorManager::_enter_tree() {
+    add_to_group(MANAGER_GROUP);
+}
+
 void LightSensorManager::_ready() {
     // Call parent's _ready() to ensure ready signal is emitted
     Node::_ready();
     
     // Create batch compute manager as a child node
     batch_compute_manager = memnew(BatchComputeManager);
+    batch_compute_manager->set_prefer_gpu_backend(use_gpu_acceleration);
+    batch_compute_manager->set_use_coherence_skip(use_coherence_skip);
+    batch_compute_manager->set_use_region_dedup(use_region_dedup);
+    batch_compute_manager->set_use_summed_area_table(use_summed_area_table);
+    batch_compute_manager->set_use_linear_averaging(use_linear_averaging);
+    batch_compute_manager->set_linear_color_output(linear_color_output);
+    batch_compute_manager->set_max_batches_in_flight(pipeline_depth);
     add_child(batch_compute_manager);
+    probe_field.set_owner(this);
     
     // Defer initialization to next frame to ensure viewport is available
     call_deferred("initialize");
 }
 
 void LightSensorManager::_process(double delta) {
-    if (!is_running.load() || !is_initialized.load()) {
+    if (!is_initialized.load()) {
+        return;
+    }
+    
+    // The proxy renders this frame from wherever the main camera is now
+    if (proxy_viewport) {
+        _sync_proxy_camera();
+    }
+    
+    // Deliver the batch the worker pool finished since the last frame. Idleness is read before
+    // the poll: a batch that finishes in between is delivered next frame instead of being
+    // taken for dropped.
+    const bool async_idle = batch_compute_manager && !batch_compute_manager->is_async_busy();
+    if (batch_compute_manager && batch_compute_manager->poll_async_results()) {
+        const uint64_t frame = batch_compute_manager->get_async_completed_frame();
+        const uint64_t ticket = batch_compute_manager->get_async_completed_ticket();
+        _emit_sensor_signals(frame, ticket);
+        _export_tick(frame);
+        // Only requests dispatched with this batch or an earlier one: later captures are still pending
+        _complete_requests(frame, ticket);
+    } else if (!dispatched_requests.empty() && async_idle) {
+        // The batch was dropped (capture failed or sensors changed while it ran): dispatch again
+        pending_requests.insert(pending_requests.end(), dispatched_requests.begin(), dispatched_requests.end());
+        dispatched_requests.clear();
+        dispatched_request_tickets.clear();
+    }
+    
+    if (!is_running.load()) {
+        // Stopped managers still serve sample_async() requests
+        if (!pending_requests.empty()) {
+            _process_sensors(use_background_pipeline);
+        }
         return;
     }
     
     time_since_last_update += delta;
+    size_t rate_due_count = 0;
+    if (use_adaptive_poll_rate) {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        rate_due_count = rate_controller.advance(delta, rate_due);
+    }
     
-    // Update screen positions if enabled
+    // Pick up the bound nodes that moved, then update screen positions if enabled
+    _sync_bound_positions();
     if (auto_update_screen_positions) {
         _update_screen_positions();
     }
     
-    // Process sensors if enough time has passed
-    if (time_since_last_update >= poll_interval) {
-        _process_sensors();
-        time_since_last_update = 0.0;
+    // Process sensors if enough time has passed, or right away when a request is waiting.
+    // With adaptive rates a tick where no sensor is due skips the readback.
+    const bool tick_due = time_since_last_update >= poll_interval && (!use_adaptive_poll_rate || rate_due_count > 0);
+    if (tick_due || !pending_requests.empty()) {
+        // A background batch still running defers the tick to the next frame.
+        // Requests want every sensor, so they lift the due mask.
+        if (_process_sensors(use_background_pipeline, use_adaptive_poll_rate && pending_requests.empty())) {
+            time_since_last_update = 0.0;
+        }
+    } else if (use_prediction && auto_update_screen_positions) {
+        // Cheap in-between update: no readback, only the retained snapshot is re-read
+        _predict_sensors();
     }
+    
+    // Probe faces run on their own budget, every frame
+    _process_probes();
 }
 
 void LightSensorManager::_exit_tree() {
@@ -134,17 +283,37 @@ bool LightSensorManager::initialize() {
     if (!camera && viewport) {
         camera = viewport->get_camera_3d();
     }
+    _connect_viewport_resize(viewport);
     
     is_initialized.store(true);
+    
+    // Sensor nodes that entered the tree before us
+    std::vector<LightSensorPoint3D*> queued_nodes;
+    {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        queued_nodes.swap(pending_sensor_nodes);
+    }
+    for (LightSensorPoint3D* node : queued_nodes) {
+        register_sensor_node(node);
+    }
     return true;
 }
 
 void LightSensorManager::shutdown() {
     if (!is_initialized.load()) {
+        // Queued sensor nodes must not keep pointing at a manager that is going away
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        _detach_sensor_nodes();
         return;
     }
     
     stop_sampling();
+    shm_exporter.close();
+    recorder.close();
+    _cancel_requests();
+    _disconnect_viewport_resize();
+    _release_proxy_viewport();
+    probe_field.release_rigs();
     
     if (batch_compute_manager) {
         batch_compute_manager->shutdown();
@@ -153,8 +322,11 @@ void LightSensorManager::shutdown() {
     }
     
     std::lock_guard<std::mutex> lock(sensor_mutex);
+    _detach_sensor_nodes();
     sensors.clear();
     sensor_id_to_index.clear();
+    rate_controller.clear();
+    probe_field.clear();
     
     is_initialized.store(false);
 }
@@ -178,6 +350,7 @@ int LightSensorManager::add_sensor(const Vector3& world_position, const String&
     sensors.emplace_back(sensor_id, world_position, metadata_label);
     sensors.back().screen_position = screen_pos;
     sensor_id_to_index[sensor_id] = static_cast<int>(sensors.size() - 1);
+    rate_controller.add();
     
     // Add to batch compute manager
     batch_compute_manager->add_sensor(sensor_id, screen_pos.x, screen_pos.y, sample_radius);
@@ -194,19 +367,31 @@ void LightSensorManager::remove_sensor(int sensor_id) {
     
     std::lock_guard<std::mutex> lock(sensor_mutex);
     
+    if (probe_field.remove_probe(sensor_id)) {
+        return;
+    }
+    
     auto it = sensor_id_to_index.find(sensor_id);
     if (it == sensor_id_to_index.end()) {
         return;
     }
     
     int index = it->second;
+    _release_bound_node(sensors[index]);
+    attachments.remove_sensor(sensor_id);
+    _erase_sensor_at(index);
+}
+
+void LightSensorManager::_erase_sensor_at(int index) {
+    const int sensor_id = sensors[index].sensor_id;
     
     // Remove from batch compute manager
     batch_compute_manager->remove_sensor(sensor_id);
     
     // Remove from internal storage
     sensors.erase(sensors.begin() + index);
-    sensor_id_to_index.erase(it);
+    sensor_id_to_index.erase(sensor_id);
+    rate_controller.remove(static_cast<size_t>(index));
     
     // Update indices for remaining sensors
     for (auto& pair : sensor_id_to_index) {
@@ -214,7 +399,6 @@ void LightSensorManager::remove_sensor(int sensor_id) {
             pair.second--;
         }
     }
-    
 }
 
 void LightSensorManager::clear_all_sensors() {
@@ -224,10 +408,331 @@ void LightSensorManager::clear_all_sensors() {
     
     std::lock_guard<std::mutex> lock(sensor_mutex);
     
+    _detach_sensor_nodes();
     batch_compute_manager->clear_all_sensors();
     sensors.clear();
     sensor_id_to_index.clear();
+    rate_controller.clear();
+    probe_field.clear();
+    
+}
+
+void LightSensorManager::register_sensor_node(LightSensorPoint3D* node) {
+    if (!node) {
+        return;
+    }
+    if (!is_initialized.load()) {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        pending_sensor_nodes.push_back(node);
+        return;
+    }
+    
+    const int sensor_id = add_sensor(node->get_global_position(), node->get_metadata_label());
+    if (sensor_id < 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        sensors[sensor_id_to_index[sensor_id]].bound_node = node;
+    }
+    node->set_manager_sensor_id(sensor_id);
+    if (node->get_sample_radius() > 0) {
+        set_sensor_sample_radius(sensor_id, node->get_sample_radius());
+    }
+}
+
+void LightSensorManager::unregister_sensor_node(LightSensorPoint3D* node) {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    
+    pending_sensor_nodes.erase(std::remove(pending_sensor_nodes.begin(), pending_sensor_nodes.end(), node), pending_sensor_nodes.end());
+    if (!is_initialized.load()) {
+        return;
+    }
+    auto it = sensor_id_to_index.find(node->get_sensor_id());
+    if (it != sensor_id_to_index.end() && sensors[it->second].bound_node == node) {
+        _erase_sensor_at(it->second);
+    }
+}
+
+void LightSensorManager::_detach_sensor_nodes() {
+    for (SensorInfo& sensor : sensors) {
+        _release_bound_node(sensor);
+    }
+    for (LightSensorPoint3D* node : pending_sensor_nodes) {
+        node->detach_from_manager();
+    }
+    pending_sensor_nodes.clear();
+    moved_sensor_ids.clear();
+    attachments.clear();
+}
+
+void LightSensorManager::_release_bound_node(SensorInfo& sensor) {
+    LightSensorPoint3D* node = sensor.bound_node;
+    if (!node) {
+        return;
+    }
+    sensor.bound_node = nullptr;
+    node->detach_from_manager();
+    if (node->is_manager_owned()) {
+        node->queue_free();
+    }
+}
+
+int LightSensorManager::add_node_sensor(Node3D* node, const Vector3& local_offset, const String& metadata_label) {
+    if (!is_initialized.load() || !node || !node->is_inside_tree()) {
+        return -1;
+    }
+    
+    LightSensorPoint3D* point = memnew(LightSensorPoint3D);
+    point->set_manager_override(this);
+    point->set_manager_owned(true);
+    point->set_metadata_label(metadata_label);
+    point->set_position(local_offset);
+    // Registers on entering the tree; internal, so it stays out of get_children() and saved scenes
+    node->add_child(point, false, Node::INTERNAL_MODE_BACK);
+    return point->get_sensor_id();
+}
+
+int LightSensorManager::get_last_moved_sensor_count() const {
+    return last_moved_sensor_count;
+}
+
+void LightSensorManager::mark_sensor_node_moved(LightSensorPoint3D* node) {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
     
+    auto it = sensor_id_to_index.find(node->get_sensor_id());
+    if (it == sensor_id_to_index.end()) {
+        return;
+    }
+    SensorInfo& sensor = sensors[it->second];
+    if (sensor.bound_node != node || sensor.position_dirty) {
+        return;
+    }
+    sensor.position_dirty = true;
+    moved_sensor_ids.push_back(sensor.sensor_id);
+}
+
+PackedInt32Array LightSensorManager::add_multimesh_sensors(MultiMeshInstance3D* node, const Vector3& local_offset, const PackedInt32Array& instances, const String& metadata_label) {
+    PackedInt32Array ids;
+    if (!is_initialized.load() || !node || !node->is_inside_tree()) {
+        return ids;
+    }
+    
+    std::vector<int32_t> elements;
+    if (instances.is_empty()) {
+        Ref<MultiMesh> multimesh = node->get_multimesh();
+        const int32_t count = multimesh.is_valid() ? multimesh->get_instance_count() : 0;
+        elements.resize(count > 0 ? static_cast<size_t>(count) : 0);
+        for (size_t i = 0; i < elements.size(); ++i) {
+            elements[i] = static_cast<int32_t>(i);
+        }
+    } else {
+        elements.assign(instances.ptr(), instances.ptr() + instances.size());
+    }
+    
+    // Same bulk read the per-tick sync uses, for the starting positions
+    const std::vector<Vector3> offsets(elements.size(), local_offset);
+    std::vector<Vector3> positions(elements.size());
+    std::vector<uint8_t> valid(elements.size());
+    if (!SensorAttachments::read_multimesh_positions(node, elements.data(), offsets.data(), elements.size(), positions.data(), valid.data())) {
+        return ids;
+    }
+    
+    std::vector<int32_t> attached_elements;
+    std::vector<int> attached_ids;
+    for (size_t k = 0; k < elements.size(); ++k) {
+        if (!valid[k]) {
+            continue;
+        }
+        const int sensor_id = add_sensor(positions[k], metadata_label);
+        if (sensor_id < 0) {
+            continue;
+        }
+        attached_elements.push_back(elements[k]);
+        attached_ids.push_back(sensor_id);
+        ids.push_back(sensor_id);
+    }
+    attachments.add_multimesh(node, attached_elements.data(), local_offset, attached_ids.data(), attached_ids.size());
+    return ids;
+}
+
+int LightSensorManager::add_bone_sensor(Skeleton3D* skeleton, const String& bone_name, const Vector3& local_offset, const String& metadata_label) {
+    if (!is_initialized.load() || !skeleton) {
+        return -1;
+    }
+    
+    const int32_t bone = skeleton->find_bone(bone_name);
+    Vector3 position;
+    if (!SensorAttachments::read_bone_position(skeleton, bone, local_offset, position)) {
+        return -1;
+    }
+    const int sensor_id = add_sensor(position, metadata_label);
+    if (sensor_id < 0) {
+        return -1;
+    }
+    
+    // Bones are only re-read after the skeleton reports a new pose
+    const Callable on_posed = callable_mp(this, &LightSensorManager::_on_attached_skeleton_updated).bind(skeleton->get_instance_id());
+    if (!skeleton->is_connected("skeleton_updated", on_posed)) {
+        skeleton->connect("skeleton_updated", on_posed);
+    }
+    attachments.add_bone(skeleton, bone, local_offset, sensor_id);
+    return sensor_id;
+}
+
+void LightSensorManager::_on_attached_skeleton_updated(uint64_t p_skeleton_id) {
+    attachments.mark_skeleton_posed(p_skeleton_id);
+}
+
+PackedInt32Array LightSensorManager::add_sensor_set(const Ref<LightSensorSet>& sensor_set, const String& group) {
+    PackedInt32Array ids;
+    if (!is_initialized.load() || sensor_set.is_null() || !sensor_set->is_valid()) {
+        return ids;
+    }
+    
+    const uint64_t start_usec = sensor_steady_usec();
+    const int group_filter = group.is_empty() ? -1 : sensor_set->find_group(group);
+    if (!group.is_empty() && group_filter < 0) {
+        return ids;
+    }
+    const size_t set_count = static_cast<size_t>(sensor_set->get_sensor_count());
+    const float* positions = sensor_set->get_position_column();
+    const uint32_t* labels = sensor_set->get_label_column();
+    const uint16_t* groups = sensor_set->get_group_column();
+    const uint8_t* radii = sensor_set->get_radius_column();
+    
+    // Camera matrices fetched once, as in the per-tick projection pass
+    Viewport* vp = viewport ? viewport : (camera ? camera->get_viewport() : nullptr);
+    const bool can_project = camera && vp && projection.setup(camera, vp->get_visible_rect().size);
+    
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    
+    // Selected rows, read straight from the packed columns
+    std::vector<uint32_t> rows;
+    rows.reserve(set_count);
+    projection_world.clear();
+    for (size_t i = 0; i < set_count; ++i) {
+        if (group_filter >= 0 && groups[i] != static_cast<uint16_t>(group_filter)) {
+            continue;
+        }
+        rows.push_back(static_cast<uint32_t>(i));
+        projection_world.emplace_back(positions[i * 3 + 0], positions[i * 3 + 1], positions[i * 3 + 2]);
+    }
+    const size_t count = rows.size();
+    projection_screen.assign(count, Vector2());
+    projection_visible.assign(count, 0);
+    if (can_project) {
+        projection.project_batch(projection_world.data(), count, projection_screen.data(), projection_visible.data());
+    }
+    
+    sensors.reserve(sensors.size() + count);
+    sensor_id_to_index.reserve(sensor_id_to_index.size() + count);
+    std::vector<SensorRegion> regions(count);
+    ids.resize(static_cast<int64_t>(count));
+    int32_t* ids_out = ids.ptrw();
+    for (size_t k = 0; k < count; ++k) {
+        const uint32_t row = rows[k];
+        const int sensor_id = next_sensor_id++;
+        sensors.emplace_back(sensor_id, projection_world[k], sensor_set->get_label(labels[row]));
+        SensorInfo& sensor = sensors.back();
+        sensor.screen_position = projection_screen[k];
+        sensor.on_screen = projection_visible[k] != 0;
+        sensor.sample_radius = radii[row];
+        sensor_id_to_index[sensor_id] = static_cast<int>(sensors.size() - 1);
+        rate_controller.add();
+        regions[k] = SensorRegion(sensor.screen_position.x, sensor.screen_position.y, _sensor_radius(sensor), sensor_id);
+        ids_out[k] = sensor_id;
+    }
+    
+    // Every id is new, so the sampler appends without add_sensor()'s per-sensor lookup
+    batch_compute_manager->append_sensor_regions(regions.data(), regions.size());
+    _resize_containers_if_needed();
+    
+    last_sensor_set_load_usec = sensor_steady_usec() - start_usec;
+    return ids;
+}
+
+int64_t LightSensorManager::get_last_sensor_set_load_usec() const {
+    return static_cast<int64_t>(last_sensor_set_load_usec);
+}
+
+void LightSensorManager::set_sensor_sample_radius(int sensor_id, int radius) {
+    if (!is_initialized.load()) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    
+    auto it = sensor_id_to_index.find(sensor_id);
+    if (it == sensor_id_to_index.end()) {
+        return;
+    }
+    SensorInfo& sensor = sensors[it->second];
+    sensor.sample_radius = Math::max(0, Math::min(radius, 16));
+    batch_compute_manager->add_sensor(sensor.sensor_id, sensor.screen_position.x, sensor.screen_position.y, _sensor_radius(sensor));
+}
+
+int LightSensorManager::_sensor_radius(const SensorInfo& sensor) const {
+    return sensor.sample_radius > 0 ? sensor.sample_radius : sample_radius;
+}
+
+Dictionary LightSensorManager::get_attachment_stats() const {
+    Dictionary stats;
+    stats["sources"] = attachments.get_source_count();
+    stats["sensors"] = attachments.get_sensor_count();
+    stats["last_fetches"] = attachments.get_last_fetch_count();
+    stats["last_moved"] = last_moved_sensor_count;
+    return stats;
+}
+
+void LightSensorManager::_move_bound_sensor(SensorInfo& sensor, const Vector3& world_position) {
+    sensor.world_position = world_position;
+    last_moved_sensor_count++;
+    if (!auto_update_screen_positions) {
+        // No projection pass this tick: project the moved sensors alone
+        const Vector2 screen_pos = _world_to_screen(world_position);
+        if (screen_pos != sensor.screen_position) {
+            sensor.screen_position = screen_pos;
+            batch_compute_manager->add_sensor(sensor.sensor_id, screen_pos.x, screen_pos.y, _sensor_radius(sensor));
+        }
+    }
+}
+
+void LightSensorManager::_sync_bound_positions() {
+    // Attached sources are engine reads: done before taking the lock
+    attachment_ids.clear();
+    attachment_positions.clear();
+    attachment_orphans.clear();
+    if (attachments.get_source_count() > 0) {
+        attachments.gather(attachment_ids, attachment_positions, attachment_orphans);
+    }
+    for (int sensor_id : attachment_orphans) {
+        remove_sensor(sensor_id);
+    }
+    
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    
+    last_moved_sensor_count = 0;
+    for (int sensor_id : moved_sensor_ids) {
+        auto it = sensor_id_to_index.find(sensor_id);
+        if (it == sensor_id_to_index.end()) {
+            continue; // Removed since it moved
+        }
+        SensorInfo& sensor = sensors[it->second];
+        if (!sensor.position_dirty || !sensor.bound_node) {
+            continue;
+        }
+        sensor.position_dirty = false;
+        _move_bound_sensor(sensor, sensor.bound_node->get_global_position());
+    }
+    moved_sensor_ids.clear();
+    
+    for (size_t k = 0; k < attachment_ids.size(); ++k) {
+        auto it = sensor_id_to_index.find(attachment_ids[k]);
+        if (it != sensor_id_to_index.end() && sensors[it->second].world_position != attachment_positions[k]) {
+            _move_bound_sensor(sensors[it->second], attachment_positions[k]);
+        }
+    }
 }
 
 int LightSensorManager::get_sensor_count() const {
@@ -238,6 +743,12 @@ int LightSensorManager::get_sensor_count() const {
 Color LightSensorManager::get_sensor_color(int sensor_id) const {
     std::lock_guard<std::mutex> lock(sensor_mutex);
     
+    if (probe_field.has_probe(sensor_id)) {
+        Color color(0, 0, 0, 1);
+        probe_field.get_probe_color(sensor_id, sensor_color_mode(use_linear_averaging, linear_color_output), color);
+        return color;
+    }
+    
     auto it = sensor_id_to_index.find(sensor_id);
     if (it != sensor_id_to_index.end() && it->second < static_cast<int>(sensors.size())) {
         return sensors[it->second].last_color;
@@ -246,9 +757,103 @@ Color LightSensorManager::get_sensor_color(int sensor_id) const {
     return Color(0, 0, 0, 1);
 }
 
+int LightSensorManager::add_probe_sensor(const Vector3& world_position, const String& metadata_label) {
+    if (!is_initialized.load()) {
+        return -1;
+    }
+    
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    const int sensor_id = next_sensor_id++;
+    probe_field.add_probe(sensor_id, world_position, metadata_label);
+    return sensor_id;
+}
+
+bool LightSensorManager::is_probe_sensor(int sensor_id) const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    return probe_field.has_probe(sensor_id);
+}
+
+PackedColorArray LightSensorManager::get_probe_face_colors(int sensor_id) const {
+    PackedColorArray faces;
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    Color colors[SensorProbeField::FACE_COUNT];
+    if (probe_field.get_probe_faces(sensor_id, sensor_color_mode(use_linear_averaging, linear_color_output), colors)) {
+        faces.resize(SensorProbeField::FACE_COUNT);
+        for (int f = 0; f < SensorProbeField::FACE_COUNT; ++f) {
+            faces.set(f, colors[f]);
+        }
+    }
+    return faces;
+}
+
+Color LightSensorManager::sample_probe_direction(int sensor_id, const Vector3& direction) const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    Color color(0, 0, 0, 1);
+    probe_field.sample_probe_direction(sensor_id, direction, sensor_color_mode(use_linear_averaging, linear_color_output), color);
+    return color;
+}
+
+void LightSensorManager::set_probe_cluster_size(float size) {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    probe_field.set_cluster_size(size);
+}
+
+float LightSensorManager::get_probe_cluster_size() const {
+    return probe_field.get_cluster_size();
+}
+
+void LightSensorManager::set_probe_face_resolution(int pixels) {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    probe_field.set_face_resolution(pixels);
+}
+
+int LightSensorManager::get_probe_face_resolution() const {
+    return probe_field.get_face_resolution();
+}
+
+void LightSensorManager::set_probe_faces_per_frame(int faces) {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    probe_field.set_faces_per_frame(faces);
+}
+
+int LightSensorManager::get_probe_faces_per_frame() const {
+    return probe_field.get_faces_per_frame();
+}
+
+void LightSensorManager::set_probe_far(float distance) {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    probe_field.set_far(Math::max(0.1f, distance));
+}
+
+float LightSensorManager::get_probe_far() const {
+    return probe_field.get_far();
+}
+
+Dictionary LightSensorManager::get_probe_stats() const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    Dictionary stats;
+    const int clusters = probe_field.get_cluster_count();
+    const int budget = probe_field.get_faces_per_frame();
+    stats["probes"] = probe_field.get_probe_count();
+    stats["clusters"] = clusters;
+    stats["faces_per_frame"] = budget;
+    // Frames between two captures of the same face
+    stats["cycle_frames"] = (clusters * SensorProbeField::FACE_COUNT + budget - 1) / budget;
+    stats["faces_captured"] = probe_field.get_faces_captured();
+    stats["faces_dropped"] = probe_field.get_faces_dropped();
+    return stats;
+}
+
 Vector3 LightSensorManager::get_sensor_position(int sensor_id) const {
     std::lock_guard<std::mutex> lock(sensor_mutex);
     
+    Vector3 probe_position;
+    String probe_label;
+    uint64_t probe_frame = 0;
+    if (probe_field.get_probe_info(sensor_id, probe_position, probe_label, probe_frame)) {
+        return probe_position;
+    }
+    
     auto it = sensor_id_to_index.find(sensor_id);
     if (it != sensor_id_to_index.end() && it->second < static_cast<int>(sensors.size())) {
         return sensors[it->second].world_position;
@@ -283,6 +888,25 @@ Dictionary LightSensorManager::get_sensor_data(int sensor_id) const {
     Dictionary data;
     
     std::lock_guard<std::mutex> lock(sensor_mutex);
+    
+    Vector3 probe_position;
+    String probe_label;
+    uint64_t probe_frame = 0;
+    if (probe_field.get_probe_info(sensor_id, probe_position, probe_label, probe_frame)) {
+        const SensorColorMode mode = sensor_color_mode(use_linear_averaging, linear_color_output);
+        Color color(0, 0, 0, 1);
+        const bool captured = probe_field.get_probe_color(sensor_id, mode, color);
+        data["sensor_id"] = sensor_id;
+        data["world_position"] = probe_position;
+        data["color"] = color;
+        data["metadata_label"] = probe_label;
+        data["is_active"] = true;
+        data["probe"] = true;
+        data["captured"] = captured;
+        data["frame"] = probe_frame;
+        return data;
+    }
+    
     auto it = sensor_id_to_index.find(sensor_id);
     if (it != sensor_id_to_index.end() && it->second < static_cast<int>(sensors.size())) {
         const SensorInfo& sensor = sensors[it->second];
@@ -292,6 +916,10 @@ Dictionary LightSensorManager::get_sensor_data(int sensor_id) const {
         data["color"] = sensor.last_color;
         data["metadata_label"] = sensor.metadata_label;
         data["is_active"] = sensor.is_active;
+        data["on_screen"] = sensor.on_screen;
+        data["predicted"] = sensor.is_predicted;
+        data["sample_radius"] = _sensor_radius(sensor);
+        data["poll_hz"] = use_adaptive_poll_rate ? rate_controller.get_rate(static_cast<size_t>(it->second)) : 1.0 / poll_interval;
     }
     
     return data;
@@ -309,25 +937,105 @@ Array LightSensorManager::get_all_sensor_data() const {
         data["color"] = sensor.last_color;
         data["metadata_label"] = sensor.metadata_label;
         data["is_active"] = sensor.is_active;
+        data["on_screen"] = sensor.on_screen;
+        data["predicted"] = sensor.is_predicted;
+        data["sample_radius"] = _sensor_radius(sensor);
         result.append(data);
     }
     
     return result;
 }
 
+bool LightSensorManager::is_sensor_predicted(int sensor_id) const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    
+    auto it = sensor_id_to_index.find(sensor_id);
+    if (it != sensor_id_to_index.end() && it->second < static_cast<int>(sensors.size())) {
+        return sensors[it->second].is_predicted;
+    }
+    
+    return false;
+}
+
 void LightSensorManager::set_poll_hz(double hz) {
     poll_interval = Math::max(0.01, 1.0 / Math::max(1.0, hz));
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    // The poll rate is the adaptive ceiling
+    rate_controller.set_ceiling_hz(1.0 / poll_interval);
 }
 
 double LightSensorManager::get_poll_hz() const {
     return 1.0 / poll_interval;
 }
 
+void LightSensorManager::set_use_adaptive_poll_rate(bool enabled) {
+    use_adaptive_poll_rate = enabled;
+}
+
+bool LightSensorManager::get_use_adaptive_poll_rate() const {
+    return use_adaptive_poll_rate;
+}
+
+void LightSensorManager::set_adaptive_min_hz(double hz) {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    rate_controller.set_floor_hz(Math::min(hz, 1.0 / poll_interval));
+}
+
+double LightSensorManager::get_adaptive_min_hz() const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    return rate_controller.get_floor_hz();
+}
+
+void LightSensorManager::set_adaptive_sample_budget(double samples_per_second) {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    rate_controller.set_sample_budget(samples_per_second);
+}
+
+double LightSensorManager::get_adaptive_sample_budget() const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    return rate_controller.get_sample_budget();
+}
+
+void LightSensorManager::set_adaptive_volatility_scale(float scale) {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    rate_controller.set_volatility_scale(scale);
+}
+
+float LightSensorManager::get_adaptive_volatility_scale() const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    return rate_controller.get_volatility_scale();
+}
+
+double LightSensorManager::get_sensor_poll_hz(int sensor_id) const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    
+    auto it = sensor_id_to_index.find(sensor_id);
+    if (it == sensor_id_to_index.end()) {
+        return 0.0;
+    }
+    return use_adaptive_poll_rate ? rate_controller.get_rate(static_cast<size_t>(it->second)) : 1.0 / poll_interval;
+}
+
+double LightSensorManager::get_adaptive_sample_rate() const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    if (!use_adaptive_poll_rate) {
+        return static_cast<double>(sensors.size()) / poll_interval;
+    }
+    return rate_controller.get_total_rate();
+}
+
 void LightSensorManager::set_sample_radius(int radius) {
     sample_radius = Math::max(1, Math::min(radius, 16));
     
     if (batch_compute_manager) {
         batch_compute_manager->set_sample_radius(sample_radius);
+        // That reset every region: put the sensors with a radius of their own back
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        for (const SensorInfo& sensor : sensors) {
+            if (sensor.sample_radius > 0) {
+                batch_compute_manager->add_sensor(sensor.sensor_id, sensor.screen_position.x, sensor.screen_position.y, sensor.sample_radius);
+            }
+        }
     }
 }
 
@@ -345,6 +1053,11 @@ bool LightSensorManager::get_auto_update_screen_positions() const {
 
 void LightSensorManager::set_use_gpu_acceleration(bool enabled) {
     use_gpu_acceleration = enabled;
+    
+    // Disabling GPU acceleration routes batches through the CPU snapshot backend
+    if (batch_compute_manager) {
+        batch_compute_manager->set_prefer_gpu_backend(enabled);
+    }
 }
 
 bool LightSensorManager::get_use_gpu_acceleration() const {
@@ -377,6 +1090,205 @@ bool LightSensorManager::get_force_gpu_mode() const {
     return false;
 }
 
+void LightSensorManager::set_use_prediction(bool enabled) {
+    use_prediction = enabled;
+}
+
+bool LightSensorManager::get_use_prediction() const {
+    return use_prediction;
+}
+
+void LightSensorManager::set_use_coherence_skip(bool enabled) {
+    use_coherence_skip = enabled;
+    if (batch_compute_manager) {
+        batch_compute_manager->set_use_coherence_skip(enabled);
+    }
+}
+
+bool LightSensorManager::get_use_coherence_skip() const {
+    return use_coherence_skip;
+}
+
+void LightSensorManager::set_use_region_dedup(bool enabled) {
+    use_region_dedup = enabled;
+    if (batch_compute_manager) {
+        batch_compute_manager->set_use_region_dedup(enabled);
+    }
+}
+
+bool LightSensorManager::get_use_region_dedup() const {
+    return use_region_dedup;
+}
+
+void LightSensorManager::set_use_summed_area_table(bool enabled) {
+    use_summed_area_table = enabled;
+    if (batch_compute_manager) {
+        batch_compute_manager->set_use_summed_area_table(enabled);
+    }
+}
+
+bool LightSensorManager::get_use_summed_area_table() const {
+    return use_summed_area_table;
+}
+
+void LightSensorManager::set_use_linear_averaging(bool enabled) {
+    use_linear_averaging = enabled;
+    if (batch_compute_manager) {
+        batch_compute_manager->set_use_linear_averaging(enabled);
+    }
+}
+
+bool LightSensorManager::get_use_linear_averaging() const {
+    return use_linear_averaging;
+}
+
+void LightSensorManager::set_linear_color_output(bool enabled) {
+    linear_color_output = enabled;
+    if (batch_compute_manager) {
+        batch_compute_manager->set_linear_color_output(enabled);
+    }
+}
+
+bool LightSensorManager::get_linear_color_output() const {
+    return linear_color_output;
+}
+
+void LightSensorManager::set_use_background_pipeline(bool enabled) {
+    use_background_pipeline = enabled;
+}
+
+bool LightSensorManager::get_use_background_pipeline() const {
+    return use_background_pipeline;
+}
+
+Dictionary LightSensorManager::get_pipeline_stats() const {
+    if (batch_compute_manager) {
+        return batch_compute_manager->get_async_stats();
+    }
+    return Dictionary();
+}
+
+void LightSensorManager::set_pipeline_depth(int depth) {
+    pipeline_depth = Math::max(1, Math::min(depth, 2));
+    if (batch_compute_manager) {
+        batch_compute_manager->set_max_batches_in_flight(pipeline_depth);
+    }
+}
+
+int LightSensorManager::get_pipeline_depth() const {
+    return pipeline_depth;
+}
+
+Dictionary LightSensorManager::get_pipeline_graph() const {
+    if (batch_compute_manager) {
+        return batch_compute_manager->get_pipeline_graph();
+    }
+    return Dictionary();
+}
+
+Dictionary LightSensorManager::get_allocation_stats() const {
+    if (batch_compute_manager) {
+        return batch_compute_manager->get_allocation_stats();
+    }
+    return Dictionary();
+}
+
+Dictionary LightSensorManager::get_coherence_stats() const {
+    if (batch_compute_manager) {
+        return batch_compute_manager->get_coherence_stats();
+    }
+    return Dictionary();
+}
+
+void LightSensorManager::set_shared_memory_export(bool enabled) {
+    shm_export_enabled = enabled;
+    if (!enabled) {
+        shm_exporter.close();
+    }
+    // Opened lazily on the next measured tick, sized for the sensors present then
+}
+
+bool LightSensorManager::get_shared_memory_export() const {
+    return shm_export_enabled;
+}
+
+void LightSensorManager::set_shared_memory_name(const String& name) {
+    if (name == shm_export_name) {
+        return;
+    }
+    shm_export_name = name;
+    shm_exporter.close();
+}
+
+String LightSensorManager::get_shared_memory_name() const {
+    return shm_export_name;
+}
+
+void LightSensorManager::set_shared_memory_notify(bool enabled) {
+    if (enabled == shm_export_notify) {
+        return;
+    }
+    shm_export_notify = enabled;
+    shm_exporter.close();
+}
+
+bool LightSensorManager::get_shared_memory_notify() const {
+    return shm_export_notify;
+}
+
+bool LightSensorManager::is_shared_memory_export_active() const {
+    return shm_exporter.is_open();
+}
+
+uint64_t LightSensorManager::get_shared_memory_publish_count() const {
+    return shm_exporter.get_publish_count();
+}
+
+bool LightSensorManager::start_recording(const String& path, const Dictionary& options) {
+    SensorRecorder::Options recorder_options;
+    recorder_options.chunk_ticks = static_cast<uint32_t>(Math::max(1, static_cast<int>(options.get("chunk_ticks", 30))));
+    recorder_options.delta = options.get("delta", true);
+    recorder_options.max_pending_chunks = static_cast<uint32_t>(Math::max(1, static_cast<int>(options.get("max_pending_chunks", 8))));
+    
+    const String compression = options.get("compression", "fastlz");
+    if (compression == "none") {
+        recorder_options.codec = RECORDING_CODEC_NONE;
+    } else if (compression == "deflate") {
+        recorder_options.codec = RECORDING_CODEC_DEFLATE;
+    } else if (compression == "zstd") {
+        recorder_options.codec = RECORDING_CODEC_ZSTD;
+    } else if (compression == "fastlz") {
+        recorder_options.codec = RECORDING_CODEC_FASTLZ;
+    } else {
+        UtilityFunctions::push_error("[LightSensorManager] Unknown recording compression '", compression, "'");
+        return false;
+    }
+    
+    const String os_path = ProjectSettings::get_singleton()->globalize_path(path);
+    if (!recorder.open(os_path.utf8().get_data(), recorder_options)) {
+        UtilityFunctions::push_error("[LightSensorManager] Cannot start recording: ", String(recorder.get_last_error().c_str()));
+        return false;
+    }
+    return true;
+}
+
+void LightSensorManager::stop_recording() {
+    recorder.close();
+}
+
+bool LightSensorManager::is_recording() const {
+    return recorder.is_open();
+}
+
+Dictionary LightSensorManager::get_recording_stats() const {
+    Dictionary stats;
+    stats["ticks_recorded"] = recorder.get_ticks_recorded();
+    stats["ticks_dropped"] = recorder.get_ticks_dropped();
+    stats["chunks_written"] = recorder.get_chunks_written();
+    stats["bytes_written"] = recorder.get_bytes_written();
+    return stats;
+}
+
 void LightSensorManager::start_sampling() {
     if (!is_initialized.load()) {
         return;
@@ -400,7 +1312,8 @@ void LightSensorManager::force_update_all_sensors() {
         return;
     }
     
-    _process_sensors();
+    // Blocking by contract: sample and deliver before returning
+    _process_sensors(false);
 }
 
 void LightSensorManager::update_sensor_screen_position(int sensor_id, const Vector2& screen_pos) {
@@ -413,7 +1326,7 @@ void LightSensorManager::update_sensor_screen_position(int sensor_id, const Vect
     auto it = sensor_id_to_index.find(sensor_id);
     if (it != sensor_id_to_index.end() && it->second < static_cast<int>(sensors.size())) {
         sensors[it->second].screen_position = screen_pos;
-        batch_compute_manager->add_sensor(sensor_id, screen_pos.x, screen_pos.y, sample_radius);
+        batch_compute_manager->add_sensor(sensor_id, screen_pos.x, screen_pos.y, _sensor_radius(sensors[it->second]));
     }
 }
 
@@ -430,6 +1343,7 @@ void LightSensorManager::set_viewport(Viewport* vp) {
     
     // If we have a batch compute manager and it's initialized, update the viewport cache
     if (batch_compute_manager && is_initialized.load()) {
+        _connect_viewport_resize(vp);
         if (vp) {
             // Force update the viewport cache
             _update_viewport_cache();
@@ -441,24 +1355,150 @@ Viewport* LightSensorManager::get_viewport() const {
     return viewport;
 }
 
-void LightSensorManager::_process_sensors() {
+bool LightSensorManager::_process_sensors(bool allow_async, bool p_adaptive) {
     if (!is_initialized.load() || !batch_compute_manager) {
-        return;
+        return true;
     }
     
     // Update viewport cache
     if (!_update_viewport_cache()) {
         // If no viewport is available, we can't process sensors yet
+        return true;
+    }
+    
+    if (!batch_compute_manager->is_available()) {
+        return true;
+    }
+    
+    // Sensors not due keep their last sample (CPU snapshot path) and are not re-delivered
+    {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        if (p_adaptive) {
+            rate_dispatched_due = rate_due;
+        } else {
+            rate_dispatched_due.clear();
+        }
+        batch_compute_manager->set_region_due_mask(rate_dispatched_due);
+        rate_dispatched_generation = batch_compute_manager->get_region_layout_generation();
+    }
+    
+    // Background pipeline: only the readback happens here, results arrive via
+    // poll_async_results() on a later frame
+    if (allow_async && batch_compute_manager->supports_async()) {
+        if (!batch_compute_manager->submit_sensors_async(cached_viewport_texture)) {
+            return false;
+        }
+        const uint64_t ticket = batch_compute_manager->get_async_submitted_ticket();
+        {
+            std::lock_guard<std::mutex> lock(sensor_mutex);
+            const int slot = static_cast<int>(ticket % RATE_BATCH_SLOTS);
+            rate_batch_ticket[slot] = ticket;
+            rate_batch_due[slot].assign(rate_dispatched_due.begin(), rate_dispatched_due.end());
+            rate_batch_generation[slot] = rate_dispatched_generation;
+        }
+        _mark_rate_dispatched();
+        // Waiting requests ride this batch
+        _dispatch_pending_requests(ticket);
+        return true;
+    }
+    
+    // Process sensors using batch compute manager (GPU or CPU snapshot backend)
+    if (batch_compute_manager->process_sensors(cached_viewport_texture)) {
+        _mark_rate_dispatched();
+        const uint64_t frame = Engine::get_singleton()->get_process_frames();
+        _emit_sensor_signals(frame);
+        _export_tick(frame);
+        _dispatch_pending_requests(0);
+        _complete_requests(frame);
+    }
+    return true;
+}
+
+void LightSensorManager::_mark_rate_dispatched() {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    rate_controller.mark_dispatched(rate_dispatched_due);
+}
+
+void LightSensorManager::_dispatch_pending_requests(uint64_t p_ticket) {
+    for (Ref<LightSensorRequest>& request : pending_requests) {
+        dispatched_requests.push_back(request);
+        dispatched_request_tickets.push_back(p_ticket);
+    }
+    pending_requests.clear();
+}
+
+Ref<LightSensorRequest> LightSensorManager::sample_async(const PackedInt32Array& sensor_ids) {
+    Ref<LightSensorRequest> request;
+    request.instantiate();
+    request->setup(sensor_ids);
+    
+    if (!is_initialized.load()) {
+        // Nothing will ever serve it; completing here would fire before the caller can await
+        request->call_deferred("cancel");
+        return request;
+    }
+    
+    pending_requests.push_back(request);
+    return request;
+}
+
+int LightSensorManager::get_pending_request_count() const {
+    return static_cast<int>(pending_requests.size() + dispatched_requests.size());
+}
+
+void LightSensorManager::_complete_requests(uint64_t frame, uint64_t p_ticket) {
+    if (dispatched_requests.empty()) {
         return;
     }
     
-    // Process sensors using batch compute manager
-    if (use_gpu_acceleration && batch_compute_manager->is_available()) {
-        if (batch_compute_manager->process_sensors(cached_viewport_texture)) {
-            _emit_sensor_signals();
+    // Swap out first: completion handlers may issue new requests. Requests riding a batch
+    // still in flight (pipeline depth 2) stay dispatched.
+    std::vector<Ref<LightSensorRequest>> completing;
+    size_t kept = 0;
+    for (size_t i = 0; i < dispatched_requests.size(); ++i) {
+        if (dispatched_request_tickets[i] <= p_ticket) {
+            completing.push_back(dispatched_requests[i]);
         } else {
+            dispatched_requests[kept] = dispatched_requests[i];
+            dispatched_request_tickets[kept] = dispatched_request_tickets[i];
+            kept++;
         }
-    } else {
+    }
+    dispatched_requests.resize(kept);
+    dispatched_request_tickets.resize(kept);
+    
+    for (Ref<LightSensorRequest>& request : completing) {
+        Dictionary results;
+        {
+            std::lock_guard<std::mutex> lock(sensor_mutex);
+            const PackedInt32Array ids = request->get_sensor_ids();
+            if (ids.is_empty()) {
+                for (const SensorInfo& sensor : sensors) {
+                    results[sensor.sensor_id] = sensor.last_color;
+                }
+            } else {
+                // Unknown or removed ids are left out
+                for (int64_t i = 0; i < ids.size(); ++i) {
+                    const int index = _find_sensor_index(ids[i]);
+                    if (index >= 0) {
+                        results[ids[i]] = sensors[index].last_color;
+                    }
+                }
+            }
+        }
+        request->complete(results, frame);
+    }
+}
+
+void LightSensorManager::_cancel_requests() {
+    std::vector<Ref<LightSensorRequest>> cancelling;
+    cancelling.swap(dispatched_requests);
+    dispatched_request_tickets.clear();
+    cancelling.insert(cancelling.end(), pending_requests.begin(), pending_requests.end());
+    pending_requests.clear();
+    
+    for (Ref<LightSensorRequest>& request : cancelling) {
+        request->cancel();
     }
 }
 
@@ -467,45 +1507,337 @@ bool LightSensorManager::_update_viewport_cache() {
         return false;
     }
     
-    // Get new viewport texture
-    cached_viewport_texture = viewport->get_texture();
+    // Get new viewport texture (the proxy's when one is configured)
+    Viewport* capture_viewport = _update_proxy_viewport();
+    cached_viewport_texture = capture_viewport ? capture_viewport->get_texture() : Ref<ViewportTexture>();
     if (cached_viewport_texture.is_null()) {
         return false;
     }
     
+    // Sensor positions are in visible-rect coordinates; the batch maps them onto the image
+    batch_compute_manager->set_region_space_size(viewport->get_visible_rect().size);
     return true;
 }
 
+void LightSensorManager::_connect_viewport_resize(Viewport* vp) {
+    const uint64_t id = vp ? vp->get_instance_id() : 0;
+    if (id == resize_viewport_id) {
+        return;
+    }
+    _disconnect_viewport_resize();
+    if (!vp) {
+        return;
+    }
+    
+    vp->connect("size_changed", callable_mp(this, &LightSensorManager::_on_viewport_size_changed));
+    resize_viewport_id = id;
+    viewport_size = vp->get_visible_rect().size;
+}
+
+void LightSensorManager::_disconnect_viewport_resize() {
+    // The viewport may already be gone; look it up rather than trusting the raw pointer
+    Viewport* vp = Object::cast_to<Viewport>(ObjectDB::get_instance(resize_viewport_id));
+    if (vp) {
+        const Callable callback = callable_mp(this, &LightSensorManager::_on_viewport_size_changed);
+        if (vp->is_connected("size_changed", callback)) {
+            vp->disconnect("size_changed", callback);
+        }
+    }
+    resize_viewport_id = 0;
+}
+
+void LightSensorManager::_on_viewport_size_changed() {
+    Viewport* vp = Object::cast_to<Viewport>(ObjectDB::get_instance(resize_viewport_id));
+    if (!vp || !batch_compute_manager) {
+        return;
+    }
+    
+    const Vector2 new_size = vp->get_visible_rect().size;
+    if (new_size == viewport_size || new_size.x <= 0.0f || new_size.y <= 0.0f) {
+        return;
+    }
+    
+    // Carry stored positions across the resize so manual positions and the prediction
+    // baseline stay on the same scene point instead of clamping at the old edge
+    if (viewport_size.x > 0.0f && viewport_size.y > 0.0f) {
+        const Vector2 scale = new_size / viewport_size;
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        for (SensorInfo& sensor : sensors) {
+            sensor.screen_position *= scale;
+            sensor.sampled_screen_position *= scale;
+            batch_compute_manager->add_sensor(sensor.sensor_id, sensor.screen_position.x, sensor.screen_position.y, _sensor_radius(sensor));
+        }
+    }
+    
+    Vector2i texture_size(static_cast<int32_t>(new_size.x), static_cast<int32_t>(new_size.y));
+    // The proxy follows the main viewport's new size; its pixel size is what gets captured
+    Viewport* capture_viewport = vp == viewport ? _update_proxy_viewport() : vp;
+    Ref<ViewportTexture> tex = capture_viewport ? capture_viewport->get_texture() : Ref<ViewportTexture>();
+    if (tex.is_valid()) {
+        texture_size = Vector2i(tex->get_width(), tex->get_height());
+    }
+    batch_compute_manager->notify_viewport_resized(new_size, texture_size);
+    viewport_size = new_size;
+}
+
+void LightSensorManager::set_proxy_capture_scale(float scale) {
+    proxy_capture_scale = scale > 0.0f ? std::clamp(scale, 0.05f, 1.0f) : 0.0f;
+    if (is_initialized.load() && batch_compute_manager) {
+        _update_viewport_cache();
+    }
+}
+
+float LightSensorManager::get_proxy_capture_scale() const {
+    return proxy_capture_scale;
+}
+
+Viewport* LightSensorManager::get_capture_viewport() const {
+    return proxy_viewport ? proxy_viewport : viewport;
+}
+
+Vector2i LightSensorManager::get_capture_size() const {
+    if (proxy_viewport) {
+        return proxy_viewport->get_size();
+    }
+    if (viewport) {
+        const Vector2 size = viewport->get_visible_rect().size;
+        return Vector2i(static_cast<int32_t>(size.x), static_cast<int32_t>(size.y));
+    }
+    return Vector2i();
+}
+
+Viewport* LightSensorManager::_update_proxy_viewport() {
+    if (proxy_capture_scale <= 0.0f || !viewport) {
+        _release_proxy_viewport();
+        return viewport;
+    }
+    
+    if (!proxy_viewport) {
+        proxy_viewport = memnew(SubViewport);
+        proxy_viewport->set_name("LightSensorProxyViewport");
+        // Sensors need coarse light, not image quality: no AA, aggressive LOD, no input
+        proxy_viewport->set_msaa_3d(Viewport::MSAA_DISABLED);
+        proxy_viewport->set_screen_space_aa(Viewport::SCREEN_SPACE_AA_DISABLED);
+        proxy_viewport->set_use_taa(false);
+        proxy_viewport->set_use_debanding(false);
+        proxy_viewport->set_mesh_lod_threshold(8.0f);
+        proxy_viewport->set_disable_input(true);
+        // Not displayed anywhere, so it has to be told to render
+        proxy_viewport->set_update_mode(SubViewport::UPDATE_ALWAYS);
+        proxy_camera = memnew(Camera3D);
+        proxy_viewport->add_child(proxy_camera);
+        add_child(proxy_viewport);
+        proxy_camera->set_current(true);
+    }
+    
+    // Same world as the main viewport: same lights, environment and geometry
+    Ref<World3D> world = viewport->find_world_3d();
+    if (proxy_viewport->get_world_3d() != world) {
+        proxy_viewport->set_world_3d(world);
+    }
+    
+    const Vector2 main_size = viewport->get_visible_rect().size;
+    const Vector2i proxy_size(std::max<int32_t>(1, static_cast<int32_t>(std::lround(main_size.x * proxy_capture_scale))),
+            std::max<int32_t>(1, static_cast<int32_t>(std::lround(main_size.y * proxy_capture_scale))));
+    if (proxy_viewport->get_size() != proxy_size) {
+        proxy_viewport->set_size(proxy_size);
+    }
+    _sync_proxy_camera();
+    return proxy_viewport;
+}
+
+void LightSensorManager::_sync_proxy_camera() {
+    Camera3D* source = camera ? camera : (viewport ? viewport->get_camera_3d() : nullptr);
+    if (!proxy_camera || !source || !source->is_inside_tree()) {
+        return;
+    }
+    
+    // Same view and projection, so main-viewport screen positions land on the same scene points
+    proxy_camera->set_global_transform(source->get_global_transform());
+    proxy_camera->set_projection(source->get_projection());
+    proxy_camera->set_keep_aspect_mode(source->get_keep_aspect_mode());
+    proxy_camera->set_fov(source->get_fov());
+    proxy_camera->set_size(source->get_size());
+    proxy_camera->set_frustum_offset(source->get_frustum_offset());
+    proxy_camera->set_h_offset(source->get_h_offset());
+    proxy_camera->set_v_offset(source->get_v_offset());
+    proxy_camera->set_near(source->get_near());
+    proxy_camera->set_far(source->get_far());
+    proxy_camera->set_cull_mask(source->get_cull_mask());
+    proxy_camera->set_environment(source->get_environment());
+    proxy_camera->set_attributes(source->get_attributes());
+}
+
+void LightSensorManager::_release_proxy_viewport() {
+    if (!proxy_viewport) {
+        return;
+    }
+    proxy_viewport->queue_free(); // Frees the proxy camera with it
+    proxy_viewport = nullptr;
+    proxy_camera = nullptr;
+}
+
 void LightSensorManager::_update_screen_positions() {
     if (!camera || !is_initialized.load()) {
         return;
     }
     
+    // Fetch the camera matrices once and project every sensor in one pass
+    Viewport *vp = viewport ? viewport : camera->get_viewport();
+    if (!vp || !projection.setup(camera, vp->get_visible_rect().size)) {
+        return;
+    }
+    
     std::lock_guard<std::mutex> lock(sensor_mutex);
     
-    for (auto& sensor : sensors) {
-        Vector2 new_screen_pos = _world_to_screen(sensor.world_position);
+    const size_t count = sensors.size();
+    projection_world.resize(count);
+    projection_screen.resize(count);
+    projection_visible.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        projection_world[i] = sensors[i].world_position;
+        projection_screen[i] = sensors[i].screen_position;
+    }
+    projection.project_batch(projection_world.data(), count, projection_screen.data(), projection_visible.data());
+    
+    for (size_t i = 0; i < count; ++i) {
+        SensorInfo &sensor = sensors[i];
+        sensor.on_screen = projection_visible[i] != 0;
+        const Vector2 &new_screen_pos = projection_screen[i];
         if (new_screen_pos != sensor.screen_position) {
             sensor.screen_position = new_screen_pos;
-            batch_compute_manager->add_sensor(sensor.sensor_id, new_screen_pos.x, new_screen_pos.y, sample_radius);
+            batch_compute_manager->add_sensor(sensor.sensor_id, new_screen_pos.x, new_screen_pos.y, _sensor_radius(sensor));
         }
     }
 }
 
-void LightSensorManager::_emit_sensor_signals() {
-    if (!batch_compute_manager) {
+void LightSensorManager::_predict_sensors() {
+    if (!batch_compute_manager || !batch_compute_manager->has_snapshot()) {
+        return; // Needs a CPU-side snapshot (CPU backend or Metal fallback path)
+    }
+    
+    bool any_predicted = false;
+    const uint64_t frame = Engine::get_singleton()->get_process_frames();
+    {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        
+        // Only sensors whose projection moved since their last read need re-reading
+        prediction_indices.clear();
+        prediction_centers.clear();
+        prediction_radii.clear();
+        for (size_t i = 0; i < sensors.size(); ++i) {
+            const SensorInfo& sensor = sensors[i];
+            if (sensor.on_screen && sensor.screen_position != sensor.sampled_screen_position) {
+                prediction_indices.push_back(i);
+                prediction_centers.push_back(sensor.screen_position);
+                // The radius the real tick samples this sensor with, so the two readings agree
+                prediction_radii.push_back(_sensor_radius(sensor));
+            }
+        }
+        if (prediction_indices.empty()) {
+            return;
+        }
+        
+        // A worker ingesting the next snapshot holds it; predict again next frame instead of waiting
+        prediction_colors.resize(prediction_indices.size());
+        if (!batch_compute_manager->try_sample_snapshot_batch(prediction_centers.data(), prediction_radii.data(), prediction_centers.size(), prediction_colors.data())) {
+            return;
+        }
+        
+        for (size_t k = 0; k < prediction_indices.size(); ++k) {
+            SensorInfo& sensor = sensors[prediction_indices[k]];
+            const Color& predicted = prediction_colors[k];
+            sensor.sampled_screen_position = sensor.screen_position;
+            sensor.is_predicted = true;
+            any_predicted = true;
+            if (sensor.bound_node) {
+                sensor.bound_node->apply_manager_reading(predicted, frame);
+            }
+            if (sensor.last_color != predicted) {
+                sensor.last_color = predicted;
+                _emit_sensor_updated_signal(sensor.sensor_id, predicted);
+            }
+        }
+    }
+    
+    if (any_predicted) {
+        emit_signal("sensors_predicted");
+    }
+}
+
+void LightSensorManager::_process_probes() {
+    if (!viewport || probe_field.get_probe_count() == 0) {
         return;
     }
     
-    Array results_array = batch_compute_manager->get_all_results();
-    std::vector<Color> results;
-    for (int i = 0; i < results_array.size(); ++i) {
-        results.push_back(results_array[i]);
+    const SensorColorMode mode = sensor_color_mode(use_linear_averaging, linear_color_output);
+    probe_updated_ids.clear();
+    {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        probe_field.tick(viewport->find_world_3d(), Engine::get_singleton()->get_process_frames(), probe_updated_ids);
+        for (int sensor_id : probe_updated_ids) {
+            Color color;
+            if (probe_field.get_probe_color(sensor_id, mode, color)) {
+                _emit_sensor_updated_signal(sensor_id, color);
+            }
+        }
+    }
+    
+    if (!probe_updated_ids.empty()) {
+        emit_signal("probes_updated");
+    }
+}
+
+void LightSensorManager::_emit_sensor_signals(uint64_t p_frame, uint64_t p_ticket) {
+    if (!batch_compute_manager) {
+        return;
     }
     
+    // Straight copy into retained storage instead of round-tripping through a Variant Array
+    batch_compute_manager->copy_results(emit_results);
+    const std::vector<Color>& results = emit_results;
+    const uint64_t layout_generation = batch_compute_manager->get_region_layout_generation();
+    
     std::lock_guard<std::mutex> lock(sensor_mutex);
     
+    // A batch restricted to the due sensors only delivers those. Batches that finished
+    // before this one without being installed hand their due sensors to it: held regions
+    // carry the samples those batches took.
+    bool masked = true;
+    bool matched = p_ticket == 0;
+    if (p_ticket == 0) {
+        // Synchronous batch: the mask it was dispatched with
+        rate_apply_due.assign(rate_dispatched_due.begin(), rate_dispatched_due.end());
+        masked = rate_apply_due.size() == sensors.size() && rate_dispatched_generation == layout_generation;
+    } else {
+        rate_apply_due.assign(sensors.size(), 0);
+    }
+    for (int slot = 0; slot < RATE_BATCH_SLOTS && p_ticket > 0; ++slot) {
+        if (rate_batch_ticket[slot] == 0 || rate_batch_ticket[slot] > p_ticket) {
+            continue;
+        }
+        const std::vector<uint8_t>& due = rate_batch_due[slot];
+        matched = true;
+        if (due.size() != sensors.size() || rate_batch_generation[slot] != layout_generation) {
+            masked = false; // Unmasked batch, or the sensors changed since (even to the same count)
+        } else {
+            for (size_t i = 0; i < due.size(); ++i) {
+                rate_apply_due[i] |= due[i];
+            }
+        }
+        rate_batch_ticket[slot] = 0;
+    }
+    masked = masked && matched;
     for (size_t i = 0; i < sensors.size() && i < results.size(); ++i) {
+        if (masked && !rate_apply_due[i]) {
+            continue;
+        }
+        rate_controller.observe(i, results[i]);
+        sensors[i].is_predicted = false;
+        sensors[i].sampled_screen_position = sensors[i].screen_position;
+        if (sensors[i].bound_node) {
+            sensors[i].bound_node->apply_manager_reading(results[i], p_frame);
+        }
         if (sensors[i].last_color != results[i]) {
             sensors[i].last_color = results[i];
             _emit_sensor_updated_signal(sensors[i].sensor_id, results[i]);
@@ -515,6 +1847,61 @@ void LightSensorManager::_emit_sensor_signals() {
     emit_signal("all_sensors_updated");
 }
 
+void LightSensorManager::_export_tick(uint64_t frame) {
+    if (!shm_export_enabled && !recorder.is_open()) {
+        return;
+    }
+    
+    // Pack the measured tick once for every consumer
+    {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        const size_t count = sensors.size();
+        export_ids.resize(count);
+        export_colors.resize(count * 4);
+        export_luminance.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            const Color& c = sensors[i].last_color;
+            export_ids[i] = sensors[i].sensor_id;
+            export_colors[i * 4 + 0] = c.r;
+            export_colors[i * 4 + 1] = c.g;
+            export_colors[i * 4 + 2] = c.b;
+            export_colors[i * 4 + 3] = c.a;
+            export_luminance[i] = 0.299f * c.r + 0.587f * c.g + 0.114f * c.b;
+        }
+    }
+    
+    if (recorder.is_open()) {
+        const uint64_t timestamp_usec = sensor_steady_usec();
+        recorder.append_tick(frame, timestamp_usec, export_ids.data(), export_colors.data(), export_luminance.data(), static_cast<uint32_t>(export_ids.size()));
+    }
+    if (shm_export_enabled) {
+        _publish_shared_memory(frame);
+    }
+}
+
+void LightSensorManager::_publish_shared_memory(uint64_t frame) {
+
+    // (Re)create the segment on first use or when the sensor count outgrows it. Readers see
+    // LSS_SHM_FLAG_CLOSED on the old segment and reopen by name.
+    const uint32_t count = static_cast<uint32_t>(export_ids.size());
+    if (!shm_exporter.is_open() || count > shm_exporter.get_capacity()) {
+        uint32_t capacity = 256;
+        while (capacity < count) {
+            capacity *= 2;
+        }
+        if (!shm_exporter.open(shm_export_name.utf8().get_data(), capacity, 4, shm_export_notify)) {
+            UtilityFunctions::push_error("[LightSensorManager] Shared memory export disabled: ", String(shm_exporter.get_last_error().c_str()));
+            shm_export_enabled = false;
+            return;
+        }
+        if (!shm_exporter.get_last_error().empty()) {
+            UtilityFunctions::push_warning("[LightSensorManager] Shared memory notification unavailable: ", String(shm_exporter.get_last_error().c_str()));
+        }
+    }
+    
+    shm_exporter.publish(frame, export_ids.data(), export_colors.data(), export_luminance.data(), count);
+}
+
 int LightSensorManager::_find_sensor_index(int sensor_id) const {
     auto it = sensor_id_to_index.find(sensor_id);
     return (it != sensor_id_to_index.end()) ? it->second : -1;
@@ -2,18 +2,33 @@
 #define LIGHT_SENSOR_MANAGER_H
 
 #include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/classes/node3d.hpp>
+#include <godot_cpp/classes/multi_mesh_instance3d.hpp>
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/godot.hpp>
 #include <godot_cpp/variant/color.hpp>
 #include <godot_cpp/variant/vector2.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
 #include <godot_cpp/variant/vector3.hpp>
 #include <godot_cpp/variant/string.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/packed_color_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
 #include <godot_cpp/classes/viewport.hpp>
 #include <godot_cpp/classes/camera3d.hpp>
+#include <godot_cpp/classes/sub_viewport.hpp>
 #include <godot_cpp/classes/viewport_texture.hpp>
 
+#include "light_sensor_request.h"
+#include "light_sensor_set.h"
+#include "sensor_attachments.h"
+#include "sensor_probe_field.h"
+#include "sensor_projection.h"
+#include "sensor_rate_controller.h"
+#include "sensor_shm_exporter.h"
+#include "sensor_recorder.h"
+
 #include <vector>
 #include <unordered_map>
 #include <memory>
@@ -23,6 +38,7 @@
 // Forward declaration
 namespace godot {
 class BatchComputeManager;
+class LightSensorPoint3D;
 }
 
 namespace godot {
@@ -35,11 +51,17 @@ struct SensorInfo {
     Color last_color;
     double last_update_time;
     bool is_active;
+    bool on_screen; // Result of the last projection pass
+    bool is_predicted; // last_color was re-read from the previous snapshot, not measured
+    Vector2 sampled_screen_position; // Where last_color was read (measured or predicted)
     String metadata_label;
+    LightSensorPoint3D* bound_node; // Node fed by this sensor's readings; unregisters itself on exit
+    bool position_dirty; // bound_node moved; world_position is refreshed on the next tick
+    int sample_radius; // 0: the manager's sample_radius
     
-    SensorInfo() : sensor_id(0), last_color(Color(0, 0, 0, 1)), last_update_time(0.0), is_active(false) {}
+    SensorInfo() : sensor_id(0), last_color(Color(0, 0, 0, 1)), last_update_time(0.0), is_active(false), on_screen(false), is_predicted(false), bound_node(nullptr), position_dirty(false), sample_radius(0) {}
     SensorInfo(int id, const Vector3& pos, const String& label) 
-        : sensor_id(id), world_position(pos), last_color(Color(0, 0, 0, 1)), last_update_time(0.0), is_active(true), metadata_label(label) {}
+        : sensor_id(id), world_position(pos), last_color(Color(0, 0, 0, 1)), last_update_time(0.0), is_active(true), on_screen(false), is_predicted(false), metadata_label(label), bound_node(nullptr), position_dirty(false), sample_radius(0) {}
 };
 
 class LightSensorManager : public Node {
@@ -58,12 +80,76 @@ private:
     double poll_interval = 1.0 / 30.0; // 30 Hz default
     double time_since_last_update = 0.0;
     
+    // Adaptive poll rates: each sensor is sampled between adaptive_min_hz and the poll rate
+    // depending on how volatile its readings are. Ticks still run on poll_interval, but only
+    // sensors that are due are sampled, and a tick with none due skips the readback entirely.
+    // Slots mirror `sensors`; guarded by sensor_mutex.
+    SensorRateController rate_controller;
+    bool use_adaptive_poll_rate = false;
+    std::vector<uint8_t> rate_due;
+    std::vector<uint8_t> rate_dispatched_due; // Mask of the last dispatch; empty: all sensors
+    // Region layout each mask was built for (BatchComputeManager::get_region_layout_generation).
+    // A mask from another layout indexes different sensors and is not applied.
+    uint64_t rate_dispatched_generation = 0;
+    // Masks of the background batches in flight, by ticket (at most two run at once)
+    static constexpr int RATE_BATCH_SLOTS = 2;
+    std::vector<uint8_t> rate_batch_due[RATE_BATCH_SLOTS];
+    uint64_t rate_batch_ticket[RATE_BATCH_SLOTS] = {};
+    uint64_t rate_batch_generation[RATE_BATCH_SLOTS] = {};
+    std::vector<uint8_t> rate_apply_due; // Scratch: sensors a delivered batch updates
+    
+    // LightSensorPoint3D nodes that entered the tree before initialize(); registered by it.
+    // Guarded by sensor_mutex.
+    std::vector<LightSensorPoint3D*> pending_sensor_nodes;
+    // Ids of node-bound sensors whose node moved since the last tick (position_dirty set).
+    // Static sensors never get here, so the per-tick sync only costs the moved ones.
+    std::vector<int> moved_sensor_ids;
+    int last_moved_sensor_count = 0;
+    // Sensors on MultiMesh instances and skeleton bones, read back in bulk once per tick (main thread only)
+    SensorAttachments attachments;
+    std::vector<int> attachment_ids;
+    std::vector<Vector3> attachment_positions;
+    std::vector<int> attachment_orphans;
+    
+    uint64_t last_sensor_set_load_usec = 0;
+    
     // Viewport and camera
     Viewport* viewport = nullptr;
     Camera3D* camera = nullptr;
     Ref<ViewportTexture> cached_viewport_texture;
     uint64_t last_frame_id = 0;
     
+    // Optional low-resolution proxy: a SubViewport sharing the main world and camera, rendered at
+    // proxy_capture_scale of the main resolution and read back in place of the main viewport.
+    // Both nodes are children of this manager.
+    float proxy_capture_scale = 0.0f; // 0: read the main viewport
+    SubViewport* proxy_viewport = nullptr;
+    Camera3D* proxy_camera = nullptr;
+    
+    // Viewport whose size_changed signal we follow, and its visible size at the last resize
+    uint64_t resize_viewport_id = 0;
+    Vector2 viewport_size;
+    
+    // Batched projection scratch (reused every tick)
+    SensorProjection projection;
+    std::vector<Vector3> projection_world;
+    std::vector<Vector2> projection_screen;
+    std::vector<uint8_t> projection_visible;
+    
+    // Results of the last batch, copied out for signal emission
+    std::vector<Color> emit_results;
+    
+    // Omnidirectional probe sensors: clustered cube captures on a round-robin render budget.
+    // Shares the sensor id space; guarded by sensor_mutex.
+    SensorProbeField probe_field;
+    std::vector<int> probe_updated_ids;
+    
+    // Prediction scratch
+    std::vector<size_t> prediction_indices;
+    std::vector<Vector2> prediction_centers;
+    std::vector<int> prediction_radii;
+    std::vector<Color> prediction_colors;
+    
     // State
     std::atomic<bool> is_running{false};
     std::atomic<bool> is_initialized{false};
@@ -73,15 +159,53 @@ private:
     int sample_radius = 4;
     bool auto_update_screen_positions = true;
     bool use_gpu_acceleration = true;
+    // Between real samples, re-read the last snapshot at each sensor's newly projected position
+    bool use_prediction = false;
+    // Skip sensors whose region and snapshot tiles are unchanged since their last sample
+    bool use_coherence_skip = true;
+    // Sample each distinct quantized region once per tick and share the result
+    bool use_region_dedup = true;
+    bool use_summed_area_table = false;
+    // Average in linear light (sRGB decoded per pixel); re-encode results unless linear_color_output
+    bool use_linear_averaging = true;
+    bool linear_color_output = false;
+    // Ingest and sample on the worker pool; results are delivered one frame later
+    bool use_background_pipeline = true;
+    // Background batches in flight at once; 2 overlaps a tick's readback with the previous sampling
+    int pipeline_depth = 1;
+    
+    // Shared-memory export of every measured tick for external processes (sensor_shm_layout.h)
+    SensorShmExporter shm_exporter;
+    bool shm_export_enabled = false;
+    bool shm_export_notify = true;
+    String shm_export_name = LSS_SHM_DEFAULT_NAME;
+    
+    // Columnar on-disk recording of every measured tick (sensor_recording_format.h)
+    SensorRecorder recorder;
+    
+    // sample_async() requests waiting for the next dispatch, and those riding the batch in flight.
+    // Every request made before a dispatch is coalesced into that one capture.
+    std::vector<Ref<LightSensorRequest>> pending_requests;
+    std::vector<Ref<LightSensorRequest>> dispatched_requests;
+    std::vector<uint64_t> dispatched_request_tickets; // Batch each dispatched request rides
+    
+    // Packed arrays of the last measured tick, shared by the exporters
+    std::vector<int32_t> export_ids;
+    std::vector<float> export_colors;
+    std::vector<float> export_luminance;
 
 protected:
     static void _bind_methods();
 
 public:
+    // Group every manager joins on entering the tree; LightSensorPoint3D looks managers up by it
+    static constexpr const char* MANAGER_GROUP = "light_sensor_managers";
+    
     LightSensorManager();
     ~LightSensorManager();
 
     // Lifecycle
+    void _enter_tree() override;
     void _ready() override;
     void _process(double delta) override;
     void _exit_tree() override;
@@ -93,9 +217,41 @@ public:
     
     // Sensor management
     int add_sensor(const Vector3& world_position, const String& metadata_label = "");
+    // Probe sensors read light from all directions at their position, whether or not the
+    // camera sees it. remove_sensor(), get_sensor_color() and get_sensor_data() accept their ids.
+    int add_probe_sensor(const Vector3& world_position, const String& metadata_label = "");
+    bool is_probe_sensor(int sensor_id) const;
     void remove_sensor(int sensor_id);
     void clear_all_sensors();
     int get_sensor_count() const;
+    // Sensor that follows `node` at `local_offset` in its space, through a LightSensorPoint3D
+    // added as an internal child. The child is freed when the sensor is removed.
+    int add_node_sensor(Node3D* node, const Vector3& local_offset = Vector3(), const String& metadata_label = "");
+    // Node-bound sensors whose world position was refreshed on the last tick
+    int get_last_moved_sensor_count() const;
+    // One sensor per MultiMesh instance (every instance when `instances` is empty), at
+    // `local_offset` in the instance's space. Returns the ids in the order of the instances;
+    // instances out of range are skipped. The sensors are removed when the node is freed.
+    PackedInt32Array add_multimesh_sensors(MultiMeshInstance3D* node, const Vector3& local_offset = Vector3(), const PackedInt32Array& instances = PackedInt32Array(), const String& metadata_label = "");
+    // Sensor at `local_offset` in the space of a Skeleton3D bone; -1 for an unknown bone.
+    // Removed when the skeleton is freed.
+    int add_bone_sensor(Skeleton3D* skeleton, const String& bone_name, const Vector3& local_offset = Vector3(), const String& metadata_label = "");
+    Dictionary get_attachment_stats() const;
+    // Adds every sensor of a baked LightSensorSet (only those in `group` when it is not empty)
+    // in one bulk pass: one lock, one projection pass and one append to the sampler's regions.
+    // Returns the new ids in set order.
+    PackedInt32Array add_sensor_set(const Ref<LightSensorSet>& sensor_set, const String& group = "");
+    // Duration of the last add_sensor_set() in microseconds
+    int64_t get_last_sensor_set_load_usec() const;
+    // Per-sensor sample radius in pixels; 0 returns the sensor to the manager's sample_radius
+    void set_sensor_sample_radius(int sensor_id, int radius);
+    
+    // Lightweight sensor nodes (C++ only): LightSensorPoint3D calls these on entering and
+    // leaving the tree. The node's sensor gets its readings written straight into the node.
+    void register_sensor_node(LightSensorPoint3D* node);
+    void unregister_sensor_node(LightSensorPoint3D* node);
+    // The node's transform changed; its sensor picks the new position up on the next tick
+    void mark_sensor_node_moved(LightSensorPoint3D* node);
     
     // Sensor data access
     Color get_sensor_color(int sensor_id) const;
@@ -104,10 +260,39 @@ public:
     String get_sensor_metadata(int sensor_id) const;
     Dictionary get_sensor_data(int sensor_id) const;
     Array get_all_sensor_data() const;
+    // Face means (+X, -X, +Y, -Y, +Z, -Z); empty until the probe's cluster was fully captured
+    PackedColorArray get_probe_face_colors(int sensor_id) const;
+    // Light arriving from a world-space direction, blended from the faces
+    Color sample_probe_direction(int sensor_id, const Vector3& direction) const;
+    
+    // Probe capture settings
+    void set_probe_cluster_size(float size);
+    float get_probe_cluster_size() const;
+    void set_probe_face_resolution(int pixels);
+    int get_probe_face_resolution() const;
+    void set_probe_faces_per_frame(int faces);
+    int get_probe_faces_per_frame() const;
+    void set_probe_far(float distance);
+    float get_probe_far() const;
+    Dictionary get_probe_stats() const;
+    bool is_sensor_predicted(int sensor_id) const;
     
     // Configuration
     void set_poll_hz(double hz);
     double get_poll_hz() const;
+    void set_use_adaptive_poll_rate(bool enabled);
+    bool get_use_adaptive_poll_rate() const;
+    void set_adaptive_min_hz(double hz);
+    double get_adaptive_min_hz() const;
+    // Samples per second across all sensors; 0: unlimited
+    void set_adaptive_sample_budget(double samples_per_second);
+    double get_adaptive_sample_budget() const;
+    void set_adaptive_volatility_scale(float scale);
+    float get_adaptive_volatility_scale() const;
+    // Effective rate of one sensor (the poll rate when adaptive rates are off)
+    double get_sensor_poll_hz(int sensor_id) const;
+    // Sum of the effective rates of all sensors
+    double get_adaptive_sample_rate() const;
     void set_sample_radius(int radius);
     int get_sample_radius() const;
     void set_auto_update_screen_positions(bool enabled);
@@ -119,6 +304,42 @@ public:
     
     void set_force_gpu_mode(bool force_gpu);
     bool get_force_gpu_mode() const;
+    void set_use_prediction(bool enabled);
+    bool get_use_prediction() const;
+    void set_use_coherence_skip(bool enabled);
+    bool get_use_coherence_skip() const;
+    void set_use_region_dedup(bool enabled);
+    bool get_use_region_dedup() const;
+    void set_use_summed_area_table(bool enabled);
+    bool get_use_summed_area_table() const;
+    void set_use_linear_averaging(bool enabled);
+    bool get_use_linear_averaging() const;
+    void set_linear_color_output(bool enabled);
+    bool get_linear_color_output() const;
+    Dictionary get_coherence_stats() const;
+    void set_use_background_pipeline(bool enabled);
+    bool get_use_background_pipeline() const;
+    Dictionary get_pipeline_stats() const;
+    void set_pipeline_depth(int depth);
+    int get_pipeline_depth() const;
+    Dictionary get_pipeline_graph() const;
+    Dictionary get_allocation_stats() const;
+    
+    // Shared-memory export
+    void set_shared_memory_export(bool enabled);
+    bool get_shared_memory_export() const;
+    void set_shared_memory_name(const String& name);
+    String get_shared_memory_name() const;
+    void set_shared_memory_notify(bool enabled);
+    bool get_shared_memory_notify() const;
+    bool is_shared_memory_export_active() const;
+    uint64_t get_shared_memory_publish_count() const;
+    
+    // Recording
+    bool start_recording(const String& path, const Dictionary& options = Dictionary());
+    void stop_recording();
+    bool is_recording() const;
+    Dictionary get_recording_stats() const;
     
     // Control
     void start_sampling();
@@ -127,6 +348,10 @@ public:
     
     // Manual updates
     void force_update_all_sensors();
+    // Non-blocking: the returned request emits `completed` once a capture taken after this
+    // call has been sampled. An empty id list requests every sensor.
+    Ref<LightSensorRequest> sample_async(const PackedInt32Array& sensor_ids = PackedInt32Array());
+    int get_pending_request_count() const;
     void update_sensor_screen_position(int sensor_id, const Vector2& screen_pos);
     
     // Camera and viewport
@@ -134,13 +359,51 @@ public:
     Camera3D* get_camera() const;
     void set_viewport(Viewport* vp);
     Viewport* get_viewport() const;
+    
+    // Proxy capture: 0 disables, otherwise a fraction of the main resolution (e.g. 0.25)
+    void set_proxy_capture_scale(float scale);
+    float get_proxy_capture_scale() const;
+    // The viewport actually read back (the proxy when enabled) and its pixel size
+    Viewport* get_capture_viewport() const;
+    Vector2i get_capture_size() const;
 
 private:
     // Internal processing
-    void _process_sensors();
+    // Returns false when a background batch is still running and nothing was started
+    // p_adaptive restricts the batch to the sensors rate_controller marked due
+    bool _process_sensors(bool allow_async, bool p_adaptive = false);
+    void _mark_rate_dispatched();
+    // Sensor erase shared by remove_sensor() and unregister_sensor_node(); sensor_mutex held
+    void _erase_sensor_at(int index);
+    // Forgets every bound and queued sensor node; sensor_mutex held
+    void _detach_sensor_nodes();
+    // Unbinds the node and frees it when the manager created it; sensor_mutex held
+    void _release_bound_node(SensorInfo& sensor);
+    // Refreshes the world positions of node-bound sensors that moved and of attached sensors, in one pass
+    void _sync_bound_positions();
+    // sensor_mutex held
+    void _move_bound_sensor(SensorInfo& sensor, const Vector3& world_position);
+    int _sensor_radius(const SensorInfo& sensor) const;
     bool _update_viewport_cache();
+    // Creates, resizes or releases the proxy as configured; returns the viewport to read back
+    Viewport* _update_proxy_viewport();
+    void _sync_proxy_camera();
+    void _release_proxy_viewport();
+    void _connect_viewport_resize(Viewport* vp);
+    void _disconnect_viewport_resize();
+    void _on_viewport_size_changed();
+    void _on_attached_skeleton_updated(uint64_t p_skeleton_id);
     void _update_screen_positions();
-    void _emit_sensor_signals();
+    void _predict_sensors();
+    void _process_probes();
+    // p_frame: capture frame of the batch; p_ticket: background batch being delivered, 0 for a synchronous batch
+    void _emit_sensor_signals(uint64_t p_frame, uint64_t p_ticket = 0);
+    void _export_tick(uint64_t frame);
+    void _publish_shared_memory(uint64_t frame);
+    // Completes the requests riding batches up to p_ticket
+    void _complete_requests(uint64_t frame, uint64_t p_ticket = UINT64_MAX);
+    void _dispatch_pending_requests(uint64_t p_ticket);
+    void _cancel_requests();
     
     // Utility methods
     int _find_sensor_index(int sensor_id) const;
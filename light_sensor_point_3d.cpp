@@ -0,0 +1,199 @@
+#include "light_sensor_point_3d.h"
+#include "light_sensor_manager.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/core/object.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+
+#include <algorithm>
+
+using namespace godot;
+
+void LightSensorPoint3D::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("get_color"), &LightSensorPoint3D::get_color);
+    ClassDB::bind_method(D_METHOD("get_light_level"), &LightSensorPoint3D::get_light_level);
+    ADD_PROPERTY(PropertyInfo(Variant::COLOR, "color"), "", "get_color");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "light_level"), "", "get_light_level");
+
+    ClassDB::bind_method(D_METHOD("set_manager_path", "path"), &LightSensorPoint3D::set_manager_path);
+    ClassDB::bind_method(D_METHOD("get_manager_path"), &LightSensorPoint3D::get_manager_path);
+    ClassDB::bind_method(D_METHOD("set_metadata_label", "label"), &LightSensorPoint3D::set_metadata_label);
+    ClassDB::bind_method(D_METHOD("get_metadata_label"), &LightSensorPoint3D::get_metadata_label);
+    ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "manager_path", PROPERTY_HINT_NODE_PATH_VALID_TYPES, "LightSensorManager"), "set_manager_path", "get_manager_path");
+    ADD_PROPERTY(PropertyInfo(Variant::STRING, "metadata_label"), "set_metadata_label", "get_metadata_label");
+    ClassDB::bind_method(D_METHOD("set_track_transform", "enabled"), &LightSensorPoint3D::set_track_transform);
+    ClassDB::bind_method(D_METHOD("get_track_transform"), &LightSensorPoint3D::get_track_transform);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "track_transform"), "set_track_transform", "get_track_transform");
+    ClassDB::bind_method(D_METHOD("set_sample_radius", "radius"), &LightSensorPoint3D::set_sample_radius);
+    ClassDB::bind_method(D_METHOD("get_sample_radius"), &LightSensorPoint3D::get_sample_radius);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "sample_radius", PROPERTY_HINT_RANGE, "0,16"), "set_sample_radius", "get_sample_radius");
+
+    ClassDB::bind_method(D_METHOD("get_reading_frame"), &LightSensorPoint3D::get_reading_frame);
+    ClassDB::bind_method(D_METHOD("has_valid_reading"), &LightSensorPoint3D::has_valid_reading);
+    ClassDB::bind_method(D_METHOD("get_sensor_id"), &LightSensorPoint3D::get_sensor_id);
+    ClassDB::bind_method(D_METHOD("get_manager"), &LightSensorPoint3D::get_manager);
+}
+
+LightSensorPoint3D::LightSensorPoint3D() {
+}
+
+LightSensorPoint3D::~LightSensorPoint3D() {
+    _unregister();
+}
+
+void LightSensorPoint3D::_notification(int p_what) {
+    switch (p_what) {
+        case NOTIFICATION_ENTER_TREE:
+            set_notify_transform(track_transform);
+            _register();
+            break;
+        case NOTIFICATION_TRANSFORM_CHANGED:
+            if (manager && sensor_id >= 0) {
+                manager->mark_sensor_node_moved(this);
+            }
+            break;
+        case NOTIFICATION_READY:
+            // A manager later in the tree order had not entered yet; every node of the
+            // scene has by the time the first ready notification goes out
+            if (!manager) {
+                _register();
+            }
+            break;
+        case NOTIFICATION_EXIT_TREE:
+            _unregister();
+            break;
+        default:
+            break;
+    }
+}
+
+void LightSensorPoint3D::set_manager_path(const NodePath &p_path) {
+    manager_path = p_path;
+    if (is_inside_tree()) {
+        _unregister();
+        _register();
+    }
+}
+
+NodePath LightSensorPoint3D::get_manager_path() const {
+    return manager_path;
+}
+
+void LightSensorPoint3D::set_metadata_label(const String &p_label) {
+    metadata_label = p_label;
+}
+
+String LightSensorPoint3D::get_metadata_label() const {
+    return metadata_label;
+}
+
+void LightSensorPoint3D::set_track_transform(bool p_enabled) {
+    track_transform = p_enabled;
+    set_notify_transform(p_enabled);
+    if (p_enabled && manager && sensor_id >= 0) {
+        manager->mark_sensor_node_moved(this); // It may have moved while untracked
+    }
+}
+
+bool LightSensorPoint3D::get_track_transform() const {
+    return track_transform;
+}
+
+void LightSensorPoint3D::set_sample_radius(int p_radius) {
+    sample_radius = std::max(0, std::min(p_radius, 16));
+    if (manager && sensor_id >= 0) {
+        manager->set_sensor_sample_radius(sensor_id, sample_radius);
+    }
+}
+
+int LightSensorPoint3D::get_sample_radius() const {
+    return sample_radius;
+}
+
+Color LightSensorPoint3D::get_color() const {
+    return current_color;
+}
+
+float LightSensorPoint3D::get_light_level() const {
+    return current_light_level;
+}
+
+uint64_t LightSensorPoint3D::get_reading_frame() const {
+    return reading_frame;
+}
+
+bool LightSensorPoint3D::has_valid_reading() const {
+    return has_reading;
+}
+
+int LightSensorPoint3D::get_sensor_id() const {
+    return sensor_id;
+}
+
+LightSensorManager *LightSensorPoint3D::get_manager() const {
+    return manager;
+}
+
+void LightSensorPoint3D::set_manager_override(LightSensorManager *p_manager) {
+    manager_override_id = p_manager ? p_manager->get_instance_id() : 0;
+}
+
+void LightSensorPoint3D::set_manager_owned(bool p_owned) {
+    manager_owned = p_owned;
+}
+
+bool LightSensorPoint3D::is_manager_owned() const {
+    return manager_owned;
+}
+
+void LightSensorPoint3D::set_manager_sensor_id(int p_sensor_id) {
+    sensor_id = p_sensor_id;
+}
+
+void LightSensorPoint3D::apply_manager_reading(const Color &p_color, uint64_t p_frame) {
+    current_color = p_color;
+    current_light_level = 0.299f * p_color.r + 0.587f * p_color.g + 0.114f * p_color.b;
+    reading_frame = p_frame;
+    has_reading = true;
+}
+
+void LightSensorPoint3D::detach_from_manager() {
+    manager = nullptr;
+    sensor_id = -1;
+}
+
+LightSensorManager *LightSensorPoint3D::_find_manager() const {
+    if (manager_override_id != 0) {
+        return Object::cast_to<LightSensorManager>(ObjectDB::get_instance(manager_override_id));
+    }
+    if (!manager_path.is_empty()) {
+        return Object::cast_to<LightSensorManager>(get_node_or_null(manager_path));
+    }
+    for (Node *node = get_parent(); node; node = node->get_parent()) {
+        if (LightSensorManager *found = Object::cast_to<LightSensorManager>(node)) {
+            return found;
+        }
+    }
+    SceneTree *tree = get_tree();
+    return tree ? Object::cast_to<LightSensorManager>(tree->get_first_node_in_group(LightSensorManager::MANAGER_GROUP)) : nullptr;
+}
+
+void LightSensorPoint3D::_register() {
+    if (manager || !is_inside_tree()) {
+        return;
+    }
+    LightSensorManager *found = _find_manager();
+    if (!found) {
+        return;
+    }
+    manager = found;
+    // Queued when the manager has not initialized yet; the id arrives through set_manager_sensor_id()
+    manager->register_sensor_node(this);
+}
+
+void LightSensorPoint3D::_unregister() {
+    if (!manager) {
+        return;
+    }
+    manager->unregister_sensor_node(this);
+    detach_from_manager();
+}
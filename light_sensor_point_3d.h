@@ -0,0 +1,90 @@
+#ifndef LIGHT_SENSOR_POINT_3D_H
+#define LIGHT_SENSOR_POINT_3D_H
+
+#include <godot_cpp/classes/node3d.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/godot.hpp>
+#include <godot_cpp/variant/color.hpp>
+#include <godot_cpp/variant/node_path.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+#include <cstdint>
+
+namespace godot {
+
+class LightSensorManager;
+
+// Scene-tree sensor without per-frame callbacks. It never overrides _process, so Godot
+// makes no per-node call into the extension each frame. On entering the tree it registers
+// a sensor with a LightSensorManager (manager_path, else the nearest ancestor manager, else
+// the first manager in the scene) and the manager writes the readings straight into it
+// while publishing each batch. With track_transform the node asks Godot for transform-change
+// notifications and flags its sensor when it moves; the manager refreshes flagged positions
+// once per tick, so nodes that stay put cost nothing.
+class LightSensorPoint3D : public Node3D {
+    GDCLASS(LightSensorPoint3D, Node3D);
+
+private:
+    NodePath manager_path;
+    String metadata_label;
+    bool track_transform = true;
+    int sample_radius = 0; // 0: the manager's sample_radius
+    uint64_t manager_override_id = 0; // Takes precedence over manager_path (C++ only)
+    bool manager_owned = false; // Created by LightSensorManager::add_node_sensor()
+
+    LightSensorManager *manager = nullptr; // Set while registered (or queued) with a manager
+    int sensor_id = -1;
+
+    Color current_color = Color(0, 0, 0, 1);
+    float current_light_level = 0.0f;
+    uint64_t reading_frame = 0;
+    bool has_reading = false;
+
+protected:
+    static void _bind_methods();
+    void _notification(int p_what);
+
+public:
+    LightSensorPoint3D();
+    ~LightSensorPoint3D();
+
+    void set_manager_path(const NodePath &p_path);
+    NodePath get_manager_path() const;
+    // Applied on the next registration
+    void set_metadata_label(const String &p_label);
+    String get_metadata_label() const;
+    // Follow the node's global_position; off: the position at registration is kept
+    void set_track_transform(bool p_enabled);
+    bool get_track_transform() const;
+    // Sample radius in pixels for this sensor alone; 0 follows the manager's sample_radius
+    void set_sample_radius(int p_radius);
+    int get_sample_radius() const;
+
+    // Same reading properties as LightDataSensor3D
+    Color get_color() const;
+    float get_light_level() const;
+    uint64_t get_reading_frame() const;
+    bool has_valid_reading() const;
+
+    // -1 while unregistered or waiting for the manager to initialize
+    int get_sensor_id() const;
+    LightSensorManager *get_manager() const;
+
+    // Called by LightSensorManager (C++ only)
+    void set_manager_override(LightSensorManager *p_manager);
+    void set_manager_owned(bool p_owned);
+    bool is_manager_owned() const;
+    void set_manager_sensor_id(int p_sensor_id);
+    void apply_manager_reading(const Color &p_color, uint64_t p_frame);
+    // The manager dropped the sensor (remove_sensor, clear_all_sensors, shutdown)
+    void detach_from_manager();
+
+private:
+    LightSensorManager *_find_manager() const;
+    void _register();
+    void _unregister();
+};
+
+} // namespace godot
+
+#endif // LIGHT_SENSOR_POINT_3D_H
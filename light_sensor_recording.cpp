@@ -0,0 +1,415 @@
+#include "light_sensor_recording.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/packed_color_array.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LSR_USE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace godot;
+
+namespace {
+
+int _godot_compression_mode(uint8_t p_codec) {
+    switch (p_codec) {
+        case RECORDING_CODEC_DEFLATE:
+            return FileAccess::COMPRESSION_DEFLATE;
+        case RECORDING_CODEC_ZSTD:
+            return FileAccess::COMPRESSION_ZSTD;
+        default:
+            return FileAccess::COMPRESSION_FASTLZ;
+    }
+}
+
+inline float _bits_float(uint32_t p_bits) {
+    float value;
+    std::memcpy(&value, &p_bits, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+void LightSensorRecording::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("open", "path"), &LightSensorRecording::open);
+    ClassDB::bind_method(D_METHOD("close"), &LightSensorRecording::close);
+    ClassDB::bind_method(D_METHOD("is_open"), &LightSensorRecording::is_open);
+    ClassDB::bind_method(D_METHOD("is_complete"), &LightSensorRecording::is_complete);
+    ClassDB::bind_method(D_METHOD("get_chunk_count"), &LightSensorRecording::get_chunk_count);
+    ClassDB::bind_method(D_METHOD("get_tick_count"), &LightSensorRecording::get_tick_count);
+    ClassDB::bind_method(D_METHOD("get_first_frame"), &LightSensorRecording::get_first_frame);
+    ClassDB::bind_method(D_METHOD("get_last_frame"), &LightSensorRecording::get_last_frame);
+    ClassDB::bind_method(D_METHOD("query_sensor", "sensor_id", "from_frame", "to_frame"), &LightSensorRecording::query_sensor);
+    ClassDB::bind_method(D_METHOD("get_tick", "frame"), &LightSensorRecording::get_tick);
+    ClassDB::bind_method(D_METHOD("query_range", "from_frame", "to_frame"), &LightSensorRecording::query_range);
+}
+
+LightSensorRecording::LightSensorRecording() {
+}
+
+LightSensorRecording::~LightSensorRecording() {
+    close();
+}
+
+bool LightSensorRecording::open(const String &path) {
+    close();
+
+    const String os_path = ProjectSettings::get_singleton()->globalize_path(path);
+    const CharString utf8 = os_path.utf8();
+
+#ifdef LSR_USE_MMAP
+    int fd = ::open(utf8.get_data(), O_RDONLY);
+    if (fd < 0) {
+        UtilityFunctions::push_error("[LightSensorRecording] Cannot open ", path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        UtilityFunctions::push_error("[LightSensorRecording] Empty recording ", path);
+        return false;
+    }
+    void *mem = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED) {
+        UtilityFunctions::push_error("[LightSensorRecording] Cannot map ", path);
+        return false;
+    }
+    data = static_cast<const uint8_t *>(mem);
+    data_size = static_cast<size_t>(st.st_size);
+    mapped = true;
+#else
+    std::ifstream in(utf8.get_data(), std::ios::binary | std::ios::ate);
+    if (!in) {
+        UtilityFunctions::push_error("[LightSensorRecording] Cannot open ", path);
+        return false;
+    }
+    file_copy.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(reinterpret_cast<char *>(file_copy.data()), static_cast<std::streamsize>(file_copy.size()));
+    data = file_copy.data();
+    data_size = file_copy.size();
+#endif
+
+    RecordingFileHeader header;
+    if (data_size < sizeof(header)) {
+        close();
+        UtilityFunctions::push_error("[LightSensorRecording] Not a sensor recording: ", path);
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != RECORDING_FILE_MAGIC || header.version != RECORDING_VERSION) {
+        close();
+        UtilityFunctions::push_error("[LightSensorRecording] Not a sensor recording: ", path);
+        return false;
+    }
+    chunk_ticks = header.chunk_ticks;
+
+    complete = _load_index();
+    if (!complete && !_scan_chunks()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void LightSensorRecording::close() {
+#ifdef LSR_USE_MMAP
+    if (mapped && data) {
+        munmap(const_cast<uint8_t *>(data), data_size);
+    }
+#endif
+    data = nullptr;
+    data_size = 0;
+    mapped = false;
+    file_copy.clear();
+    chunks.clear();
+    complete = false;
+    decoded.chunk = -1;
+}
+
+bool LightSensorRecording::_load_index() {
+    RecordingTrailer trailer;
+    if (data_size < sizeof(RecordingFileHeader) + sizeof(trailer)) {
+        return false;
+    }
+    std::memcpy(&trailer, data + data_size - sizeof(trailer), sizeof(trailer));
+    if (trailer.magic != RECORDING_INDEX_MAGIC) {
+        return false;
+    }
+
+    const size_t index_bytes = static_cast<size_t>(trailer.chunk_count) * sizeof(RecordingIndexEntry);
+    if (trailer.index_offset + index_bytes + sizeof(trailer) != data_size) {
+        return false;
+    }
+    chunks.resize(trailer.chunk_count);
+    if (index_bytes > 0) {
+        std::memcpy(chunks.data(), data + trailer.index_offset, index_bytes);
+    }
+    return true;
+}
+
+bool LightSensorRecording::_scan_chunks() {
+    // Recording was not closed cleanly: walk chunk headers and keep every complete chunk
+    chunks.clear();
+    size_t offset = sizeof(RecordingFileHeader);
+    while (offset + sizeof(RecordingChunkHeader) <= data_size) {
+        RecordingChunkHeader header;
+        std::memcpy(&header, data + offset, sizeof(header));
+        if (header.magic != RECORDING_CHUNK_MAGIC || offset + sizeof(header) + header.stored_size > data_size) {
+            break;
+        }
+
+        RecordingIndexEntry entry = {};
+        entry.offset = offset;
+        entry.first_frame = header.first_frame;
+        entry.last_frame = header.last_frame;
+        entry.tick_count = header.tick_count;
+        entry.row_count = header.row_count;
+        chunks.push_back(entry);
+        offset += sizeof(header) + header.stored_size;
+    }
+    UtilityFunctions::push_warning("[LightSensorRecording] Recording has no index (not closed cleanly); recovered ", static_cast<int64_t>(chunks.size()), " chunks");
+    return true;
+}
+
+bool LightSensorRecording::_decode_chunk(int64_t p_chunk) {
+    if (decoded.chunk == p_chunk) {
+        return true;
+    }
+    decoded.chunk = -1;
+    if (p_chunk < 0 || p_chunk >= static_cast<int64_t>(chunks.size())) {
+        return false;
+    }
+
+    const RecordingIndexEntry &entry = chunks[p_chunk];
+    RecordingChunkHeader header;
+    if (entry.offset + sizeof(header) > data_size) {
+        return false;
+    }
+    std::memcpy(&header, data + entry.offset, sizeof(header));
+    const uint8_t *payload = data + entry.offset + sizeof(header);
+    if (header.magic != RECORDING_CHUNK_MAGIC || entry.offset + sizeof(header) + header.stored_size > data_size) {
+        return false;
+    }
+
+    const RecordingChunkLayout layout(header.tick_count, header.row_count);
+    if (layout.total != header.raw_size) {
+        return false;
+    }
+
+    const uint8_t *raw = payload;
+    PackedByteArray decompressed;
+    if (header.codec != RECORDING_CODEC_NONE) {
+        PackedByteArray stored;
+        stored.resize(static_cast<int64_t>(header.stored_size));
+        std::memcpy(stored.ptrw(), payload, header.stored_size);
+        decompressed = stored.decompress(static_cast<int64_t>(header.raw_size), _godot_compression_mode(header.codec));
+        if (static_cast<uint64_t>(decompressed.size()) != header.raw_size) {
+            UtilityFunctions::push_error("[LightSensorRecording] Chunk ", p_chunk, " failed to decompress");
+            return false;
+        }
+        raw = decompressed.ptr();
+    } else if (header.stored_size != header.raw_size) {
+        return false;
+    }
+
+    const uint32_t tick_count = header.tick_count;
+    const uint32_t row_count = header.row_count;
+    decoded.row_counts.resize(tick_count);
+    decoded.row_offsets.resize(tick_count);
+    decoded.frames.resize(tick_count);
+    decoded.timestamps.resize(tick_count);
+    decoded.ids.resize(row_count);
+    decoded.rgba.resize(static_cast<size_t>(row_count) * 4);
+    decoded.luminance.resize(row_count);
+
+    std::memcpy(decoded.row_counts.data(), raw + layout.row_counts, tick_count * sizeof(uint32_t));
+    std::memcpy(decoded.frames.data(), raw + layout.frames, tick_count * sizeof(uint64_t));
+    std::memcpy(decoded.timestamps.data(), raw + layout.timestamps, tick_count * sizeof(uint64_t));
+
+    const uint8_t *flags = raw + layout.tick_flags;
+    size_t row = 0;
+    size_t prev_row = 0;
+    for (uint32_t t = 0; t < tick_count; ++t) {
+        const uint32_t count = decoded.row_counts[t];
+        if (row + count > row_count) {
+            return false;
+        }
+        const bool delta = (flags[t] & RECORDING_TICK_DELTA) && t > 0 && decoded.row_counts[t - 1] == count;
+        decoded.row_offsets[t] = row;
+
+        for (uint32_t i = 0; i < count; ++i) {
+            const size_t r = row + i;
+            int32_t id;
+            uint32_t bits[5];
+            std::memcpy(&id, raw + layout.ids + r * sizeof(int32_t), sizeof(id));
+            std::memcpy(bits, raw + layout.rgba + r * 4 * sizeof(uint32_t), 4 * sizeof(uint32_t));
+            std::memcpy(bits + 4, raw + layout.luminance + r * sizeof(uint32_t), sizeof(uint32_t));
+
+            if (delta) {
+                const size_t p = prev_row + i;
+                id = static_cast<int32_t>(static_cast<uint32_t>(id) + static_cast<uint32_t>(decoded.ids[p]));
+                for (int c = 0; c < 4; ++c) {
+                    uint32_t prev;
+                    std::memcpy(&prev, &decoded.rgba[p * 4 + c], sizeof(prev));
+                    bits[c] ^= prev;
+                }
+                uint32_t prev;
+                std::memcpy(&prev, &decoded.luminance[p], sizeof(prev));
+                bits[4] ^= prev;
+            }
+
+            decoded.ids[r] = id;
+            for (int c = 0; c < 4; ++c) {
+                decoded.rgba[r * 4 + c] = _bits_float(bits[c]);
+            }
+            decoded.luminance[r] = _bits_float(bits[4]);
+        }
+
+        prev_row = row;
+        row += count;
+    }
+
+    decoded.chunk = p_chunk;
+    return true;
+}
+
+bool LightSensorRecording::is_open() const {
+    return data != nullptr;
+}
+
+bool LightSensorRecording::is_complete() const {
+    return complete;
+}
+
+int LightSensorRecording::get_chunk_count() const {
+    return static_cast<int>(chunks.size());
+}
+
+int64_t LightSensorRecording::get_tick_count() const {
+    int64_t ticks = 0;
+    for (const RecordingIndexEntry &entry : chunks) {
+        ticks += entry.tick_count;
+    }
+    return ticks;
+}
+
+int64_t LightSensorRecording::get_first_frame() const {
+    return chunks.empty() ? -1 : static_cast<int64_t>(chunks.front().first_frame);
+}
+
+int64_t LightSensorRecording::get_last_frame() const {
+    return chunks.empty() ? -1 : static_cast<int64_t>(chunks.back().last_frame);
+}
+
+Dictionary LightSensorRecording::query_sensor(int sensor_id, int64_t from_frame, int64_t to_frame) {
+    PackedInt64Array frames;
+    PackedColorArray colors;
+    PackedFloat32Array luminance;
+
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        if (static_cast<int64_t>(chunks[c].last_frame) < from_frame || static_cast<int64_t>(chunks[c].first_frame) > to_frame) {
+            continue;
+        }
+        if (!_decode_chunk(static_cast<int64_t>(c))) {
+            continue;
+        }
+
+        for (size_t t = 0; t < decoded.frames.size(); ++t) {
+            const int64_t frame = static_cast<int64_t>(decoded.frames[t]);
+            if (frame < from_frame || frame > to_frame) {
+                continue;
+            }
+            const size_t begin = decoded.row_offsets[t];
+            const size_t end = begin + decoded.row_counts[t];
+            for (size_t r = begin; r < end; ++r) {
+                if (decoded.ids[r] != sensor_id) {
+                    continue;
+                }
+                frames.push_back(frame);
+                colors.push_back(Color(decoded.rgba[r * 4], decoded.rgba[r * 4 + 1], decoded.rgba[r * 4 + 2], decoded.rgba[r * 4 + 3]));
+                luminance.push_back(decoded.luminance[r]);
+                break;
+            }
+        }
+    }
+
+    Dictionary result;
+    result["frames"] = frames;
+    result["colors"] = colors;
+    result["luminance"] = luminance;
+    return result;
+}
+
+Dictionary LightSensorRecording::get_tick(int64_t frame) {
+    Array ticks = _collect_ticks(frame, std::numeric_limits<int64_t>::max(), 1);
+    if (ticks.is_empty()) {
+        return Dictionary();
+    }
+    return ticks[0];
+}
+
+Array LightSensorRecording::query_range(int64_t from_frame, int64_t to_frame) {
+    return _collect_ticks(from_frame, to_frame, -1);
+}
+
+Array LightSensorRecording::_collect_ticks(int64_t p_from_frame, int64_t p_to_frame, int p_max_ticks) {
+    Array result;
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        if (static_cast<int64_t>(chunks[c].last_frame) < p_from_frame || static_cast<int64_t>(chunks[c].first_frame) > p_to_frame) {
+            continue;
+        }
+        if (!_decode_chunk(static_cast<int64_t>(c))) {
+            continue;
+        }
+
+        for (size_t t = 0; t < decoded.frames.size(); ++t) {
+            const int64_t frame = static_cast<int64_t>(decoded.frames[t]);
+            if (frame < p_from_frame || frame > p_to_frame) {
+                continue;
+            }
+
+            const size_t begin = decoded.row_offsets[t];
+            const uint32_t count = decoded.row_counts[t];
+            PackedInt32Array ids;
+            PackedColorArray colors;
+            PackedFloat32Array luminance;
+            ids.resize(count);
+            colors.resize(count);
+            luminance.resize(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                const size_t r = begin + i;
+                ids.set(i, decoded.ids[r]);
+                colors.set(i, Color(decoded.rgba[r * 4], decoded.rgba[r * 4 + 1], decoded.rgba[r * 4 + 2], decoded.rgba[r * 4 + 3]));
+                luminance.set(i, decoded.luminance[r]);
+            }
+
+            Dictionary tick;
+            tick["frame"] = frame;
+            tick["timestamp_usec"] = static_cast<int64_t>(decoded.timestamps[t]);
+            tick["ids"] = ids;
+            tick["colors"] = colors;
+            tick["luminance"] = luminance;
+            result.append(tick);
+            if (p_max_ticks > 0 && result.size() >= p_max_ticks) {
+                return result;
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,80 @@
+#ifndef LIGHT_SENSOR_RECORDING_H
+#define LIGHT_SENSOR_RECORDING_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/godot.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+#include "sensor_recording_format.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+// Read access to a recording written by LightSensorManager::start_recording().
+// The file is memory-mapped (read fully on platforms without mmap); chunks are located
+// through the trailing index, or by walking chunk headers if the recording was cut short.
+// Queries only decode the chunks overlapping the requested frame range.
+class LightSensorRecording : public RefCounted {
+    GDCLASS(LightSensorRecording, RefCounted);
+
+private:
+    const uint8_t *data = nullptr;
+    size_t data_size = 0;
+    bool mapped = false;
+    std::vector<uint8_t> file_copy; // Used when mmap is unavailable
+    std::vector<RecordingIndexEntry> chunks;
+    uint32_t chunk_ticks = 0;
+    bool complete = false; // Trailer present
+
+    // Decoded columns of the most recently used chunk
+    struct DecodedChunk {
+        int64_t chunk = -1;
+        std::vector<uint32_t> row_counts;
+        std::vector<uint64_t> row_offsets;
+        std::vector<uint64_t> frames;
+        std::vector<uint64_t> timestamps;
+        std::vector<int32_t> ids;
+        std::vector<float> rgba;
+        std::vector<float> luminance;
+    } decoded;
+
+    bool _load_index();
+    bool _scan_chunks();
+    bool _decode_chunk(int64_t p_chunk);
+    Array _collect_ticks(int64_t p_from_frame, int64_t p_to_frame, int p_max_ticks);
+
+protected:
+    static void _bind_methods();
+
+public:
+    LightSensorRecording();
+    ~LightSensorRecording();
+
+    bool open(const String &path);
+    void close();
+    bool is_open() const;
+    bool is_complete() const;
+
+    int get_chunk_count() const;
+    int64_t get_tick_count() const;
+    int64_t get_first_frame() const;
+    int64_t get_last_frame() const;
+
+    // {frames: PackedInt64Array, colors: PackedColorArray, luminance: PackedFloat32Array}
+    // for one sensor over [from_frame, to_frame]
+    Dictionary query_sensor(int sensor_id, int64_t from_frame, int64_t to_frame);
+    // {frame, timestamp_usec, ids: PackedInt32Array, colors, luminance} for the first tick at
+    // or after p_frame; empty if there is none
+    Dictionary get_tick(int64_t frame);
+    // Array of get_tick() dictionaries for every tick in [from_frame, to_frame]
+    Array query_range(int64_t from_frame, int64_t to_frame);
+};
+
+} // namespace godot
+
+#endif // LIGHT_SENSOR_RECORDING_H
@@ -0,0 +1,69 @@
+#include "light_sensor_request.h"
+#include <godot_cpp/core/class_db.hpp>
+
+using namespace godot;
+
+void LightSensorRequest::_bind_methods() {
+    ADD_SIGNAL(MethodInfo("completed", PropertyInfo(Variant::DICTIONARY, "results")));
+
+    ClassDB::bind_method(D_METHOD("get_sensor_ids"), &LightSensorRequest::get_sensor_ids);
+    ClassDB::bind_method(D_METHOD("is_done"), &LightSensorRequest::is_done);
+    ClassDB::bind_method(D_METHOD("is_cancelled"), &LightSensorRequest::is_cancelled);
+    ClassDB::bind_method(D_METHOD("get_frame"), &LightSensorRequest::get_frame);
+    ClassDB::bind_method(D_METHOD("get_results"), &LightSensorRequest::get_results);
+    ClassDB::bind_method(D_METHOD("get_color", "sensor_id"), &LightSensorRequest::get_color);
+    ClassDB::bind_method(D_METHOD("cancel"), &LightSensorRequest::cancel);
+}
+
+LightSensorRequest::LightSensorRequest() {
+}
+
+LightSensorRequest::~LightSensorRequest() {
+}
+
+PackedInt32Array LightSensorRequest::get_sensor_ids() const {
+    return sensor_ids;
+}
+
+bool LightSensorRequest::is_done() const {
+    return done;
+}
+
+bool LightSensorRequest::is_cancelled() const {
+    return cancelled;
+}
+
+uint64_t LightSensorRequest::get_frame() const {
+    return frame;
+}
+
+Dictionary LightSensorRequest::get_results() const {
+    return results;
+}
+
+Color LightSensorRequest::get_color(int sensor_id) const {
+    return results.get(sensor_id, Color(0, 0, 0, 1));
+}
+
+void LightSensorRequest::setup(const PackedInt32Array &p_sensor_ids) {
+    sensor_ids = p_sensor_ids;
+}
+
+void LightSensorRequest::complete(const Dictionary &p_results, uint64_t p_frame) {
+    if (done) {
+        return;
+    }
+    results = p_results;
+    frame = p_frame;
+    done = true;
+    emit_signal("completed", results);
+}
+
+void LightSensorRequest::cancel() {
+    if (done) {
+        return;
+    }
+    cancelled = true;
+    done = true;
+    emit_signal("completed", results);
+}
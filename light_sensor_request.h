@@ -0,0 +1,53 @@
+#ifndef LIGHT_SENSOR_REQUEST_H
+#define LIGHT_SENSOR_REQUEST_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/godot.hpp>
+#include <godot_cpp/variant/color.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+
+#include <cstdint>
+
+namespace godot {
+
+// Handle returned by LightSensorManager::sample_async(). The manager completes it from the
+// first capture dispatched after the request was made and emits `completed` on the main
+// thread, so GDScript can write:
+//     var results = await manager.sample_async(ids).completed
+class LightSensorRequest : public RefCounted {
+    GDCLASS(LightSensorRequest, RefCounted);
+
+private:
+    PackedInt32Array sensor_ids; // Empty: every sensor
+    Dictionary results;          // sensor_id -> Color
+    uint64_t frame = 0;
+    bool done = false;
+    bool cancelled = false;
+
+protected:
+    static void _bind_methods();
+
+public:
+    LightSensorRequest();
+    ~LightSensorRequest();
+
+    PackedInt32Array get_sensor_ids() const;
+    bool is_done() const;
+    bool is_cancelled() const;
+    // Frame the image behind the results was captured on
+    uint64_t get_frame() const;
+    Dictionary get_results() const;
+    Color get_color(int sensor_id) const;
+
+    // Manager side
+    void setup(const PackedInt32Array &p_sensor_ids);
+    void complete(const Dictionary &p_results, uint64_t p_frame);
+    // Completes with no results; the manager also cancels outstanding requests on shutdown
+    void cancel();
+};
+
+} // namespace godot
+
+#endif // LIGHT_SENSOR_REQUEST_H
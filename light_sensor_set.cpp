@@ -0,0 +1,336 @@
+#include "light_sensor_set.h"
+#include "light_sensor_point_3d.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/char_string.hpp>
+#include <godot_cpp/variant/string_name.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+using namespace godot;
+
+namespace {
+
+// Deduplicated string table under construction
+struct StringTableBuilder {
+    std::unordered_map<std::string, uint32_t> lookup;
+    std::vector<std::string> entries;
+
+    uint32_t intern(const String &p_value) {
+        const CharString utf8 = p_value.utf8();
+        std::string key(utf8.get_data(), static_cast<size_t>(utf8.length()));
+        auto it = lookup.find(key);
+        if (it != lookup.end()) {
+            return it->second;
+        }
+        const uint32_t index = static_cast<uint32_t>(entries.size());
+        lookup.emplace(key, index);
+        entries.push_back(std::move(key));
+        return index;
+    }
+};
+
+// Offsets of the table's entries in strings, which it is appended to
+void _append_table(const StringTableBuilder &p_table, std::vector<uint32_t> &r_offsets, std::string &r_strings) {
+    r_offsets.clear();
+    r_offsets.reserve(p_table.entries.size() + 1);
+    for (const std::string &entry : p_table.entries) {
+        r_offsets.push_back(static_cast<uint32_t>(r_strings.size()));
+        r_strings += entry;
+    }
+    r_offsets.push_back(static_cast<uint32_t>(r_strings.size()));
+}
+
+bool _read_table(const uint8_t *p_data, const SensorSetLayout &p_layout, size_t p_offsets, uint32_t p_count, uint32_t p_strings_size, std::vector<String> &r_table) {
+    std::vector<uint32_t> offsets(static_cast<size_t>(p_count) + 1);
+    std::memcpy(offsets.data(), p_data + p_offsets, offsets.size() * sizeof(uint32_t));
+    r_table.resize(p_count);
+    for (uint32_t i = 0; i < p_count; ++i) {
+        if (offsets[i] > offsets[i + 1] || offsets[i + 1] > p_strings_size) {
+            return false;
+        }
+        r_table[i] = String::utf8(reinterpret_cast<const char *>(p_data + p_layout.strings + offsets[i]), static_cast<int>(offsets[i + 1] - offsets[i]));
+    }
+    return true;
+}
+
+const String &_empty_string() {
+    static const String empty;
+    return empty;
+}
+
+} // namespace
+
+void LightSensorSet::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_data", "data"), &LightSensorSet::set_data);
+    ClassDB::bind_method(D_METHOD("get_data"), &LightSensorSet::get_data);
+    ADD_PROPERTY(PropertyInfo(Variant::PACKED_BYTE_ARRAY, "data", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_STORAGE), "set_data", "get_data");
+
+    ClassDB::bind_method(D_METHOD("bake", "positions", "radii", "labels", "groups"), &LightSensorSet::bake, DEFVAL(PackedInt32Array()), DEFVAL(PackedStringArray()), DEFVAL(PackedStringArray()));
+    ClassDB::bind_method(D_METHOD("bake_from_scene", "root"), &LightSensorSet::bake_from_scene);
+    ClassDB::bind_method(D_METHOD("is_valid"), &LightSensorSet::is_valid);
+    ClassDB::bind_method(D_METHOD("get_sensor_count"), &LightSensorSet::get_sensor_count);
+    ClassDB::bind_method(D_METHOD("get_group_names"), &LightSensorSet::get_group_names);
+    ClassDB::bind_method(D_METHOD("get_positions"), &LightSensorSet::get_positions);
+    ClassDB::bind_method(D_METHOD("get_radii"), &LightSensorSet::get_radii);
+    ClassDB::bind_method(D_METHOD("get_labels"), &LightSensorSet::get_labels);
+    ClassDB::bind_method(D_METHOD("get_groups"), &LightSensorSet::get_groups);
+}
+
+LightSensorSet::LightSensorSet() {
+}
+
+LightSensorSet::~LightSensorSet() {
+}
+
+void LightSensorSet::set_data(const PackedByteArray &p_data) {
+    data = p_data;
+    _parse();
+    emit_changed();
+}
+
+PackedByteArray LightSensorSet::get_data() const {
+    return data;
+}
+
+void LightSensorSet::_parse() {
+    valid = false;
+    header = {};
+    layout = SensorSetLayout();
+    label_table.clear();
+    group_table.clear();
+    if (static_cast<size_t>(data.size()) < sizeof(SensorSetHeader)) {
+        return;
+    }
+
+    const uint8_t *bytes = data.ptr();
+    SensorSetHeader parsed;
+    std::memcpy(&parsed, bytes, sizeof(parsed));
+    if (parsed.magic != SENSOR_SET_MAGIC || parsed.version != SENSOR_SET_VERSION || parsed.group_count > SENSOR_SET_MAX_GROUPS) {
+        return;
+    }
+    const SensorSetLayout parsed_layout(parsed);
+    if (parsed_layout.total > static_cast<size_t>(data.size())) {
+        return;
+    }
+    if (!_read_table(bytes, parsed_layout, parsed_layout.label_offsets, parsed.label_count, parsed.strings_size, label_table) ||
+            !_read_table(bytes, parsed_layout, parsed_layout.group_offsets, parsed.group_count, parsed.strings_size, group_table)) {
+        label_table.clear();
+        group_table.clear();
+        return;
+    }
+
+    // Checked once here, so loads can index the tables and use the radii without checks
+    const uint32_t *labels = reinterpret_cast<const uint32_t *>(bytes + parsed_layout.label_index);
+    const uint16_t *groups = reinterpret_cast<const uint16_t *>(bytes + parsed_layout.group_index);
+    const uint8_t *radii = bytes + parsed_layout.radius;
+    for (uint32_t i = 0; i < parsed.sensor_count; ++i) {
+        if (labels[i] >= parsed.label_count || groups[i] >= parsed.group_count || radii[i] > SENSOR_SET_MAX_RADIUS) {
+            label_table.clear();
+            group_table.clear();
+            return;
+        }
+    }
+
+    header = parsed;
+    layout = parsed_layout;
+    valid = true;
+}
+
+bool LightSensorSet::bake(const PackedVector3Array &p_positions, const PackedInt32Array &p_radii, const PackedStringArray &p_labels, const PackedStringArray &p_groups) {
+    const int64_t count = p_positions.size();
+    if ((!p_radii.is_empty() && p_radii.size() != count) || (!p_labels.is_empty() && p_labels.size() != count) || (!p_groups.is_empty() && p_groups.size() != count)) {
+        return false;
+    }
+
+    StringTableBuilder label_builder;
+    StringTableBuilder group_builder;
+    std::vector<uint32_t> label_index(static_cast<size_t>(count));
+    std::vector<uint16_t> group_index(static_cast<size_t>(count));
+    for (int64_t i = 0; i < count; ++i) {
+        label_index[i] = label_builder.intern(p_labels.is_empty() ? String() : p_labels[i]);
+        const uint32_t group = group_builder.intern(p_groups.is_empty() ? String() : p_groups[i]);
+        if (group >= SENSOR_SET_MAX_GROUPS) {
+            return false;
+        }
+        group_index[i] = static_cast<uint16_t>(group);
+    }
+    if (count == 0) {
+        // Keep the tables non-empty so every set has the same shape
+        label_builder.intern(String());
+        group_builder.intern(String());
+    }
+
+    std::string strings;
+    std::vector<uint32_t> label_offsets;
+    std::vector<uint32_t> group_offsets;
+    _append_table(label_builder, label_offsets, strings);
+    _append_table(group_builder, group_offsets, strings);
+
+    SensorSetHeader baked = {};
+    baked.magic = SENSOR_SET_MAGIC;
+    baked.version = SENSOR_SET_VERSION;
+    baked.sensor_count = static_cast<uint32_t>(count);
+    baked.label_count = static_cast<uint32_t>(label_builder.entries.size());
+    baked.group_count = static_cast<uint32_t>(group_builder.entries.size());
+    baked.strings_size = static_cast<uint32_t>(strings.size());
+    const SensorSetLayout baked_layout(baked);
+
+    PackedByteArray blob;
+    blob.resize(static_cast<int64_t>(baked_layout.total));
+    uint8_t *out = blob.ptrw();
+    std::memset(out, 0, baked_layout.total);
+    std::memcpy(out, &baked, sizeof(baked));
+    float *positions = reinterpret_cast<float *>(out + baked_layout.positions);
+    uint8_t *radii = out + baked_layout.radius;
+    for (int64_t i = 0; i < count; ++i) {
+        const Vector3 position = p_positions[i];
+        positions[i * 3 + 0] = static_cast<float>(position.x);
+        positions[i * 3 + 1] = static_cast<float>(position.y);
+        positions[i * 3 + 2] = static_cast<float>(position.z);
+        const int radius = p_radii.is_empty() ? 0 : p_radii[i];
+        radii[i] = static_cast<uint8_t>(std::max(0, std::min(radius, SENSOR_SET_MAX_RADIUS)));
+    }
+    std::memcpy(out + baked_layout.label_index, label_index.data(), label_index.size() * sizeof(uint32_t));
+    std::memcpy(out + baked_layout.group_index, group_index.data(), group_index.size() * sizeof(uint16_t));
+    std::memcpy(out + baked_layout.label_offsets, label_offsets.data(), label_offsets.size() * sizeof(uint32_t));
+    std::memcpy(out + baked_layout.group_offsets, group_offsets.data(), group_offsets.size() * sizeof(uint32_t));
+    std::memcpy(out + baked_layout.strings, strings.data(), strings.size());
+
+    set_data(blob);
+    return valid;
+}
+
+bool LightSensorSet::bake_from_scene(Node *p_root) {
+    if (!p_root) {
+        return false;
+    }
+
+    PackedVector3Array positions;
+    PackedInt32Array radii;
+    PackedStringArray labels;
+    PackedStringArray groups;
+    // Depth-first in tree order; internal children (add_node_sensor() helpers) are skipped
+    std::vector<Node *> stack = { p_root };
+    while (!stack.empty()) {
+        Node *node = stack.back();
+        stack.pop_back();
+        for (int i = node->get_child_count() - 1; i >= 0; --i) {
+            stack.push_back(node->get_child(i));
+        }
+
+        LightSensorPoint3D *point = Object::cast_to<LightSensorPoint3D>(node);
+        if (!point) {
+            continue;
+        }
+        positions.push_back(point->is_inside_tree() ? point->get_global_position() : point->get_position());
+        radii.push_back(point->get_sample_radius());
+        labels.push_back(point->get_metadata_label());
+        String group;
+        const TypedArray<StringName> node_groups = point->get_groups();
+        for (int64_t g = 0; g < node_groups.size(); ++g) {
+            const String name = node_groups[g];
+            if (!name.begins_with("_")) {
+                group = name; // Underscored groups are engine-internal
+                break;
+            }
+        }
+        groups.push_back(group);
+    }
+    if (positions.is_empty()) {
+        return false;
+    }
+    return bake(positions, radii, labels, groups);
+}
+
+bool LightSensorSet::is_valid() const {
+    return valid;
+}
+
+int LightSensorSet::get_sensor_count() const {
+    return valid ? static_cast<int>(header.sensor_count) : 0;
+}
+
+PackedStringArray LightSensorSet::get_group_names() const {
+    PackedStringArray names;
+    for (const String &group : group_table) {
+        names.push_back(group);
+    }
+    return names;
+}
+
+PackedVector3Array LightSensorSet::get_positions() const {
+    PackedVector3Array positions;
+    const float *column = get_position_column();
+    const int count = get_sensor_count();
+    positions.resize(count);
+    for (int i = 0; i < count; ++i) {
+        positions.set(i, Vector3(column[i * 3 + 0], column[i * 3 + 1], column[i * 3 + 2]));
+    }
+    return positions;
+}
+
+PackedInt32Array LightSensorSet::get_radii() const {
+    PackedInt32Array radii;
+    const uint8_t *column = get_radius_column();
+    const int count = get_sensor_count();
+    radii.resize(count);
+    for (int i = 0; i < count; ++i) {
+        radii.set(i, column[i]);
+    }
+    return radii;
+}
+
+PackedStringArray LightSensorSet::get_labels() const {
+    PackedStringArray labels;
+    const uint32_t *column = get_label_column();
+    const int count = get_sensor_count();
+    labels.resize(count);
+    for (int i = 0; i < count; ++i) {
+        labels.set(i, label_table[column[i]]);
+    }
+    return labels;
+}
+
+PackedStringArray LightSensorSet::get_groups() const {
+    PackedStringArray groups;
+    const uint16_t *column = get_group_column();
+    const int count = get_sensor_count();
+    groups.resize(count);
+    for (int i = 0; i < count; ++i) {
+        groups.set(i, group_table[column[i]]);
+    }
+    return groups;
+}
+
+const float *LightSensorSet::get_position_column() const {
+    return valid ? reinterpret_cast<const float *>(data.ptr() + layout.positions) : nullptr;
+}
+
+const uint32_t *LightSensorSet::get_label_column() const {
+    return valid ? reinterpret_cast<const uint32_t *>(data.ptr() + layout.label_index) : nullptr;
+}
+
+const uint16_t *LightSensorSet::get_group_column() const {
+    return valid ? reinterpret_cast<const uint16_t *>(data.ptr() + layout.group_index) : nullptr;
+}
+
+const uint8_t *LightSensorSet::get_radius_column() const {
+    return valid ? data.ptr() + layout.radius : nullptr;
+}
+
+const String &LightSensorSet::get_label(uint32_t p_label_index) const {
+    return p_label_index < label_table.size() ? label_table[p_label_index] : _empty_string();
+}
+
+int LightSensorSet::find_group(const String &p_group) const {
+    for (size_t i = 0; i < group_table.size(); ++i) {
+        if (group_table[i] == p_group) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
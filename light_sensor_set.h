@@ -0,0 +1,78 @@
+#ifndef LIGHT_SENSOR_SET_H
+#define LIGHT_SENSOR_SET_H
+
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/classes/resource.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/godot.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
+#include <godot_cpp/variant/packed_vector3_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+#include "sensor_set_format.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+// A baked set of sensor placements (position, sample radius, label, group), stored as one
+// packed blob in the sensor_set_format.h layout. Bake it in the editor (bake_from_scene() or
+// bake()), save it as a resource, and load it at level start with
+// LightSensorManager::add_sensor_set(), which reads the columns in place.
+class LightSensorSet : public Resource {
+    GDCLASS(LightSensorSet, Resource);
+
+private:
+    PackedByteArray data;
+    SensorSetHeader header = {};
+    SensorSetLayout layout;
+    bool valid = false;
+    // Decoded once per blob, so loads only copy String references
+    std::vector<String> label_table;
+    std::vector<String> group_table;
+
+    void _parse();
+
+protected:
+    static void _bind_methods();
+
+public:
+    LightSensorSet();
+    ~LightSensorSet();
+
+    // Packed blob; the stored property
+    void set_data(const PackedByteArray &p_data);
+    PackedByteArray get_data() const;
+
+    // Editor side. Empty radii/labels/groups mean 0/""/"" for every sensor; otherwise they
+    // must match positions in size. False (and the set is left unchanged) on a size mismatch.
+    bool bake(const PackedVector3Array &p_positions, const PackedInt32Array &p_radii, const PackedStringArray &p_labels, const PackedStringArray &p_groups);
+    // Bakes every LightSensorPoint3D under p_root: global position, sample_radius,
+    // metadata_label and first group. False when there is none.
+    bool bake_from_scene(Node *p_root);
+
+    bool is_valid() const;
+    int get_sensor_count() const;
+    PackedStringArray get_group_names() const;
+    // Per-sensor columns, for inspection and tools
+    PackedVector3Array get_positions() const;
+    PackedInt32Array get_radii() const;
+    PackedStringArray get_labels() const;
+    PackedStringArray get_groups() const;
+
+    // Bulk access for LightSensorManager (C++ only). Pointers into the blob, valid until it changes.
+    const float *get_position_column() const;
+    const uint32_t *get_label_column() const;
+    const uint16_t *get_group_column() const;
+    const uint8_t *get_radius_column() const;
+    const String &get_label(uint32_t p_label_index) const;
+    // Index into the group table, -1 when no sensor has that group
+    int find_group(const String &p_group) const;
+};
+
+} // namespace godot
+
+#endif // LIGHT_SENSOR_SET_H
@@ -4,9 +4,17 @@
 
 #include "../../batch_compute_manager.h"
 #include <godot_cpp/variant/utility_functions.hpp>
+#include <godot_cpp/classes/engine.hpp>
 #include <godot_cpp/classes/image.hpp>
+#include <algorithm>
+#include <cstring>
 #include <mutex>
 
+#ifdef LIGHT_SENSOR_PRECOMPILED_METALLIB
+// batch_sensor_compute.metal compiled at build time (see SConstruct): kBatchSensorComputeMetallib
+#include "gen/batch_sensor_compute_metallib.h"
+#endif
+
 using namespace godot;
 
 // Forward declarations for MetalTextureAccess functions
@@ -14,6 +22,8 @@ namespace MetalTextureAccess {
     id<MTLTexture> getMetalTextureFromViewportTexture(Ref<ViewportTexture> viewport_texture);
     id<MTLTexture> createMetalTextureFromImage(id<MTLDevice> device, Ref<Image> image);
     id<MTLTexture> createOptimizedMetalTextureFromViewport(id<MTLDevice> device, Ref<ViewportTexture> viewport_texture);
+    id<MTLTexture> createMetalTextureFromSnapshot(id<MTLDevice> device, const SensorSnapshot &snapshot);
+    bool uploadSnapshotToMetalTexture(id<MTLTexture> metal_texture, const SensorSnapshot &snapshot);
     bool isDirectTextureAccessAvailable();
     void logTextureAccessMethod(bool using_direct_access);
 }
@@ -25,9 +35,34 @@ static id<MTLCommandQueue> g_batch_shared_command_queue = nil;
 static id<MTLComputePipelineState> g_batch_shared_compute_pipeline = nil;
 static std::mutex g_batch_metal_init_mutex;
 
+// Pipeline variants of the precompiled kernel, one per radius bucket and color mode. The last
+// bucket has no radius limit. Built by warmUp() at extension init, or on first use.
+static constexpr uint32_t kBatchRadiusBuckets[] = { 1, 2, 4, 8, 16 };
+static constexpr size_t kBatchRadiusBucketCount = sizeof(kBatchRadiusBuckets) / sizeof(kBatchRadiusBuckets[0]);
+static constexpr uint32_t kBatchColorModeCount = 3; // SensorColorMode
+static id<MTLLibrary> g_batch_precompiled_library = nil;
+static id<MTLComputePipelineState> g_batch_variant_pipelines[kBatchRadiusBucketCount + 1][kBatchColorModeCount] = {};
+
+// On-disk pipeline cache: an MTLBinaryArchive (macOS 11+) holding the compiled variants. Typed
+// as id so the globals need no availability annotations.
+static id g_batch_pipeline_archive = nil;
+static NSURL *g_batch_pipeline_archive_url = nil;
+static bool g_batch_pipeline_archive_dirty = false;
+
+static uint64_t _batch_fnv1a(const void *data, size_t size, uint64_t hash = 14695981039346656037ull) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
 // Metal Resource Manager for Batch Compute
 namespace BatchMetalResourceManager {
     bool createComputePipeline();
+    bool loadPrecompiledLibrary();
+    void openPipelineArchive(uint64_t library_hash);
+    id<MTLComputePipelineState> createVariantLocked(size_t bucket, int32_t color_mode);
     
     bool initialize() {
         std::lock_guard<std::mutex> lock(g_batch_metal_init_mutex);
@@ -83,6 +118,71 @@ namespace BatchMetalResourceManager {
         return g_batch_shared_compute_pipeline;
     }
     
+    // Smallest bucket that covers p_max_radius; kBatchRadiusBucketCount when none does
+    size_t radiusBucket(uint32_t max_radius) {
+        for (size_t b = 0; b < kBatchRadiusBucketCount; ++b) {
+            if (max_radius <= kBatchRadiusBuckets[b]) {
+                return b;
+            }
+        }
+        return kBatchRadiusBucketCount;
+    }
+    
+    id<MTLComputePipelineState> getVariantPipeline(size_t bucket, uint32_t color_mode) {
+        std::lock_guard<std::mutex> lock(g_batch_metal_init_mutex);
+        if (!g_batch_precompiled_library || bucket > kBatchRadiusBucketCount || color_mode >= kBatchColorModeCount) {
+            return g_batch_shared_compute_pipeline;
+        }
+        id<MTLComputePipelineState> &slot = g_batch_variant_pipelines[bucket][color_mode];
+        if (!slot) {
+            slot = createVariantLocked(bucket, static_cast<int32_t>(color_mode));
+        }
+        return slot ? slot : g_batch_shared_compute_pipeline;
+    }
+    
+    // Pipeline for a batch whose largest region radius is max_radius. Without the precompiled
+    // library this is the source-compiled pipeline, which serves every variant.
+    id<MTLComputePipelineState> getComputePipeline(uint32_t max_radius, uint32_t color_mode) {
+        return getVariantPipeline(radiusBucket(max_radius), color_mode);
+    }
+    
+    // Writes newly compiled variants to the on-disk archive. Serialized to a temporary file first,
+    // so an interrupted write never leaves a truncated archive behind.
+    void savePipelineArchive() {
+        std::lock_guard<std::mutex> lock(g_batch_metal_init_mutex);
+        if (!g_batch_pipeline_archive || !g_batch_pipeline_archive_dirty) {
+            return;
+        }
+        if (@available(macOS 11.0, *)) {
+            NSFileManager *fm = [NSFileManager defaultManager];
+            NSURL *tmp_url = [g_batch_pipeline_archive_url URLByAppendingPathExtension:@"tmp"];
+            NSError *error = nil;
+            [fm removeItemAtURL:tmp_url error:nil];
+            if (![(id<MTLBinaryArchive>)g_batch_pipeline_archive serializeToURL:tmp_url error:&error]) {
+                return;
+            }
+            [fm removeItemAtURL:g_batch_pipeline_archive_url error:nil];
+            if ([fm moveItemAtURL:tmp_url toURL:g_batch_pipeline_archive_url error:&error]) {
+                g_batch_pipeline_archive_dirty = false;
+            }
+        }
+    }
+    
+    // Creates the device and every pipeline variant ahead of first use. Runs on the warm-up
+    // thread at extension init; each variant takes the lock on its own, so a batch that needs
+    // a pipeline meanwhile waits for at most one compile.
+    void warmUp() {
+        if (!initialize()) {
+            return;
+        }
+        for (size_t bucket = 0; bucket <= kBatchRadiusBucketCount; ++bucket) {
+            for (uint32_t mode = 0; mode < kBatchColorModeCount; ++mode) {
+                getVariantPipeline(bucket, mode);
+            }
+        }
+        savePipelineArchive();
+    }
+    
     id<MTLBuffer> createOutputBuffer(size_t size) {
         std::lock_guard<std::mutex> lock(g_batch_metal_init_mutex);
         if (!g_batch_shared_device) {
@@ -94,6 +194,29 @@ namespace BatchMetalResourceManager {
     void shutdown() {
         std::lock_guard<std::mutex> lock(g_batch_metal_init_mutex);
         
+        for (auto &bucket_pipelines : g_batch_variant_pipelines) {
+            for (id<MTLComputePipelineState> &pipeline : bucket_pipelines) {
+                [pipeline release];
+                pipeline = nil;
+            }
+        }
+        
+        if (g_batch_pipeline_archive) {
+            [g_batch_pipeline_archive release];
+            g_batch_pipeline_archive = nil;
+        }
+        
+        if (g_batch_pipeline_archive_url) {
+            [g_batch_pipeline_archive_url release];
+            g_batch_pipeline_archive_url = nil;
+        }
+        g_batch_pipeline_archive_dirty = false;
+        
+        if (g_batch_precompiled_library) {
+            [g_batch_precompiled_library release];
+            g_batch_precompiled_library = nil;
+        }
+        
         if (g_batch_shared_compute_pipeline) {
             [g_batch_shared_compute_pipeline release];
             g_batch_shared_compute_pipeline = nil;
@@ -112,18 +235,141 @@ namespace BatchMetalResourceManager {
         g_batch_metal_initialized = false;
     }
     
+    bool loadPrecompiledLibrary() {
+#ifdef LIGHT_SENSOR_PRECOMPILED_METALLIB
+        // Wraps the embedded bytes without copying them; the array lives as long as the binary
+        dispatch_data_t data = dispatch_data_create(kBatchSensorComputeMetallib, sizeof(kBatchSensorComputeMetallib), nullptr, ^{});
+        NSError *error = nil;
+        g_batch_precompiled_library = [g_batch_shared_device newLibraryWithData:data error:&error];
+        dispatch_release(data);
+        if (!g_batch_precompiled_library) {
+            return false;
+        }
+        openPipelineArchive(_batch_fnv1a(kBatchSensorComputeMetallib, sizeof(kBatchSensorComputeMetallib)));
+        return true;
+#else
+        return false;
+#endif
+    }
+    
+    void openPipelineArchive(uint64_t library_hash) {
+        if (@available(macOS 11.0, *)) {
+            NSFileManager *fm = [NSFileManager defaultManager];
+            NSURL *dir = [[fm URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask] firstObject];
+            if (!dir) {
+                return;
+            }
+            dir = [dir URLByAppendingPathComponent:@"LightDataSensor" isDirectory:YES];
+            if (![fm createDirectoryAtURL:dir withIntermediateDirectories:YES attributes:nil error:nil]) {
+                return;
+            }
+            
+            // Keyed by GPU, OS build (the Metal driver ships with the OS) and kernel binary, so a
+            // driver update, another GPU or a rebuilt kernel never loads stale pipelines
+            NSString *key = [NSString stringWithFormat:@"%@|%@", [g_batch_shared_device name], [[NSProcessInfo processInfo] operatingSystemVersionString]];
+            const char *key_utf8 = [key UTF8String];
+            const uint64_t hash = _batch_fnv1a(key_utf8, strlen(key_utf8), library_hash);
+            NSString *file_name = [NSString stringWithFormat:@"batch_pipelines_%016llx.metallib", (unsigned long long)hash];
+            g_batch_pipeline_archive_url = [[dir URLByAppendingPathComponent:file_name] retain];
+            
+            MTLBinaryArchiveDescriptor *desc = [[MTLBinaryArchiveDescriptor alloc] init];
+            if ([fm fileExistsAtPath:[g_batch_pipeline_archive_url path]]) {
+                desc.url = g_batch_pipeline_archive_url;
+            }
+            NSError *error = nil;
+            id<MTLBinaryArchive> archive = [g_batch_shared_device newBinaryArchiveWithDescriptor:desc error:&error];
+            if (!archive && desc.url) {
+                // Unreadable archive: start an empty one, rewritten on the next save
+                desc.url = nil;
+                archive = [g_batch_shared_device newBinaryArchiveWithDescriptor:desc error:&error];
+            }
+            [desc release];
+            g_batch_pipeline_archive = archive;
+        }
+    }
+    
+    // Specializes the precompiled kernel. bucket == kBatchRadiusBucketCount leaves the radius
+    // unbounded; color_mode < 0 leaves the color mode to the kernel's buffer argument.
+    id<MTLComputePipelineState> createVariantLocked(size_t bucket, int32_t color_mode) {
+        if (!g_batch_precompiled_library) {
+            return nil;
+        }
+        
+        MTLFunctionConstantValues *constants = [[MTLFunctionConstantValues alloc] init];
+        if (bucket < kBatchRadiusBucketCount) {
+            const uint32_t limit = kBatchRadiusBuckets[bucket];
+            [constants setConstantValue:&limit type:MTLDataTypeUInt atIndex:0];
+        }
+        if (color_mode >= 0) {
+            const uint32_t mode = static_cast<uint32_t>(color_mode);
+            [constants setConstantValue:&mode type:MTLDataTypeUInt atIndex:1];
+        }
+        NSError *error = nil;
+        id<MTLFunction> fn = [g_batch_precompiled_library newFunctionWithName:@"batch_sensor_average" constantValues:constants error:&error];
+        [constants release];
+        if (!fn) {
+            return nil;
+        }
+        
+        MTLComputePipelineDescriptor *desc = [[MTLComputePipelineDescriptor alloc] init];
+        desc.computeFunction = fn;
+        id<MTLComputePipelineState> pipeline = nil;
+        if (@available(macOS 11.0, *)) {
+            if (g_batch_pipeline_archive) {
+                // A hit skips the backend compile; a miss is compiled into the archive, saved later
+                id<MTLBinaryArchive> archive = (id<MTLBinaryArchive>)g_batch_pipeline_archive;
+                desc.binaryArchives = @[ archive ];
+                pipeline = [g_batch_shared_device newComputePipelineStateWithDescriptor:desc options:MTLPipelineOptionFailOnBinaryArchiveMiss reflection:nil error:&error];
+                if (!pipeline && [archive addComputePipelineFunctionsWithDescriptor:desc error:&error]) {
+                    g_batch_pipeline_archive_dirty = true;
+                }
+            }
+        }
+        if (!pipeline) {
+            pipeline = [g_batch_shared_device newComputePipelineStateWithDescriptor:desc options:MTLPipelineOptionNone reflection:nil error:&error];
+        }
+        [desc release];
+        [fn release];
+        return pipeline;
+    }
+    
     bool createComputePipeline() {
         if (!g_batch_shared_device) {
             return false;
         }
         
+        // Prefer the kernel precompiled at build time: no source compile at startup. Its
+        // unspecialized form serves any batch until the matching variant exists.
+        if (loadPrecompiledLibrary()) {
+            g_batch_shared_compute_pipeline = createVariantLocked(kBatchRadiusBucketCount, -1);
+            if (g_batch_shared_compute_pipeline) {
+                return true;
+            }
+            // Unusable on this device: no variants, compile the source below
+            [g_batch_precompiled_library release];
+            g_batch_precompiled_library = nil;
+            [g_batch_pipeline_archive release];
+            g_batch_pipeline_archive = nil;
+            [g_batch_pipeline_archive_url release];
+            g_batch_pipeline_archive_url = nil;
+        }
+        
         // Build the actual viewport sampling compute pipeline
         NSString *src = @"#include <metal_stdlib>\n"
                          @"using namespace metal;\n"
+                         @"// color_mode matches SensorColorMode: 0 encoded, 1 linear, 2 linear re-encoded to sRGB\n"
+                         @"inline float3 srgb_to_linear(float3 c) {\n"
+                         @"    return select(pow((c + 0.055) / 1.055, 2.4), c / 12.92, c <= 0.04045);\n"
+                         @"}\n"
+                         @"inline float3 linear_to_srgb(float3 c) {\n"
+                         @"    c = saturate(c);\n"
+                         @"    return select(1.055 * pow(c, 1.0 / 2.4) - 0.055, c * 12.92, c <= 0.0031308);\n"
+                         @"}\n"
                          @"kernel void simple_test(\n"
                          @"    device float4 *output [[buffer(0)]],\n"
                          @"    device float4 *sensor_regions [[buffer(1)]],\n"
                          @"    device uint *sensor_count [[buffer(2)]],\n"
+                         @"    constant uint &color_mode [[buffer(3)]],\n"
                          @"    texture2d<float> viewport_texture [[texture(0)]],\n"
                          @"    uint3 gid [[thread_position_in_grid]]\n"
                          @") {\n"
@@ -167,13 +413,16 @@ namespace BatchMetalResourceManager {
                          @"            float4 color = viewport_texture.sample(texture_sampler, tex_coord);\n"
                          @"            \n"
                          @"            // Accumulate color values\n"
-                         @"            acc += color.rgb;\n"
+                         @"            acc += (color_mode == 0) ? color.rgb : srgb_to_linear(color.rgb);\n"
                          @"            sample_count++;\n"
                          @"        }\n"
                          @"    }\n"
                          @"    \n"
                          @"    // Calculate average color\n"
                          @"    float3 avg_color = (sample_count > 0) ? (acc / float(sample_count)) : float3(0.0);\n"
+                         @"    if (color_mode == 2) {\n"
+                         @"        avg_color = linear_to_srgb(avg_color);\n"
+                         @"    }\n"
                          @"    \n"
                          @"    // Write the result\n"
                          @"    output[sensor_id] = float4(avg_color, 1.0);\n"
@@ -224,6 +473,14 @@ bool BatchComputeManager::_create_compute_pipelines() {
     return BatchMetalResourceManager::isAvailable();
 }
 
+void BatchComputeManager::warm_up_pipelines() {
+    BatchMetalResourceManager::warmUp();
+}
+
+void BatchComputeManager::save_pipeline_cache() {
+    BatchMetalResourceManager::savePipelineArchive();
+}
+
 bool BatchComputeManager::_create_buffers() {
     if (!BatchMetalResourceManager::isAvailable()) {
         return false;
@@ -286,6 +543,7 @@ void BatchComputeManager::_cleanup_metal_resources() {
         [(id)viewport_texture release];
         viewport_texture = nullptr;
     }
+    viewport_texture_pooled = false;
     
     if (batch_pipeline) {
         [(id)batch_pipeline release];
@@ -339,6 +597,7 @@ bool BatchComputeManager::_create_direct_texture_access(Ref<ViewportTexture> vie
             [(id)this->viewport_texture release];
         }
         this->viewport_texture = (void*)metal_texture;
+        viewport_texture_pooled = false;
         
         MetalTextureAccess::logTextureAccessMethod(true);
         return true;
@@ -357,17 +616,34 @@ bool BatchComputeManager::_create_viewport_texture_fallback(Ref<ViewportTexture>
     // This method implements several optimizations to reduce the performance impact
     // of the necessary get_image() call in the fallback path
     
-    // Use the optimized MetalTextureAccess utility
-    id<MTLTexture> metal_texture = MetalTextureAccess::createOptimizedMetalTextureFromViewport(device, viewport_texture);
+    // Capture into the shared snapshot first: the upload copies the RGBA8 rows directly
+    // and the snapshot stays available for reprojection between ticks. The staging texture
+    // from the previous tick is refilled in place while the viewport size is unchanged.
+    id<MTLTexture> metal_texture = nil;
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex);
+        uint64_t frame = Engine::get_singleton()->get_process_frames();
+        if (!cpu_snapshot.capture(viewport_texture, frame)) {
+            return false;
+        }
+        if (viewport_texture_pooled && MetalTextureAccess::uploadSnapshotToMetalTexture((id<MTLTexture>)this->viewport_texture, cpu_snapshot)) {
+            staging_texture_reuses++;
+            MetalTextureAccess::logTextureAccessMethod(false);
+            return true;
+        }
+        metal_texture = MetalTextureAccess::createMetalTextureFromSnapshot(device, cpu_snapshot);
+    }
     if (!metal_texture) {
         return false;
     }
+    staging_texture_allocations++;
     
     // Store the Metal texture
     if (this->viewport_texture) {
         [(id)this->viewport_texture release];
     }
     this->viewport_texture = (void*)metal_texture;
+    viewport_texture_pooled = true;
     
     MetalTextureAccess::logTextureAccessMethod(false);
     return true;
@@ -388,9 +664,21 @@ bool BatchComputeManager::_update_sensor_regions_buffer() {
         return true;
     }
     
-    // Copy sensor regions to Metal buffer
+    // Copy sensor regions to Metal buffer, mapping centers onto the texture when its pixel
+    // size differs from the space the positions were computed in
     SensorRegion* buffer_data = (SensorRegion*)[(id)sensor_regions_buffer contents];
     memcpy(buffer_data, sensor_regions.data(), sensor_regions.size() * sizeof(SensorRegion));
+    if (viewport_texture && region_space_size.x > 0.0f && region_space_size.y > 0.0f) {
+        id<MTLTexture> texture = (id<MTLTexture>)viewport_texture;
+        const float scale_x = static_cast<float>(texture.width) / region_space_size.x;
+        const float scale_y = static_cast<float>(texture.height) / region_space_size.y;
+        if (scale_x != 1.0f || scale_y != 1.0f) {
+            for (size_t i = 0; i < sensor_regions.size(); ++i) {
+                buffer_data[i].center_x *= scale_x;
+                buffer_data[i].center_y *= scale_y;
+            }
+        }
+    }
     
     // Update sensor count
     uint32_t count = static_cast<uint32_t>(sensor_regions.size());
@@ -406,9 +694,22 @@ bool BatchComputeManager::_dispatch_compute_kernel() {
         return false;
     }
     
+    std::lock_guard<std::mutex> lock(data_mutex);
+    uint32_t sensor_count = static_cast<uint32_t>(sensor_regions.size());
+    if (sensor_count == 0) {
+        return true;
+    }
+    
+    // The variant whose radius bucket covers every region in this batch
+    uint32_t max_radius = 0;
+    for (const SensorRegion &region : sensor_regions) {
+        max_radius = std::max(max_radius, static_cast<uint32_t>(std::max(region.radius, 0)));
+    }
+    const uint32_t color_mode = sensor_color_mode(use_linear_averaging, linear_color_output);
+    
     id<MTLDevice> device = BatchMetalResourceManager::getDevice();
     id<MTLCommandQueue> queue = BatchMetalResourceManager::getCommandQueue();
-    id<MTLComputePipelineState> pipeline = BatchMetalResourceManager::getComputePipeline();
+    id<MTLComputePipelineState> pipeline = BatchMetalResourceManager::getComputePipeline(max_radius, color_mode);
     
     if (!device || !queue || !pipeline) {
         return false;
@@ -439,21 +740,13 @@ bool BatchComputeManager::_dispatch_compute_kernel() {
     [encoder setBuffer:(id)output_buffer offset:0 atIndex:0];
     [encoder setBuffer:(id)sensor_regions_buffer offset:0 atIndex:1];
     [encoder setBuffer:(id)sensor_count_buffer offset:0 atIndex:2];
+    [encoder setBytes:&color_mode length:sizeof(color_mode) atIndex:3];
     
     // Set viewport texture if available
     if (viewport_texture) {
         [encoder setTexture:(id)viewport_texture atIndex:0];
     }
     
-    // Calculate threadgroup size
-    std::lock_guard<std::mutex> lock(data_mutex);
-    uint32_t sensor_count = static_cast<uint32_t>(sensor_regions.size());
-    if (sensor_count == 0) {
-        [encoder endEncoding];
-        [command_buffer commit];
-        return true;
-    }
-    
     // Dispatch compute
     MTLSize threadgroup_size = MTLSizeMake(1, 1, 1);
     MTLSize threadgroup_count = MTLSizeMake(sensor_count, 1, 1);
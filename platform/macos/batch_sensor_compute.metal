@@ -9,15 +9,43 @@ struct SensorRegion {
     int sensor_id;
 };
 
+// Matches SensorColorMode in sensor_color_space.h
+constant uint SENSOR_COLOR_ENCODED = 0;
+constant uint SENSOR_COLOR_LINEAR_SRGB = 2;
+
+// Exact sRGB transfer functions; the texture is RGBA8Unorm, so samples arrive encoded
+inline float3 srgb_to_linear(float3 c) {
+    return select(pow((c + 0.055) / 1.055, 2.4), c / 12.92, c <= 0.04045);
+}
+
+inline float3 linear_to_srgb(float3 c) {
+    c = saturate(c);
+    return select(1.055 * pow(c, 1.0 / 2.4) - 0.055, c * 12.92, c <= 0.0031308);
+}
+
 // Sampler for texture sampling
 constexpr sampler texture_sampler(coord::pixel, address::clamp_to_edge, filter::linear);
 
+// Pipeline variant constants, set by BatchComputeManager when it specializes the precompiled
+// library. radius_limit is the radius bucket: an upper bound on every region radius in the batch,
+// so the sample loops get a compile-time trip count. color_mode_constant bakes the color mode in.
+// Left undefined, the kernels loop to the region radius and read color_mode from the buffer.
+constant uint radius_limit [[function_constant(0)]];
+constant uint color_mode_constant [[function_constant(1)]];
+constant bool has_radius_limit = is_function_constant_defined(radius_limit);
+constant bool has_color_mode_constant = is_function_constant_defined(color_mode_constant);
+
+inline int region_radius(int radius) {
+    return has_radius_limit ? min(radius, int(radius_limit)) : radius;
+}
+
 // Main compute kernel for batched sensor processing
 kernel void batch_sensor_average(
     device float4 *output [[buffer(0)]],                    // Output buffer for all sensor results
     texture2d<float> viewport_texture [[texture(0)]],       // Input viewport texture
     constant SensorRegion *regions [[buffer(1)]],           // Array of sensor regions
     constant uint &sensor_count [[buffer(2)]],              // Number of sensors to process
+    constant uint &color_mode [[buffer(3)]],                // SensorColorMode
     uint3 gid [[thread_position_in_grid]]                   // Thread ID
 ) {
     uint sensor_id = gid.x;
@@ -28,27 +56,32 @@ kernel void batch_sensor_average(
     }
     
     SensorRegion region = regions[sensor_id];
+    const uint mode = has_color_mode_constant ? color_mode_constant : color_mode;
+    const int radius = region_radius(region.radius);
     
     // Initialize accumulator
     float3 acc = float3(0.0);
     uint sample_count = 0;
     
     // Sample region around sensor position
-    for (int dy = -region.radius; dy <= region.radius; ++dy) {
-        for (int dx = -region.radius; dx <= region.radius; ++dx) {
+    for (int dy = -radius; dy <= radius; ++dy) {
+        for (int dx = -radius; dx <= radius; ++dx) {
             float2 sample_pos = float2(region.center_x + dx, region.center_y + dy);
             
             // Sample texture at position
             float4 color = viewport_texture.sample(texture_sampler, sample_pos);
             
-            // Accumulate color values
-            acc += color.rgb;
+            // Accumulate color values, in linear light unless the legacy mode is selected
+            acc += (mode == SENSOR_COLOR_ENCODED) ? color.rgb : srgb_to_linear(color.rgb);
             sample_count++;
         }
     }
     
     // Calculate average color
     float3 avg_color = (sample_count > 0) ? (acc / float(sample_count)) : float3(0.0);
+    if (mode == SENSOR_COLOR_LINEAR_SRGB) {
+        avg_color = linear_to_srgb(avg_color);
+    }
     
     // Store result
     output[sensor_id] = float4(avg_color, 1.0);
@@ -61,28 +94,34 @@ kernel void batch_sensor_average_optimized(
     constant SensorRegion *regions [[buffer(1)]],
     constant uint &sensor_count [[buffer(2)]],
     constant uint &sensors_per_thread [[buffer(3)]],
+    constant uint &color_mode [[buffer(4)]],
     uint3 gid [[thread_position_in_grid]]
 ) {
     uint base_sensor_id = gid.x * sensors_per_thread;
+    const uint mode = has_color_mode_constant ? color_mode_constant : color_mode;
     
     for (uint i = 0; i < sensors_per_thread && (base_sensor_id + i) < sensor_count; ++i) {
         uint sensor_id = base_sensor_id + i;
         SensorRegion region = regions[sensor_id];
+        const int radius = region_radius(region.radius);
         
         float3 acc = float3(0.0);
         uint sample_count = 0;
         
         // Sample region
-        for (int dy = -region.radius; dy <= region.radius; ++dy) {
-            for (int dx = -region.radius; dx <= region.radius; ++dx) {
+        for (int dy = -radius; dy <= radius; ++dy) {
+            for (int dx = -radius; dx <= radius; ++dx) {
                 float2 sample_pos = float2(region.center_x + dx, region.center_y + dy);
                 float4 color = viewport_texture.sample(texture_sampler, sample_pos);
-                acc += color.rgb;
+                acc += (mode == SENSOR_COLOR_ENCODED) ? color.rgb : srgb_to_linear(color.rgb);
                 sample_count++;
             }
         }
         
         float3 avg_color = (sample_count > 0) ? (acc / float(sample_count)) : float3(0.0);
+        if (mode == SENSOR_COLOR_LINEAR_SRGB) {
+            avg_color = linear_to_srgb(avg_color);
+        }
         output[sensor_id] = float4(avg_color, 1.0);
     }
 }
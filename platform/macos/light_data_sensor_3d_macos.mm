@@ -138,7 +138,9 @@ namespace MetalResourceManager {
                          @"                                        float(y) / float(constants.texture_height));\n"
                          @"                float4 sample_color = inputTexture.sample(textureSampler, texCoord);\n"
                          @"                \n"
-                         @"                color_sum += sample_color.rgb;\n"
+                         @"                // RGBA8Unorm holds sRGB-encoded values: average in linear light\n"
+                         @"                float3 c = sample_color.rgb;\n"
+                         @"                color_sum += select(pow((c + 0.055) / 1.055, 2.4), c / 12.92, c <= 0.04045);\n"
                          @"                sample_count++;\n"
                          @"            }\n"
                          @"        }\n"
@@ -252,7 +254,8 @@ bool LightDataSensor3D::_capture_metal_direct_texture(Ref<ViewportTexture> tex)
         // Fall back to optimized texture creation from ViewportTexture
         // This still avoids some CPU-GPU sync overhead compared to get_image()
         // For now, we'll use a simple fallback that creates a texture from the viewport
-        Ref<Image> img = tex->get_image();
+        // Shared with the frame-cache tier: a failed attempt does not cost a second readback
+        Ref<Image> img = _acquire_frame_image(tex);
         if (img.is_valid()) {
             // Create a Metal texture from the image data
             int width = img->get_width();
@@ -316,13 +319,11 @@ bool LightDataSensor3D::_process_metal_texture_direct(void* device,
     
     // Set sample position and region size
     const int sample_radius = 4;
-    int cx = mtl_texture.width / 2;
-    int cy = mtl_texture.height / 2;
-    
-    // Use screen_sample_pos if it's been set
-    if (screen_sample_pos.x > 0 && screen_sample_pos.y > 0) {
-        cx = static_cast<int>(screen_sample_pos.x);
-        cy = static_cast<int>(screen_sample_pos.y);
+    int cx = 0;
+    int cy = 0;
+    if (!_resolve_sample_center(static_cast<int>(mtl_texture.width), static_cast<int>(mtl_texture.height), cx, cy)) {
+        [encoder endEncoding];
+        return false;
     }
     
     // Create constants buffer for sample parameters
@@ -355,8 +356,8 @@ bool LightDataSensor3D::_process_metal_texture_direct(void* device,
     // Read result
     float *result = (float *)[mtl_outBuf contents];
     if (result) {
-        current_color = Color(result[0], result[1], result[2], result[3]);
-        current_light_level = 0.299f * result[0] + 0.587f * result[1] + 0.114f * result[2];
+        current_color = _finish_linear_average(Color(result[0], result[1], result[2], result[3]));
+        current_light_level = 0.299f * current_color.r + 0.587f * current_color.g + 0.114f * current_color.b;
         has_new_readings = true;
         
         [constantsBuf release];
@@ -443,8 +444,8 @@ void LightDataSensor3D::_metal_readback_loop() {
         // Read result
         float *result = (float *)[outBuf contents];
         if (result) {
-            current_color = Color(result[0], result[1], result[2], result[3]);
-            current_light_level = 0.299f * result[0] + 0.587f * result[1] + 0.114f * result[2];
+            current_color = _finish_linear_average(Color(result[0], result[1], result[2], result[3]));
+            current_light_level = 0.299f * current_color.r + 0.587f * current_color.g + 0.114f * current_color.b;
             has_new_readings = true;
         }
     }
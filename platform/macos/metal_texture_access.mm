@@ -140,6 +140,48 @@ namespace MetalTextureAccess {
         return metal_texture;
     }
     
+    // Create a Metal texture from an RGBA8 snapshot (rows are already tightly packed)
+    id<MTLTexture> createMetalTextureFromSnapshot(id<MTLDevice> device, const SensorSnapshot &snapshot) {
+        if (!device || !snapshot.is_valid()) {
+            return nil;
+        }
+        
+        MTLTextureDescriptor* texture_desc = [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:MTLPixelFormatRGBA8Unorm
+                                                                                                 width:snapshot.width
+                                                                                                height:snapshot.height
+                                                                                             mipmapped:NO];
+        texture_desc.usage = MTLTextureUsageShaderRead;
+        
+        id<MTLTexture> metal_texture = [device newTextureWithDescriptor:texture_desc];
+        if (!metal_texture) {
+            return nil;
+        }
+        
+        [metal_texture replaceRegion:MTLRegionMake2D(0, 0, snapshot.width, snapshot.height)
+                          mipmapLevel:0
+                            withBytes:snapshot.rgba8.data()
+                          bytesPerRow:snapshot.width * 4];
+        
+        return metal_texture;
+    }
+    
+    // Re-upload a snapshot into a texture created by createMetalTextureFromSnapshot().
+    // Returns false when the sizes differ and a new texture is needed.
+    bool uploadSnapshotToMetalTexture(id<MTLTexture> metal_texture, const SensorSnapshot &snapshot) {
+        if (!metal_texture || !snapshot.is_valid()) {
+            return false;
+        }
+        if (metal_texture.width != (NSUInteger)snapshot.width || metal_texture.height != (NSUInteger)snapshot.height) {
+            return false;
+        }
+        
+        [metal_texture replaceRegion:MTLRegionMake2D(0, 0, snapshot.width, snapshot.height)
+                          mipmapLevel:0
+                            withBytes:snapshot.rgba8.data()
+                          bytesPerRow:snapshot.width * 4];
+        return true;
+    }
+    
     // Log texture access method for debugging (disabled for performance)
     void logTextureAccessMethod(bool using_direct_access) {
         // Note: Direct GPU access is preferred but fallback to CPU-GPU sync is normal
@@ -8,6 +8,16 @@
 #include <chrono>
 #include <thread>
 #include <cmath>
+#include <cstdio>
+#include <cwchar>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef LIGHT_SENSOR_PRECOMPILED_HLSL
+// compute_shader.hlsl compiled at build time with fxc (see SConstruct): kAverageCSBytecode
+#include "gen/compute_shader_cs.h"
+#endif
 
 using Microsoft::WRL::ComPtr;
 using namespace godot;
@@ -38,37 +48,106 @@ void mainCS(uint3 tid : SV_DispatchThreadID) {
 }
 )";
 
-static void _wait_fence(ComPtr<ID3D12Fence> &fence, HANDLE event_handle, UINT64 &value, ID3D12CommandQueue *queue) {
-    const UINT64 signal = ++value;
-    queue->Signal(fence.Get(), signal);
-    if (fence->GetCompletedValue() < signal) {
-        fence->SetEventOnCompletion(signal, event_handle);
-        WaitForSingleObject(event_handle, INFINITE);
+// Compute shader bytecode shared by every sensor: the build's precompiled blob, or the source
+// above compiled once per process when the build had no fxc.
+static std::mutex g_average_cs_mutex;
+static ComPtr<ID3DBlob> g_average_cs_compiled;
+
+static bool _average_shader_bytecode(D3D12_SHADER_BYTECODE &r_bytecode) {
+#ifdef LIGHT_SENSOR_PRECOMPILED_HLSL
+    r_bytecode = { kAverageCSBytecode, sizeof(kAverageCSBytecode) };
+    return true;
+#else
+    std::lock_guard<std::mutex> lock(g_average_cs_mutex);
+    if (!g_average_cs_compiled) {
+        ComPtr<ID3DBlob> errors;
+        if (FAILED(D3DCompile(kAverageHLSL, strlen(kAverageHLSL), nullptr, nullptr, nullptr, "mainCS", "cs_5_1", D3DCOMPILE_OPTIMIZATION_LEVEL3, 0, &g_average_cs_compiled, &errors))) {
+            g_average_cs_compiled.Reset();
+            return false;
+        }
     }
+    r_bytecode = { g_average_cs_compiled->GetBufferPointer(), g_average_cs_compiled->GetBufferSize() };
+    return true;
+#endif
 }
 
-void LightDataSensor3D::_init_pcie_bar() {
-    d3d_device = _create_device();
-    if (!d3d_device) return;
-    UtilityFunctions::print("[LightDataSensor3D][Windows] D3D12 device created.");
+static uint64_t _fnv1a(const void *data, size_t size) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
 
-    // Queue/allocator/cmdlist
-    D3D12_COMMAND_QUEUE_DESC qd = {};
-    qd.Type = D3D12_COMMAND_LIST_TYPE_COMPUTE;
-    d3d_device->CreateCommandQueue(&qd, IID_PPV_ARGS(&d3d_queue));
-    d3d_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COMPUTE, IID_PPV_ARGS(&d3d_allocator));
-    d3d_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COMPUTE, d3d_allocator.Get(), nullptr, IID_PPV_ARGS(&d3d_cmdlist));
-    d3d_cmdlist->Close();
+// On-disk PSO cache file: %LOCALAPPDATA%\LightDataSensor\pso_<vendor>_<device>_<driver>_<shader>.bin.
+// The driver version and adapter in the name keep a driver update or another GPU from even
+// trying a stale blob. Empty when the adapter or the cache directory cannot be resolved.
+static std::wstring _pso_cache_path(ID3D12Device *device, const D3D12_SHADER_BYTECODE &cs) {
+    ComPtr<IDXGIFactory4> factory;
+    ComPtr<IDXGIAdapter1> adapter;
+    if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&factory))) || FAILED(factory->EnumAdapterByLuid(device->GetAdapterLuid(), IID_PPV_ARGS(&adapter)))) {
+        return std::wstring();
+    }
+    DXGI_ADAPTER_DESC1 desc = {};
+    adapter->GetDesc1(&desc);
+    LARGE_INTEGER driver_version = {};
+    adapter->CheckInterfaceSupport(__uuidof(IDXGIDevice), &driver_version);
 
-    // Descriptor heap for SRV/UAV
-    D3D12_DESCRIPTOR_HEAP_DESC heap_desc = {};
-    heap_desc.NumDescriptors = 2;
-    heap_desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-    heap_desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    d3d_device->CreateDescriptorHeap(&heap_desc, IID_PPV_ARGS(&d3d_desc_heap));
-    d3d_srvuav_desc_size = d3d_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    wchar_t local_app_data[MAX_PATH];
+    const DWORD length = GetEnvironmentVariableW(L"LOCALAPPDATA", local_app_data, MAX_PATH);
+    if (length == 0 || length >= MAX_PATH) {
+        return std::wstring();
+    }
+    std::wstring path = std::wstring(local_app_data) + L"\\LightDataSensor";
+    if (!CreateDirectoryW(path.c_str(), nullptr) && GetLastError() != ERROR_ALREADY_EXISTS) {
+        return std::wstring();
+    }
+    wchar_t file_name[128];
+    swprintf(file_name, 128, L"\\pso_%04x_%04x_%016llx_%016llx.bin", desc.VendorId, desc.DeviceId,
+            static_cast<unsigned long long>(driver_version.QuadPart),
+            static_cast<unsigned long long>(_fnv1a(cs.pShaderBytecode, cs.BytecodeLength)));
+    return path + file_name;
+}
+
+static std::vector<char> _read_cache_file(const std::wstring &path) {
+    std::vector<char> data;
+    FILE *file = path.empty() ? nullptr : _wfopen(path.c_str(), L"rb");
+    if (!file) {
+        return data;
+    }
+    if (fseek(file, 0, SEEK_END) == 0) {
+        const long size = ftell(file);
+        if (size > 0 && fseek(file, 0, SEEK_SET) == 0) {
+            data.resize(static_cast<size_t>(size));
+            if (fread(data.data(), 1, data.size(), file) != data.size()) {
+                data.clear();
+            }
+        }
+    }
+    fclose(file);
+    return data;
+}
+
+// Written to a temporary file and renamed, so a concurrent reader never sees a partial blob
+static void _write_cache_file(const std::wstring &path, const void *data, size_t size) {
+    if (path.empty()) {
+        return;
+    }
+    const std::wstring tmp_path = path + L".tmp";
+    FILE *file = _wfopen(tmp_path.c_str(), L"wb");
+    if (!file) {
+        return;
+    }
+    const bool written = fwrite(data, 1, size, file) == size;
+    fclose(file);
+    if (!written || !MoveFileExW(tmp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        DeleteFileW(tmp_path.c_str());
+    }
+}
 
-    // Root signature: SRV table (t0), UAV table (u0), CBV root (b0)
+// Root signature: SRV table (t0), UAV table (u0), CBV root (b0)
+static bool _create_average_root_signature(ID3D12Device *device, ComPtr<ID3D12RootSignature> &r_root_sig) {
     D3D12_DESCRIPTOR_RANGE ranges[2] = {};
     ranges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV; ranges[0].NumDescriptors = 1; ranges[0].BaseShaderRegister = 0; ranges[0].OffsetInDescriptorsFromTableStart = 0;
     ranges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV; ranges[1].NumDescriptors = 1; ranges[1].BaseShaderRegister = 0; ranges[1].OffsetInDescriptorsFromTableStart = 0;
@@ -93,19 +172,82 @@ void LightDataSensor3D::_init_pcie_bar() {
     rs_desc.Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE;
 
     ComPtr<ID3DBlob> rs_blob, rs_err;
-    D3D12SerializeRootSignature(&rs_desc, D3D_ROOT_SIGNATURE_VERSION_1, &rs_blob, &rs_err);
-    if (FAILED(d3d_device->CreateRootSignature(0, rs_blob->GetBufferPointer(), rs_blob->GetBufferSize(), IID_PPV_ARGS(&d3d_root_sig)))) {
+    if (FAILED(D3D12SerializeRootSignature(&rs_desc, D3D_ROOT_SIGNATURE_VERSION_1, &rs_blob, &rs_err))) {
+        return false;
+    }
+    return SUCCEEDED(device->CreateRootSignature(0, rs_blob->GetBufferPointer(), rs_blob->GetBufferSize(), IID_PPV_ARGS(&r_root_sig)));
+}
+
+// Creates the averaging PSO from the on-disk cache when the driver accepts the cached blob,
+// otherwise from bytecode, and then refreshes the cache file
+static bool _create_average_pso(ID3D12Device *device, ID3D12RootSignature *root_sig, ComPtr<ID3D12PipelineState> &r_pso) {
+    D3D12_SHADER_BYTECODE cs = {};
+    if (!_average_shader_bytecode(cs)) {
+        return false;
+    }
+    const std::wstring cache_path = _pso_cache_path(device, cs);
+    std::vector<char> cached = _read_cache_file(cache_path);
+
+    D3D12_COMPUTE_PIPELINE_STATE_DESC pso_desc = {};
+    pso_desc.pRootSignature = root_sig;
+    pso_desc.CS = cs;
+    pso_desc.CachedPSO = { cached.empty() ? nullptr : cached.data(), cached.size() };
+    HRESULT hr = device->CreateComputePipelineState(&pso_desc, IID_PPV_ARGS(&r_pso));
+    if (FAILED(hr) && !cached.empty()) {
+        // Rejected blob (driver or adapter mismatch, corrupt file): rebuild and replace it
+        cached.clear();
+        pso_desc.CachedPSO = {};
+        hr = device->CreateComputePipelineState(&pso_desc, IID_PPV_ARGS(&r_pso));
+    }
+    if (FAILED(hr)) {
+        return false;
+    }
+    if (cached.empty()) {
+        ComPtr<ID3DBlob> blob;
+        if (SUCCEEDED(r_pso->GetCachedBlob(&blob))) {
+            _write_cache_file(cache_path, blob->GetBufferPointer(), blob->GetBufferSize());
+        }
+    }
+    return true;
+}
+
+static void _wait_fence(ComPtr<ID3D12Fence> &fence, HANDLE event_handle, UINT64 &value, ID3D12CommandQueue *queue) {
+    const UINT64 signal = ++value;
+    queue->Signal(fence.Get(), signal);
+    if (fence->GetCompletedValue() < signal) {
+        fence->SetEventOnCompletion(signal, event_handle);
+        WaitForSingleObject(event_handle, INFINITE);
+    }
+}
+
+void LightDataSensor3D::_init_pcie_bar() {
+    d3d_device = _create_device();
+    if (!d3d_device) return;
+    UtilityFunctions::print("[LightDataSensor3D][Windows] D3D12 device created.");
+
+    // Queue/allocator/cmdlist
+    D3D12_COMMAND_QUEUE_DESC qd = {};
+    qd.Type = D3D12_COMMAND_LIST_TYPE_COMPUTE;
+    d3d_device->CreateCommandQueue(&qd, IID_PPV_ARGS(&d3d_queue));
+    d3d_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COMPUTE, IID_PPV_ARGS(&d3d_allocator));
+    d3d_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COMPUTE, d3d_allocator.Get(), nullptr, IID_PPV_ARGS(&d3d_cmdlist));
+    d3d_cmdlist->Close();
+
+    // Descriptor heap for SRV/UAV
+    D3D12_DESCRIPTOR_HEAP_DESC heap_desc = {};
+    heap_desc.NumDescriptors = 2;
+    heap_desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    heap_desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    d3d_device->CreateDescriptorHeap(&heap_desc, IID_PPV_ARGS(&d3d_desc_heap));
+    d3d_srvuav_desc_size = d3d_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+    if (!_create_average_root_signature(d3d_device.Get(), d3d_root_sig)) {
         UtilityFunctions::print("[LightDataSensor3D][Windows] Failed to create root signature; fallback to CPU.");
         return;
     }
 
-    // Compile HLSL and create PSO
-    ComPtr<ID3DBlob> cs_blob, cs_err;
-    D3DCompile(kAverageHLSL, strlen(kAverageHLSL), nullptr, nullptr, nullptr, "mainCS", "cs_5_1", 0, 0, &cs_blob, &cs_err);
-    D3D12_COMPUTE_PIPELINE_STATE_DESC pso_desc = {};
-    pso_desc.pRootSignature = d3d_root_sig.Get();
-    pso_desc.CS = { cs_blob->GetBufferPointer(), cs_blob->GetBufferSize() };
-    if (FAILED(d3d_device->CreateComputePipelineState(&pso_desc, IID_PPV_ARGS(&d3d_pso)))) {
+    // Precompiled bytecode and the on-disk PSO cache; no shader compile on the common path
+    if (!_create_average_pso(d3d_device.Get(), d3d_root_sig.Get(), d3d_pso)) {
         UtilityFunctions::print("[LightDataSensor3D][Windows] Failed to create PSO; fallback to CPU.");
         return;
     }
@@ -119,6 +261,17 @@ void LightDataSensor3D::_init_pcie_bar() {
     fence_event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
 }
 
+void LightDataSensor3D::_warm_up_d3d12_pipeline() {
+    // D3D12 hands every caller the same device per adapter, so this also warms the device
+    // _init_pcie_bar() will get, and leaves a PSO cache file behind for it
+    ComPtr<ID3D12Device> device = _create_device();
+    ComPtr<ID3D12RootSignature> root_sig;
+    ComPtr<ID3D12PipelineState> pso;
+    if (device && _create_average_root_signature(device.Get(), root_sig)) {
+        _create_average_pso(device.Get(), root_sig.Get(), pso);
+    }
+}
+
 void LightDataSensor3D::_readback_loop() {
     // GPU averaging via D3D12 compute. Falls back to sleep if device is missing.
     while (is_running) {
@@ -285,8 +438,9 @@ void LightDataSensor3D::_readback_loop() {
         void *mapped = nullptr; D3D12_RANGE read = {0, 16};
         if (SUCCEEDED(d3d_output_readback->Map(0, &read, &mapped)) && mapped) {
             float *p = reinterpret_cast<float *>(mapped);
-            current_color = Color(p[0], p[1], p[2], p[3]);
-            current_light_level = 0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2];
+            // Staged pixels are linear; the average goes back to the node's output encoding
+            current_color = _finish_linear_average(Color(p[0], p[1], p[2], p[3]));
+            current_light_level = 0.299f * current_color.r + 0.587f * current_color.g + 0.114f * current_color.b;
             has_new_readings = true;
             d3d_output_readback->Unmap(0, nullptr);
         }
@@ -4,9 +4,21 @@
 #include "light_data_sensor_3d.h"
 #include "batch_compute_manager.h"
 #include "light_sensor_manager.h"
+#include "light_sensor_point_3d.h"
+#include "light_sensor_batcher.h"
+#include "light_sensor_recording.h"
+#include "light_sensor_request.h"
+#include "light_sensor_set.h"
+#include "sensor_worker_pool.h"
+
+#include <thread>
 
 using namespace godot;
 
+// Builds the worker pool and the GPU pipelines off the main thread while the engine loads, so
+// the first sensor does not pay for thread startup or a shader compile
+static std::thread g_warm_up_thread;
+
 void initialize_light_data_sensor_module(ModuleInitializationLevel p_level) {
     if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
         return;
@@ -14,12 +26,29 @@ void initialize_light_data_sensor_module(ModuleInitializationLevel p_level) {
     ClassDB::register_class<LightDataSensor3D>();
     ClassDB::register_class<BatchComputeManager>();
     ClassDB::register_class<LightSensorManager>();
+    ClassDB::register_class<LightSensorPoint3D>();
+    ClassDB::register_class<LightSensorBatcher>();
+    ClassDB::register_class<LightSensorRecording>();
+    ClassDB::register_class<LightSensorRequest>();
+    ClassDB::register_class<LightSensorSet>();
+
+    g_warm_up_thread = std::thread([]() {
+        SensorWorkerPool::get_singleton();
+        BatchComputeManager::warm_up_pipelines();
+        LightDataSensor3D::warm_up_pipelines();
+    });
 }
 
 void uninitialize_light_data_sensor_module(ModuleInitializationLevel p_level) {
     if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
         return;
     }
+    if (g_warm_up_thread.joinable()) {
+        g_warm_up_thread.join();
+    }
+    BatchComputeManager::save_pipeline_cache();
+    SensorWorkerPool::shutdown_singleton();
+    LightDataSensor3D::release_capture_cache();
 }
 
 extern "C" {
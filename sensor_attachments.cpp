@@ -0,0 +1,241 @@
+#include "sensor_attachments.h"
+
+#include <godot_cpp/classes/multi_mesh.hpp>
+#include <godot_cpp/core/object.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+
+#include <algorithm>
+
+using namespace godot;
+
+namespace {
+
+// MultiMesh packs a 3D instance as three basis rows, each followed by one origin component
+constexpr size_t MULTIMESH_TRANSFORM_FLOATS = 12;
+
+// One straight pass: each offset goes through its instance transform, then the node's.
+// The body is plain arithmetic on the packed rows, which the compiler can vectorize.
+void _transform_instances(const float *p_buffer, size_t p_stride, size_t p_instance_count, const Transform3D &p_node_xform, const int32_t *p_instances, const Vector3 *p_offsets, size_t p_count, Vector3 *r_positions, uint8_t *r_valid) {
+    const Basis &b = p_node_xform.basis;
+    const Vector3 &o = p_node_xform.origin;
+    for (size_t k = 0; k < p_count; ++k) {
+        const int32_t instance = p_instances[k];
+        const bool valid = instance >= 0 && static_cast<size_t>(instance) < p_instance_count;
+        r_valid[k] = valid ? 1 : 0;
+        if (!valid) {
+            continue;
+        }
+        const float *row = p_buffer + static_cast<size_t>(instance) * p_stride;
+        const Vector3 &offset = p_offsets[k];
+        const real_t lx = row[0] * offset.x + row[1] * offset.y + row[2] * offset.z + row[3];
+        const real_t ly = row[4] * offset.x + row[5] * offset.y + row[6] * offset.z + row[7];
+        const real_t lz = row[8] * offset.x + row[9] * offset.y + row[10] * offset.z + row[11];
+        r_positions[k] = Vector3(
+                b.rows[0].x * lx + b.rows[0].y * ly + b.rows[0].z * lz + o.x,
+                b.rows[1].x * lx + b.rows[1].y * ly + b.rows[1].z * lz + o.y,
+                b.rows[2].x * lx + b.rows[2].y * ly + b.rows[2].z * lz + o.z);
+    }
+}
+
+} // namespace
+
+bool SensorAttachments::read_multimesh_positions(MultiMeshInstance3D *p_node, const int32_t *p_instances, const Vector3 *p_offsets, size_t p_count, Vector3 *r_positions, uint8_t *r_valid) {
+    if (!p_node || !p_node->is_inside_tree()) {
+        return false;
+    }
+    Ref<MultiMesh> multimesh = p_node->get_multimesh();
+    if (multimesh.is_null() || multimesh->get_transform_format() != MultiMesh::TRANSFORM_3D) {
+        return false;
+    }
+
+    const size_t stride = MULTIMESH_TRANSFORM_FLOATS + (multimesh->is_using_colors() ? 4 : 0) + (multimesh->is_using_custom_data() ? 4 : 0);
+    // The one bulk read: every instance's transform, packed
+    const PackedFloat32Array buffer = multimesh->get_buffer();
+    const int32_t declared_count = multimesh->get_instance_count();
+    const size_t instance_count = declared_count > 0 ? std::min(static_cast<size_t>(declared_count), static_cast<size_t>(buffer.size()) / stride) : 0;
+    _transform_instances(buffer.ptr(), stride, instance_count, p_node->get_global_transform(), p_instances, p_offsets, p_count, r_positions, r_valid);
+    return true;
+}
+
+bool SensorAttachments::read_bone_position(Skeleton3D *p_skeleton, int32_t p_bone, const Vector3 &p_offset, Vector3 &r_position) {
+    if (!p_skeleton || !p_skeleton->is_inside_tree() || p_bone < 0 || p_bone >= p_skeleton->get_bone_count()) {
+        return false;
+    }
+    r_position = p_skeleton->get_global_transform().xform(p_skeleton->get_bone_global_pose(p_bone).xform(p_offset));
+    return true;
+}
+
+SensorAttachments::Source &SensorAttachments::_find_or_add_source(uint64_t p_node_id, SourceKind p_kind) {
+    for (Source &source : sources) {
+        if (source.node_id == p_node_id) {
+            return source;
+        }
+    }
+    sources.emplace_back();
+    sources.back().node_id = p_node_id;
+    sources.back().kind = p_kind;
+    return sources.back();
+}
+
+bool SensorAttachments::has_source(uint64_t p_node_id) const {
+    for (const Source &source : sources) {
+        if (source.node_id == p_node_id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SensorAttachments::add_multimesh(MultiMeshInstance3D *p_node, const int32_t *p_instances, const Vector3 &p_local_offset, const int *p_sensor_ids, size_t p_count) {
+    if (!p_node || p_count == 0) {
+        return;
+    }
+    Source &source = _find_or_add_source(p_node->get_instance_id(), SOURCE_MULTIMESH);
+    source.elements.insert(source.elements.end(), p_instances, p_instances + p_count);
+    source.offsets.insert(source.offsets.end(), p_count, p_local_offset);
+    source.sensor_ids.insert(source.sensor_ids.end(), p_sensor_ids, p_sensor_ids + p_count);
+}
+
+void SensorAttachments::add_bone(Skeleton3D *p_skeleton, int32_t p_bone, const Vector3 &p_local_offset, int p_sensor_id) {
+    if (!p_skeleton) {
+        return;
+    }
+    Source &source = _find_or_add_source(p_skeleton->get_instance_id(), SOURCE_SKELETON);
+    source.elements.push_back(p_bone);
+    source.offsets.push_back(p_local_offset);
+    source.sensor_ids.push_back(p_sensor_id);
+    source.bones_dirty = true;
+}
+
+void SensorAttachments::mark_skeleton_posed(uint64_t p_skeleton_id) {
+    for (Source &source : sources) {
+        if (source.node_id == p_skeleton_id) {
+            source.pose_dirty = true;
+            return;
+        }
+    }
+}
+
+bool SensorAttachments::remove_sensor(int p_sensor_id) {
+    for (size_t s = 0; s < sources.size(); ++s) {
+        Source &source = sources[s];
+        auto it = std::find(source.sensor_ids.begin(), source.sensor_ids.end(), p_sensor_id);
+        if (it == source.sensor_ids.end()) {
+            continue;
+        }
+        // Order within a source does not matter: swap with the last sensor
+        const size_t k = static_cast<size_t>(it - source.sensor_ids.begin());
+        const size_t last = source.sensor_ids.size() - 1;
+        source.sensor_ids[k] = source.sensor_ids[last];
+        source.elements[k] = source.elements[last];
+        source.offsets[k] = source.offsets[last];
+        source.sensor_ids.pop_back();
+        source.elements.pop_back();
+        source.offsets.pop_back();
+        source.bones_dirty = true;
+        if (source.sensor_ids.empty()) {
+            sources.erase(sources.begin() + static_cast<std::ptrdiff_t>(s));
+        }
+        return true;
+    }
+    return false;
+}
+
+void SensorAttachments::clear() {
+    sources.clear();
+    last_fetch_count = 0;
+}
+
+int SensorAttachments::get_sensor_count() const {
+    size_t count = 0;
+    for (const Source &source : sources) {
+        count += source.sensor_ids.size();
+    }
+    return static_cast<int>(count);
+}
+
+void SensorAttachments::gather(std::vector<int> &r_ids, std::vector<Vector3> &r_positions, std::vector<int> &r_orphaned_ids) {
+    last_fetch_count = 0;
+    for (size_t s = 0; s < sources.size();) {
+        Source &source = sources[s];
+        Object *node = ObjectDB::get_instance(source.node_id);
+        if (!node) {
+            r_orphaned_ids.insert(r_orphaned_ids.end(), source.sensor_ids.begin(), source.sensor_ids.end());
+            sources.erase(sources.begin() + static_cast<std::ptrdiff_t>(s));
+            continue;
+        }
+        ++s;
+
+        // A source that cannot be read right now (out of the tree, mesh swapped) keeps its positions
+        if (source.kind == SOURCE_MULTIMESH) {
+            _gather_multimesh(source, node, r_ids, r_positions);
+        } else {
+            _gather_skeleton(source, node, r_ids, r_positions);
+        }
+    }
+}
+
+bool SensorAttachments::_gather_multimesh(Source &p_source, Object *p_node, std::vector<int> &r_ids, std::vector<Vector3> &r_positions) {
+    const size_t count = p_source.sensor_ids.size();
+    scratch_positions.resize(count);
+    scratch_valid.resize(count);
+    if (!read_multimesh_positions(Object::cast_to<MultiMeshInstance3D>(p_node), p_source.elements.data(), p_source.offsets.data(), count, scratch_positions.data(), scratch_valid.data())) {
+        return false;
+    }
+    last_fetch_count++;
+    for (size_t k = 0; k < count; ++k) {
+        if (scratch_valid[k]) {
+            r_ids.push_back(p_source.sensor_ids[k]);
+            r_positions.push_back(scratch_positions[k]);
+        }
+    }
+    return true;
+}
+
+bool SensorAttachments::_gather_skeleton(Source &p_source, Object *p_node, std::vector<int> &r_ids, std::vector<Vector3> &r_positions) {
+    Skeleton3D *skeleton = Object::cast_to<Skeleton3D>(p_node);
+    if (!skeleton || !skeleton->is_inside_tree()) {
+        return false;
+    }
+
+    const size_t count = p_source.sensor_ids.size();
+    if (p_source.bones_dirty) {
+        // Sensors on the same bone share one query
+        p_source.bones.assign(p_source.elements.begin(), p_source.elements.end());
+        std::sort(p_source.bones.begin(), p_source.bones.end());
+        p_source.bones.erase(std::unique(p_source.bones.begin(), p_source.bones.end()), p_source.bones.end());
+        p_source.bone_slots.resize(count);
+        for (size_t k = 0; k < count; ++k) {
+            p_source.bone_slots[k] = static_cast<uint32_t>(std::lower_bound(p_source.bones.begin(), p_source.bones.end(), p_source.elements[k]) - p_source.bones.begin());
+        }
+        p_source.bone_poses.resize(p_source.bones.size());
+        p_source.bones_dirty = false;
+        p_source.pose_dirty = true;
+    }
+
+    const Transform3D node_xform = skeleton->get_global_transform();
+    if (!p_source.pose_dirty && node_xform == p_source.node_xform) {
+        return true; // Neither posed nor moved: the positions stand
+    }
+    if (p_source.pose_dirty) {
+        // The batch for this skeleton: each needed bone's model-space pose, once
+        p_source.bone_count = skeleton->get_bone_count();
+        for (size_t b = 0; b < p_source.bones.size(); ++b) {
+            const int32_t bone = p_source.bones[b];
+            p_source.bone_poses[b] = bone >= 0 && bone < p_source.bone_count ? skeleton->get_bone_global_pose(bone) : Transform3D();
+        }
+        p_source.pose_dirty = false;
+        last_fetch_count++;
+    }
+    p_source.node_xform = node_xform;
+
+    for (size_t k = 0; k < count; ++k) {
+        const int32_t bone = p_source.elements[k];
+        if (bone < 0 || bone >= p_source.bone_count) {
+            continue; // The bone went away with a skeleton rebuild
+        }
+        r_ids.push_back(p_source.sensor_ids[k]);
+        r_positions.push_back(node_xform.xform(p_source.bone_poses[p_source.bone_slots[k]].xform(p_source.offsets[k])));
+    }
+    return true;
+}
@@ -0,0 +1,85 @@
+#ifndef SENSOR_ATTACHMENTS_H
+#define SENSOR_ATTACHMENTS_H
+
+#include <godot_cpp/classes/multi_mesh_instance3d.hpp>
+#include <godot_cpp/classes/skeleton3d.hpp>
+#include <godot_cpp/variant/transform3d.hpp>
+#include <godot_cpp/variant/vector3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+// Sensors attached to parts of a node rather than to a node of their own: the instances of a
+// MultiMeshInstance3D or the bones of a Skeleton3D. Every source is read in one batch per gather
+// and the world positions of all its sensors are computed in one pass over what was read:
+// - MultiMesh: one bulk call (the packed buffer), no per-instance call into the engine.
+// - Skeleton: one global pose query per distinct bone, only after the skeleton reported a new
+//   pose (mark_skeleton_posed()); when only the node moved, the cached poses are reused.
+// Main thread only.
+class SensorAttachments {
+public:
+    // Sensors on one node share a source whatever their offsets, so the node is fetched once
+    void add_multimesh(MultiMeshInstance3D *p_node, const int32_t *p_instances, const Vector3 &p_local_offset, const int *p_sensor_ids, size_t p_count);
+    void add_bone(Skeleton3D *p_skeleton, int32_t p_bone, const Vector3 &p_local_offset, int p_sensor_id);
+    // The skeleton finished posing (its skeleton_updated signal); its bones are read on the next gather
+    void mark_skeleton_posed(uint64_t p_skeleton_id);
+    bool has_source(uint64_t p_node_id) const;
+    bool remove_sensor(int p_sensor_id);
+    void clear();
+    int get_source_count() const { return static_cast<int>(sources.size()); }
+    int get_sensor_count() const;
+
+    // World positions of every attached sensor whose element still exists. Sources whose node
+    // was freed are dropped and their sensors appended to r_orphaned_ids.
+    void gather(std::vector<int> &r_ids, std::vector<Vector3> &r_positions, std::vector<int> &r_orphaned_ids);
+    // Sources whose node the last gather read from the engine (unchanged skeletons are not read)
+    uint32_t get_last_fetch_count() const { return last_fetch_count; }
+
+    // World positions of p_offset on the given instances; r_valid[k] is 0 for instances out of range.
+    // False when the node has no 3D MultiMesh.
+    static bool read_multimesh_positions(MultiMeshInstance3D *p_node, const int32_t *p_instances, const Vector3 *p_offsets, size_t p_count, Vector3 *r_positions, uint8_t *r_valid);
+    // World position of p_offset on one bone; false for an invalid bone or a skeleton out of the tree
+    static bool read_bone_position(Skeleton3D *p_skeleton, int32_t p_bone, const Vector3 &p_offset, Vector3 &r_position);
+
+private:
+    enum SourceKind : uint8_t {
+        SOURCE_MULTIMESH,
+        SOURCE_SKELETON,
+    };
+
+    struct Source {
+        uint64_t node_id = 0;
+        SourceKind kind = SOURCE_MULTIMESH;
+        std::vector<int32_t> elements; // Instance or bone index, per sensor
+        std::vector<Vector3> offsets; // In the element's space, per sensor
+        std::vector<int> sensor_ids;
+
+        // Skeleton sources: distinct bones, each sensor's slot among them and their last poses
+        std::vector<int32_t> bones;
+        std::vector<uint32_t> bone_slots;
+        std::vector<Transform3D> bone_poses;
+        Transform3D node_xform; // Global transform the current positions were computed with
+        int32_t bone_count = 0; // At the last pose read
+        bool bones_dirty = true; // Sensors changed: rebuild bones and bone_slots
+        bool pose_dirty = true; // New pose reported, or never read
+    };
+
+    std::vector<Source> sources;
+    uint32_t last_fetch_count = 0;
+
+    // Scratch reused across gathers
+    std::vector<Vector3> scratch_positions;
+    std::vector<uint8_t> scratch_valid;
+
+    Source &_find_or_add_source(uint64_t p_node_id, SourceKind p_kind);
+    // Appends the source's positions; false when the node cannot be read this gather
+    bool _gather_multimesh(Source &p_source, Object *p_node, std::vector<int> &r_ids, std::vector<Vector3> &r_positions);
+    bool _gather_skeleton(Source &p_source, Object *p_node, std::vector<int> &r_ids, std::vector<Vector3> &r_positions);
+};
+
+} // namespace godot
+
+#endif // SENSOR_ATTACHMENTS_H
@@ -0,0 +1,18 @@
+#ifndef SENSOR_CLOCK_H
+#define SENSOR_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace godot {
+
+// Monotonic microseconds (steady_clock). The time base of every reading, batch and recording
+// timestamp, so values from different parts of the addon can be compared and subtracted.
+inline uint64_t sensor_steady_usec() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace godot
+
+#endif // SENSOR_CLOCK_H
@@ -0,0 +1,43 @@
+#include "sensor_color_space.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+using namespace godot;
+
+namespace {
+
+std::array<float, 256> _build_srgb8_table() {
+    std::array<float, 256> table;
+    for (int i = 0; i < 256; ++i) {
+        const float c = static_cast<float>(i) / 255.0f;
+        table[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+    return table;
+}
+
+} // namespace
+
+const float *godot::sensor_srgb8_to_linear_table() {
+    // Function-local static: thread-safe initialization for worker jobs
+    static const std::array<float, 256> table = _build_srgb8_table();
+    return table.data();
+}
+
+const uint16_t *godot::sensor_srgb8_to_linear_u16_table() {
+    static const std::array<uint16_t, 256> table = []() {
+        const float *linear = sensor_srgb8_to_linear_table();
+        std::array<uint16_t, 256> fixed;
+        for (int i = 0; i < 256; ++i) {
+            fixed[i] = static_cast<uint16_t>(std::lround(linear[i] * 65535.0f));
+        }
+        return fixed;
+    }();
+    return table.data();
+}
+
+float godot::sensor_linear_to_srgb(float p_value) {
+    const float c = std::clamp(p_value, 0.0f, 1.0f);
+    return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+}
@@ -0,0 +1,49 @@
+#ifndef SENSOR_COLOR_SPACE_H
+#define SENSOR_COLOR_SPACE_H
+
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/variant/color.hpp>
+
+#include <cstdint>
+
+namespace godot {
+
+// How sampled pixels are combined. 8-bit viewport textures hold sRGB-encoded values;
+// averaging those directly biases readings dark wherever bright and dark pixels mix.
+enum SensorColorMode : uint32_t {
+    SENSOR_COLOR_ENCODED = 0, // Average the stored values as is (legacy behaviour)
+    SENSOR_COLOR_LINEAR = 1, // Decode to linear light, average, return linear
+    SENSOR_COLOR_LINEAR_SRGB = 2, // Decode to linear light, average, re-encode to sRGB
+};
+
+inline SensorColorMode sensor_color_mode(bool p_linear_averaging, bool p_linear_output) {
+    if (!p_linear_averaging) {
+        return SENSOR_COLOR_ENCODED;
+    }
+    return p_linear_output ? SENSOR_COLOR_LINEAR : SENSOR_COLOR_LINEAR_SRGB;
+}
+
+// Float (HDR) image formats hold linear values; every other format is read as sRGB-encoded
+inline bool sensor_is_float_format(Image::Format p_format) {
+    return (p_format >= Image::FORMAT_RF && p_format <= Image::FORMAT_RGBAH) || p_format == Image::FORMAT_RGBE9995;
+}
+
+// 256-entry sRGB -> linear table for 8-bit channels, built once on first use
+const float *sensor_srgb8_to_linear_table();
+// Same table in 16-bit fixed point (linear * 65535), for integer accumulation
+const uint16_t *sensor_srgb8_to_linear_u16_table();
+
+// Exact linear -> sRGB encode; applied once per result, not per pixel
+float sensor_linear_to_srgb(float p_value);
+
+// Turn a linear-light average into the requested output encoding
+inline Color sensor_finish_linear_average(float p_r, float p_g, float p_b, SensorColorMode p_mode) {
+    if (p_mode == SENSOR_COLOR_LINEAR_SRGB) {
+        return Color(sensor_linear_to_srgb(p_r), sensor_linear_to_srgb(p_g), sensor_linear_to_srgb(p_b), 1.0f);
+    }
+    return Color(p_r, p_g, p_b, 1.0f);
+}
+
+} // namespace godot
+
+#endif // SENSOR_COLOR_SPACE_H
@@ -0,0 +1,351 @@
+#include "sensor_probe_field.h"
+
+#include <godot_cpp/classes/viewport_texture.hpp>
+#include <godot_cpp/variant/basis.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/transform3d.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace godot;
+
+namespace {
+
+const Vector3 FACE_DIRECTIONS[SensorProbeField::FACE_COUNT] = {
+    Vector3(1, 0, 0), Vector3(-1, 0, 0),
+    Vector3(0, 1, 0), Vector3(0, -1, 0),
+    Vector3(0, 0, 1), Vector3(0, 0, -1),
+};
+
+// Up vectors that are never parallel to the face direction
+const Vector3 FACE_UPS[SensorProbeField::FACE_COUNT] = {
+    Vector3(0, 1, 0), Vector3(0, 1, 0),
+    Vector3(0, 0, -1), Vector3(0, 0, 1),
+    Vector3(0, 1, 0), Vector3(0, 1, 0),
+};
+
+constexpr uint8_t ALL_FACES = (1u << SensorProbeField::FACE_COUNT) - 1;
+
+Color _encode(const Color &p_linear, SensorColorMode p_mode) {
+    return sensor_finish_linear_average(p_linear.r, p_linear.g, p_linear.b, p_mode);
+}
+
+} // namespace
+
+void SensorProbeField::release_rigs() {
+    for (Rig &rig : rigs) {
+        if (rig.viewport) {
+            rig.viewport->queue_free(); // Frees the camera with it
+        }
+    }
+    rigs.clear();
+}
+
+void SensorProbeField::add_probe(int p_sensor_id, const Vector3 &p_world_position, const String &p_label) {
+    Probe &probe = probes[p_sensor_id];
+    probe.world_position = p_world_position;
+    probe.label = p_label;
+    _rebuild_clusters();
+}
+
+bool SensorProbeField::remove_probe(int p_sensor_id) {
+    if (probes.erase(p_sensor_id) == 0) {
+        return false;
+    }
+    _rebuild_clusters();
+    return true;
+}
+
+bool SensorProbeField::has_probe(int p_sensor_id) const {
+    return probes.find(p_sensor_id) != probes.end();
+}
+
+void SensorProbeField::clear() {
+    probes.clear();
+    clusters.clear();
+    cluster_order.clear();
+    next_cluster = 0;
+    next_face = 0;
+    for (Rig &rig : rigs) {
+        rig.face = -1;
+    }
+}
+
+void SensorProbeField::set_cluster_size(float p_size) {
+    const float size = std::max(0.1f, p_size);
+    if (size != cluster_size) {
+        cluster_size = size;
+        _rebuild_clusters();
+    }
+}
+
+void SensorProbeField::set_face_resolution(int p_pixels) {
+    face_resolution = std::clamp(p_pixels, 4, 128);
+    for (Rig &rig : rigs) {
+        if (rig.viewport) {
+            rig.viewport->set_size(Vector2i(face_resolution, face_resolution));
+        }
+    }
+}
+
+void SensorProbeField::set_faces_per_frame(int p_faces) {
+    faces_per_frame = std::clamp(p_faces, 1, 64);
+    // Surplus rigs are freed; a face they had in flight is simply rendered again later
+    while (static_cast<int>(rigs.size()) > faces_per_frame) {
+        if (rigs.back().viewport) {
+            rigs.back().viewport->queue_free();
+        }
+        rigs.pop_back();
+    }
+}
+
+void SensorProbeField::tick(const Ref<World3D> &p_world, uint64_t p_frame, std::vector<int> &r_updated_ids) {
+    if (probes.empty() || p_world.is_null() || !owner) {
+        return;
+    }
+
+    updated_clusters.clear();
+    _collect(p_frame);
+    _schedule(p_world, p_frame);
+
+    if (updated_clusters.empty()) {
+        return;
+    }
+    for (const auto &entry : probes) {
+        auto it = clusters.find(entry.second.cluster_key);
+        if (it == clusters.end() || it->second.captured_mask != ALL_FACES) {
+            continue;
+        }
+        if (std::find(updated_clusters.begin(), updated_clusters.end(), entry.second.cluster_key) != updated_clusters.end()) {
+            r_updated_ids.push_back(entry.first);
+        }
+    }
+}
+
+bool SensorProbeField::get_probe_color(int p_sensor_id, SensorColorMode p_mode, Color &r_color) const {
+    const Cluster *cluster = _find_complete_cluster(p_sensor_id);
+    if (!cluster) {
+        return false;
+    }
+    Color sum(0, 0, 0, 0);
+    for (int f = 0; f < FACE_COUNT; ++f) {
+        sum += cluster->faces[f];
+    }
+    r_color = _encode(sum / static_cast<float>(FACE_COUNT), p_mode);
+    return true;
+}
+
+bool SensorProbeField::get_probe_faces(int p_sensor_id, SensorColorMode p_mode, Color *r_faces) const {
+    const Cluster *cluster = _find_complete_cluster(p_sensor_id);
+    if (!cluster) {
+        return false;
+    }
+    for (int f = 0; f < FACE_COUNT; ++f) {
+        r_faces[f] = _encode(cluster->faces[f], p_mode);
+    }
+    return true;
+}
+
+bool SensorProbeField::sample_probe_direction(int p_sensor_id, const Vector3 &p_direction, SensorColorMode p_mode, Color &r_color) const {
+    const Cluster *cluster = _find_complete_cluster(p_sensor_id);
+    if (!cluster || p_direction.length_squared() == 0.0f) {
+        return false;
+    }
+    // Ambient cube: squared components weight the face on each axis' side; they sum to 1
+    const Vector3 n = p_direction.normalized();
+    const Vector3 n2 = n * n;
+    const Color linear = cluster->faces[n.x >= 0.0f ? 0 : 1] * n2.x +
+            cluster->faces[n.y >= 0.0f ? 2 : 3] * n2.y +
+            cluster->faces[n.z >= 0.0f ? 4 : 5] * n2.z;
+    r_color = _encode(linear, p_mode);
+    return true;
+}
+
+bool SensorProbeField::get_probe_info(int p_sensor_id, Vector3 &r_world_position, String &r_label, uint64_t &r_frame) const {
+    auto it = probes.find(p_sensor_id);
+    if (it == probes.end()) {
+        return false;
+    }
+    r_world_position = it->second.world_position;
+    r_label = it->second.label;
+    auto cluster = clusters.find(it->second.cluster_key);
+    r_frame = cluster != clusters.end() ? cluster->second.frame : 0;
+    return true;
+}
+
+int64_t SensorProbeField::_cluster_key(const Vector3 &p_position) const {
+    // 21 bits per axis, wrapping: cells 2M apart share a key, which only merges clusters
+    const int64_t x = static_cast<int64_t>(std::floor(p_position.x / cluster_size)) & 0x1FFFFF;
+    const int64_t y = static_cast<int64_t>(std::floor(p_position.y / cluster_size)) & 0x1FFFFF;
+    const int64_t z = static_cast<int64_t>(std::floor(p_position.z / cluster_size)) & 0x1FFFFF;
+    return (x << 42) | (y << 21) | z;
+}
+
+void SensorProbeField::_rebuild_clusters() {
+    // Existing readings survive for cells that still hold probes
+    for (auto &entry : clusters) {
+        entry.second.position_sum = Vector3();
+        entry.second.probe_count = 0;
+    }
+    for (auto &entry : probes) {
+        Probe &probe = entry.second;
+        probe.cluster_key = _cluster_key(probe.world_position);
+        Cluster &cluster = clusters[probe.cluster_key];
+        cluster.position_sum += probe.world_position;
+        cluster.probe_count++;
+    }
+    for (auto it = clusters.begin(); it != clusters.end();) {
+        it = it->second.probe_count == 0 ? clusters.erase(it) : std::next(it);
+    }
+
+    cluster_order.clear();
+    for (const auto &entry : clusters) {
+        cluster_order.push_back(entry.first);
+    }
+    // Stable round-robin order regardless of hash layout
+    std::sort(cluster_order.begin(), cluster_order.end());
+    if (next_cluster >= cluster_order.size()) {
+        next_cluster = 0;
+        next_face = 0;
+    }
+}
+
+void SensorProbeField::_ensure_rigs() {
+    while (static_cast<int>(rigs.size()) < faces_per_frame) {
+        Rig rig;
+        rig.viewport = memnew(SubViewport);
+        rig.viewport->set_name("LightSensorProbeFace");
+        rig.viewport->set_size(Vector2i(face_resolution, face_resolution));
+        // A handful of pixels per face: no AA or debanding, coarse LOD, no input
+        rig.viewport->set_msaa_3d(Viewport::MSAA_DISABLED);
+        rig.viewport->set_screen_space_aa(Viewport::SCREEN_SPACE_AA_DISABLED);
+        rig.viewport->set_use_taa(false);
+        rig.viewport->set_use_debanding(false);
+        rig.viewport->set_mesh_lod_threshold(8.0f);
+        rig.viewport->set_disable_input(true);
+        rig.viewport->set_update_mode(SubViewport::UPDATE_DISABLED);
+
+        rig.camera = memnew(Camera3D);
+        rig.camera->set_fov(90.0f);
+        rig.camera->set_keep_aspect_mode(Camera3D::KEEP_HEIGHT);
+        rig.viewport->add_child(rig.camera);
+        owner->add_child(rig.viewport);
+        rig.camera->set_current(true);
+        rigs.push_back(rig);
+    }
+}
+
+void SensorProbeField::_collect(uint64_t p_frame) {
+    for (Rig &rig : rigs) {
+        if (rig.face < 0 || rig.scheduled_frame >= p_frame) {
+            continue; // Idle, or rendering at the end of this frame
+        }
+        const int face = rig.face;
+        rig.face = -1;
+
+        auto it = clusters.find(rig.cluster_key);
+        Ref<ViewportTexture> texture = rig.viewport->get_texture();
+        if (it == clusters.end() || texture.is_null()) {
+            faces_dropped++; // Cluster removed while the face was in flight
+            continue;
+        }
+        // A face is only a few hundred pixels, so the synchronous readback stays cheap
+        Ref<Image> image = texture->get_image();
+        if (image.is_null() || image->is_empty()) {
+            faces_dropped++;
+            continue;
+        }
+
+        Cluster &cluster = it->second;
+        cluster.faces[face] = _reduce_face(image);
+        cluster.captured_mask |= static_cast<uint8_t>(1u << face);
+        cluster.frame = p_frame;
+        faces_captured++;
+        if (std::find(updated_clusters.begin(), updated_clusters.end(), rig.cluster_key) == updated_clusters.end()) {
+            updated_clusters.push_back(rig.cluster_key);
+        }
+    }
+}
+
+void SensorProbeField::_schedule(const Ref<World3D> &p_world, uint64_t p_frame) {
+    if (cluster_order.empty()) {
+        return;
+    }
+    _ensure_rigs();
+
+    // Never render the same face twice in one frame, even with a budget above the face count
+    const size_t total_faces = cluster_order.size() * FACE_COUNT;
+    size_t scheduled = 0;
+    for (Rig &rig : rigs) {
+        if (rig.face >= 0 || scheduled >= total_faces) {
+            continue;
+        }
+
+        const int64_t key = cluster_order[next_cluster];
+        const Cluster &cluster = clusters[key];
+        const Vector3 center = cluster.position_sum / static_cast<float>(cluster.probe_count);
+
+        if (rig.viewport->get_world_3d() != p_world) {
+            rig.viewport->set_world_3d(p_world);
+        }
+        rig.camera->set_far(far_plane);
+        rig.camera->set_global_transform(Transform3D(Basis::looking_at(FACE_DIRECTIONS[next_face], FACE_UPS[next_face]), center));
+        rig.viewport->set_update_mode(SubViewport::UPDATE_ONCE);
+        rig.cluster_key = key;
+        rig.face = next_face;
+        rig.scheduled_frame = p_frame;
+        scheduled++;
+
+        if (++next_face == FACE_COUNT) {
+            next_face = 0;
+            next_cluster = (next_cluster + 1) % cluster_order.size();
+        }
+    }
+}
+
+Color SensorProbeField::_reduce_face(const Ref<Image> &p_image) const {
+    // Float (HDR) faces are already linear; 8-bit ones are decoded through the sRGB table
+    const Image::Format format = p_image->get_format();
+    const bool linear_source = sensor_is_float_format(format);
+    if (format != Image::FORMAT_RGBA8) {
+        p_image->convert(Image::FORMAT_RGBA8);
+    }
+
+    const PackedByteArray data = p_image->get_data();
+    const size_t pixels = static_cast<size_t>(data.size()) / 4;
+    if (pixels == 0) {
+        return Color(0, 0, 0, 1);
+    }
+
+    const uint8_t *px = data.ptr();
+    const float *lut = sensor_srgb8_to_linear_table();
+    float sum_r = 0.0f;
+    float sum_g = 0.0f;
+    float sum_b = 0.0f;
+    for (size_t i = 0; i < pixels; ++i, px += 4) {
+        if (linear_source) {
+            sum_r += px[0] / 255.0f;
+            sum_g += px[1] / 255.0f;
+            sum_b += px[2] / 255.0f;
+        } else {
+            sum_r += lut[px[0]];
+            sum_g += lut[px[1]];
+            sum_b += lut[px[2]];
+        }
+    }
+    const float inv = 1.0f / static_cast<float>(pixels);
+    return Color(sum_r * inv, sum_g * inv, sum_b * inv, 1.0f);
+}
+
+const SensorProbeField::Cluster *SensorProbeField::_find_complete_cluster(int p_sensor_id) const {
+    auto probe = probes.find(p_sensor_id);
+    if (probe == probes.end()) {
+        return nullptr;
+    }
+    auto cluster = clusters.find(probe->second.cluster_key);
+    if (cluster == clusters.end() || cluster->second.captured_mask != ALL_FACES) {
+        return nullptr;
+    }
+    return &cluster->second;
+}
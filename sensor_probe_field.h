@@ -0,0 +1,126 @@
+#ifndef SENSOR_PROBE_FIELD_H
+#define SENSOR_PROBE_FIELD_H
+
+#include <godot_cpp/classes/camera3d.hpp>
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/classes/sub_viewport.hpp>
+#include <godot_cpp/classes/world3d.hpp>
+#include <godot_cpp/variant/color.hpp>
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/vector3.hpp>
+
+#include "sensor_color_space.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace godot {
+
+// Omnidirectional probe sensors, independent of what the player camera sees.
+// Probes are grouped into clusters on a world-space grid. Each cluster owns a tiny cube
+// capture (six 90-degree faces) that is rendered on a round-robin schedule: every tick at
+// most faces_per_frame faces are rendered, through a fixed pool of SubViewport rigs, so the
+// cost is bounded no matter how many probes exist. A face rendered on one frame is read back
+// (a few hundred pixels) and reduced to a linear-light mean on the next.
+// Main thread only: owns scene nodes.
+class SensorProbeField {
+public:
+    // Face order matches Godot cubemaps: +X, -X, +Y, -Y, +Z, -Z
+    static constexpr int FACE_COUNT = 6;
+
+    SensorProbeField() = default;
+    ~SensorProbeField() = default;
+
+    SensorProbeField(const SensorProbeField &) = delete;
+    SensorProbeField &operator=(const SensorProbeField &) = delete;
+
+    // Rigs are created as children of p_owner on demand
+    void set_owner(Node *p_owner) { owner = p_owner; }
+    // Frees the capture rigs; probes and cluster readings are kept
+    void release_rigs();
+
+    void add_probe(int p_sensor_id, const Vector3 &p_world_position, const String &p_label);
+    bool remove_probe(int p_sensor_id);
+    bool has_probe(int p_sensor_id) const;
+    void clear();
+    int get_probe_count() const { return static_cast<int>(probes.size()); }
+    int get_cluster_count() const { return static_cast<int>(cluster_order.size()); }
+
+    void set_cluster_size(float p_size);
+    float get_cluster_size() const { return cluster_size; }
+    void set_face_resolution(int p_pixels);
+    int get_face_resolution() const { return face_resolution; }
+    void set_faces_per_frame(int p_faces);
+    int get_faces_per_frame() const { return faces_per_frame; }
+    void set_far(float p_far) { far_plane = p_far; }
+    float get_far() const { return far_plane; }
+
+    // Reads back the faces rendered last frame, then schedules the next ones. Appends the ids of
+    // probes whose cluster received new face data and has been captured completely at least once.
+    void tick(const Ref<World3D> &p_world, uint64_t p_frame, std::vector<int> &r_updated_ids);
+
+    // Mean over all faces, in p_mode's output encoding. False for unknown or not yet captured probes.
+    bool get_probe_color(int p_sensor_id, SensorColorMode p_mode, Color &r_color) const;
+    // The six face means (+X, -X, +Y, -Y, +Z, -Z)
+    bool get_probe_faces(int p_sensor_id, SensorColorMode p_mode, Color *r_faces) const;
+    // Light arriving from p_direction, blended from the faces as an ambient cube
+    bool sample_probe_direction(int p_sensor_id, const Vector3 &p_direction, SensorColorMode p_mode, Color &r_color) const;
+    bool get_probe_info(int p_sensor_id, Vector3 &r_world_position, String &r_label, uint64_t &r_frame) const;
+
+    uint64_t get_faces_captured() const { return faces_captured; }
+    uint64_t get_faces_dropped() const { return faces_dropped; }
+
+private:
+    struct Probe {
+        Vector3 world_position;
+        String label;
+        int64_t cluster_key = 0;
+    };
+
+    struct Cluster {
+        Vector3 position_sum;
+        int probe_count = 0;
+        Color faces[FACE_COUNT]; // Linear light
+        uint8_t captured_mask = 0; // Faces captured at least once
+        uint64_t frame = 0; // Frame of the newest face
+    };
+
+    struct Rig {
+        SubViewport *viewport = nullptr;
+        Camera3D *camera = nullptr;
+        int64_t cluster_key = 0;
+        int face = -1; // -1: idle
+        uint64_t scheduled_frame = 0;
+    };
+
+    Node *owner = nullptr;
+    float cluster_size = 4.0f;
+    int face_resolution = 16;
+    int faces_per_frame = 6;
+    float far_plane = 100.0f;
+
+    std::unordered_map<int, Probe> probes;
+    std::unordered_map<int64_t, Cluster> clusters;
+    std::vector<int64_t> cluster_order; // Round-robin order
+    size_t next_cluster = 0;
+    int next_face = 0;
+    std::vector<Rig> rigs;
+    std::vector<int64_t> updated_clusters; // Scratch
+
+    uint64_t faces_captured = 0;
+    uint64_t faces_dropped = 0;
+
+    int64_t _cluster_key(const Vector3 &p_position) const;
+    void _rebuild_clusters();
+    void _ensure_rigs();
+    void _collect(uint64_t p_frame);
+    void _schedule(const Ref<World3D> &p_world, uint64_t p_frame);
+    Color _reduce_face(const Ref<Image> &p_image) const;
+    const Cluster *_find_complete_cluster(int p_sensor_id) const;
+};
+
+} // namespace godot
+
+#endif // SENSOR_PROBE_FIELD_H
@@ -0,0 +1,87 @@
+#include "sensor_projection.h"
+
+#include <godot_cpp/variant/projection.hpp>
+#include <godot_cpp/variant/transform3d.hpp>
+
+using namespace godot;
+
+bool SensorProjection::setup(Camera3D *p_camera, const Vector2 &p_viewport_size) {
+    valid = false;
+    if (!p_camera || p_viewport_size.x <= 0 || p_viewport_size.y <= 0) {
+        return false;
+    }
+
+    const Transform3D view = p_camera->get_camera_transform().affine_inverse();
+    const Projection proj = p_camera->get_camera_projection();
+
+    // View matrix as 4x4 rows
+    float v[16] = {
+        (float)view.basis.rows[0][0], (float)view.basis.rows[0][1], (float)view.basis.rows[0][2], (float)view.origin.x,
+        (float)view.basis.rows[1][0], (float)view.basis.rows[1][1], (float)view.basis.rows[1][2], (float)view.origin.y,
+        (float)view.basis.rows[2][0], (float)view.basis.rows[2][1], (float)view.basis.rows[2][2], (float)view.origin.z,
+        0.0f, 0.0f, 0.0f, 1.0f
+    };
+
+    // Projection stores columns; m = P * V in row-major order
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            float acc = 0.0f;
+            for (int k = 0; k < 4; ++k) {
+                acc += (float)proj.columns[k][r] * v[k * 4 + c];
+            }
+            m[r * 4 + c] = acc;
+        }
+    }
+
+    for (int c = 0; c < 4; ++c) {
+        view_z[c] = v[8 + c];
+    }
+    near_plane = (float)p_camera->get_near();
+    viewport_size = p_viewport_size;
+    valid = true;
+    return true;
+}
+
+bool SensorProjection::project(const Vector3 &p_world, Vector2 &r_screen) const {
+    uint8_t visible = 0;
+    project_batch(&p_world, 1, &r_screen, &visible);
+    return visible != 0;
+}
+
+void SensorProjection::project_batch(const Vector3 *p_world, size_t p_count, Vector2 *r_screen, uint8_t *r_visible) const {
+    if (!valid) {
+        for (size_t i = 0; i < p_count; ++i) {
+            r_visible[i] = 0;
+        }
+        return;
+    }
+
+    const float w_size = (float)viewport_size.x;
+    const float h_size = (float)viewport_size.y;
+    for (size_t i = 0; i < p_count; ++i) {
+        const float x = (float)p_world[i].x;
+        const float y = (float)p_world[i].y;
+        const float z = (float)p_world[i].z;
+
+        // Same test as Camera3D::is_position_behind(): distance along the view direction < near
+        const float depth = -(view_z[0] * x + view_z[1] * y + view_z[2] * z + view_z[3]);
+        if (depth < near_plane) {
+            r_visible[i] = 0;
+            continue;
+        }
+
+        const float cx = m[0] * x + m[1] * y + m[2] * z + m[3];
+        const float cy = m[4] * x + m[5] * y + m[6] * z + m[7];
+        const float cw = m[12] * x + m[13] * y + m[14] * z + m[15];
+        if (cw == 0.0f) {
+            r_visible[i] = 0;
+            continue;
+        }
+
+        const float inv_w = 1.0f / cw;
+        const float sx = (cx * inv_w * 0.5f + 0.5f) * w_size;
+        const float sy = (-cy * inv_w * 0.5f + 0.5f) * h_size;
+        r_screen[i] = Vector2(sx, sy);
+        r_visible[i] = (sx >= 0.0f && sy >= 0.0f && sx < w_size && sy < h_size) ? 1 : 0;
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef SENSOR_PROJECTION_H
+#define SENSOR_PROJECTION_H
+
+#include <godot_cpp/classes/camera3d.hpp>
+#include <godot_cpp/variant/vector2.hpp>
+#include <godot_cpp/variant/vector3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace godot {
+
+// World -> screen projection for many points at once.
+// The camera's view-projection matrix is fetched once per pass (two Godot API calls)
+// and every point is then projected with plain float math, instead of calling
+// Camera3D::unproject_position() across the GDExtension boundary for each sensor.
+// Results match unproject_position(); points behind the near plane or outside the
+// viewport are reported as not visible.
+struct SensorProjection {
+    float m[16] = {}; // Row-major projection * view
+    float view_z[4] = {}; // Row of the view matrix giving camera-space z
+    float near_plane = 0.05f;
+    Vector2 viewport_size;
+    bool valid = false;
+
+    // Capture the camera state. p_viewport_size is the visible rect size of the camera's viewport.
+    bool setup(Camera3D *p_camera, const Vector2 &p_viewport_size);
+
+    // Project a single point. Returns false when the point is behind the camera or off-screen;
+    // r_screen is still written for points in front of the camera.
+    bool project(const Vector3 &p_world, Vector2 &r_screen) const;
+
+    // Project p_count points. r_visible[i] is 1 when r_screen[i] lies inside the viewport.
+    void project_batch(const Vector3 *p_world, size_t p_count, Vector2 *r_screen, uint8_t *r_visible) const;
+};
+
+} // namespace godot
+
+#endif // SENSOR_PROJECTION_H
@@ -0,0 +1,139 @@
+#include "sensor_rate_controller.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace godot;
+
+namespace {
+
+// Weight of the newest reading in the running mean and variance (about the last 4-8 samples)
+constexpr float VOLATILITY_ALPHA = 0.25f;
+
+} // namespace
+
+void SensorRateController::set_floor_hz(double p_hz) {
+    floor_hz = std::max(0.01, p_hz);
+    ceiling_hz = std::max(ceiling_hz, floor_hz);
+}
+
+void SensorRateController::set_ceiling_hz(double p_hz) {
+    ceiling_hz = std::max(floor_hz, p_hz);
+}
+
+void SensorRateController::set_sample_budget(double p_samples_per_second) {
+    sample_budget = std::max(0.0, p_samples_per_second);
+}
+
+void SensorRateController::set_volatility_scale(float p_scale) {
+    volatility_scale = std::max(1e-4f, p_scale);
+}
+
+void SensorRateController::add() {
+    // New sensors start due, at the ceiling, until they have a history
+    Slot slot;
+    slot.rate = ceiling_hz;
+    slot.since_dispatch = 1.0 / ceiling_hz;
+    slots.push_back(slot);
+}
+
+void SensorRateController::remove(size_t p_index) {
+    if (p_index < slots.size()) {
+        slots.erase(slots.begin() + static_cast<std::ptrdiff_t>(p_index));
+    }
+}
+
+void SensorRateController::clear() {
+    slots.clear();
+    total_rate = 0.0;
+}
+
+double SensorRateController::_desired_rate(const Slot &p_slot) const {
+    if (!p_slot.observed) {
+        return ceiling_hz;
+    }
+    const float t = std::min(1.0f, std::sqrt(p_slot.variance) / volatility_scale);
+    return floor_hz + (ceiling_hz - floor_hz) * static_cast<double>(t);
+}
+
+void SensorRateController::_assign_rates() {
+    const size_t count = slots.size();
+    double desired_total = 0.0;
+    for (Slot &slot : slots) {
+        slot.rate = _desired_rate(slot);
+        desired_total += slot.rate;
+    }
+    total_rate = desired_total;
+    if (sample_budget <= 0.0 || desired_total <= sample_budget || count == 0) {
+        return;
+    }
+
+    const double floor_total = floor_hz * static_cast<double>(count);
+    if (floor_total >= sample_budget) {
+        // Not even the floors fit: everyone shares the budget equally
+        const double rate = sample_budget / static_cast<double>(count);
+        for (Slot &slot : slots) {
+            slot.rate = rate;
+        }
+        total_rate = sample_budget;
+        return;
+    }
+
+    // Floors are kept; what is left is shared in proportion to each sensor's claim above it
+    const double headroom = (sample_budget - floor_total) / (desired_total - floor_total);
+    for (Slot &slot : slots) {
+        slot.rate = floor_hz + (slot.rate - floor_hz) * headroom;
+    }
+    total_rate = sample_budget;
+}
+
+size_t SensorRateController::advance(double p_delta, std::vector<uint8_t> &r_due) {
+    _assign_rates();
+    r_due.resize(slots.size());
+    size_t due = 0;
+    for (size_t i = 0; i < slots.size(); ++i) {
+        Slot &slot = slots[i];
+        slot.since_dispatch += p_delta;
+        const bool is_due = slot.since_dispatch * slot.rate >= 1.0;
+        r_due[i] = is_due ? 1 : 0;
+        due += is_due ? 1 : 0;
+    }
+    return due;
+}
+
+void SensorRateController::mark_dispatched(const std::vector<uint8_t> &p_due) {
+    if (p_due.empty()) {
+        for (Slot &slot : slots) {
+            slot.since_dispatch = 0.0;
+        }
+        return;
+    }
+    const size_t count = std::min(p_due.size(), slots.size());
+    for (size_t i = 0; i < count; ++i) {
+        if (p_due[i]) {
+            slots[i].since_dispatch = 0.0;
+        }
+    }
+}
+
+void SensorRateController::observe(size_t p_index, const Color &p_color) {
+    if (p_index >= slots.size()) {
+        return;
+    }
+    Slot &slot = slots[p_index];
+    const float luminance = 0.299f * p_color.r + 0.587f * p_color.g + 0.114f * p_color.b;
+    if (!slot.observed) {
+        slot.mean = luminance;
+        slot.variance = 0.0f;
+        slot.observed = true;
+        return;
+    }
+    // Incremental exponentially weighted mean and variance
+    const float diff = luminance - slot.mean;
+    slot.mean += VOLATILITY_ALPHA * diff;
+    slot.variance = (1.0f - VOLATILITY_ALPHA) * (slot.variance + VOLATILITY_ALPHA * diff * diff);
+}
+
+double SensorRateController::get_rate(size_t p_index) const {
+    return p_index < slots.size() ? slots[p_index].rate : 0.0;
+}
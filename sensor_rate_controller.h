@@ -0,0 +1,70 @@
+#ifndef SENSOR_RATE_CONTROLLER_H
+#define SENSOR_RATE_CONTROLLER_H
+
+#include <godot_cpp/variant/color.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+// Per-sensor sampling rates driven by how much each reading has been moving.
+// Each sensor keeps an exponentially weighted mean and variance of its luminance. A steady
+// sensor drifts down to floor_hz; one whose standard deviation reaches volatility_scale runs at
+// ceiling_hz. When the rates add up to more than sample_budget samples per second, the
+// part above the floor is scaled down to fit (and the floor itself if it alone is too much).
+// Slots mirror the owner's sensor array: add/remove/clear must follow its insertions and erases.
+// Not thread-safe; the owner serializes access.
+class SensorRateController {
+public:
+    void set_floor_hz(double p_hz);
+    double get_floor_hz() const { return floor_hz; }
+    void set_ceiling_hz(double p_hz);
+    double get_ceiling_hz() const { return ceiling_hz; }
+    // Total samples per second across all sensors; 0: unlimited
+    void set_sample_budget(double p_samples_per_second);
+    double get_sample_budget() const { return sample_budget; }
+    // Luminance standard deviation that earns the ceiling rate
+    void set_volatility_scale(float p_scale);
+    float get_volatility_scale() const { return volatility_scale; }
+
+    void add();
+    void remove(size_t p_index);
+    void clear();
+    size_t size() const { return slots.size(); }
+
+    // Advance every sensor's clock, recompute rates and mark which sensors are due a sample.
+    // Returns the number due.
+    size_t advance(double p_delta, std::vector<uint8_t> &r_due);
+    // The due sensors were handed to a capture: restart their clocks. Empty: every sensor.
+    void mark_dispatched(const std::vector<uint8_t> &p_due);
+    // Feed a measured reading into the sensor's volatility estimate
+    void observe(size_t p_index, const Color &p_color);
+
+    double get_rate(size_t p_index) const;
+    double get_total_rate() const { return total_rate; }
+
+private:
+    struct Slot {
+        double since_dispatch = 0.0; // Seconds since the last sample was dispatched
+        double rate = 0.0; // Effective rate in Hz
+        float mean = 0.0f;
+        float variance = 0.0f;
+        bool observed = false;
+    };
+
+    double floor_hz = 1.0;
+    double ceiling_hz = 30.0;
+    double sample_budget = 0.0;
+    float volatility_scale = 0.02f;
+    double total_rate = 0.0;
+    std::vector<Slot> slots;
+
+    double _desired_rate(const Slot &p_slot) const;
+    void _assign_rates();
+};
+
+} // namespace godot
+
+#endif // SENSOR_RATE_CONTROLLER_H
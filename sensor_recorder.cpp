@@ -0,0 +1,297 @@
+#include "sensor_recorder.h"
+
+#include "sensor_clock.h"
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+
+#include <cstring>
+
+using namespace godot;
+
+namespace {
+
+int _godot_compression_mode(RecordingCodec p_codec) {
+    switch (p_codec) {
+        case RECORDING_CODEC_DEFLATE:
+            return FileAccess::COMPRESSION_DEFLATE;
+        case RECORDING_CODEC_ZSTD:
+            return FileAccess::COMPRESSION_ZSTD;
+        case RECORDING_CODEC_FASTLZ:
+        default:
+            return FileAccess::COMPRESSION_FASTLZ;
+    }
+}
+
+inline uint32_t _float_bits(float p_value) {
+    uint32_t bits;
+    std::memcpy(&bits, &p_value, sizeof(bits));
+    return bits;
+}
+
+} // namespace
+
+void SensorRecorder::Chunk::clear() {
+    row_counts.clear();
+    frames.clear();
+    timestamps.clear();
+    ids.clear();
+    rgba.clear();
+    luminance.clear();
+}
+
+SensorRecorder::~SensorRecorder() {
+    close();
+}
+
+bool SensorRecorder::open(const std::string &p_path, const Options &p_options) {
+    close();
+
+    options = p_options;
+    if (options.chunk_ticks == 0) {
+        options.chunk_ticks = 1;
+    }
+    if (options.max_pending_chunks == 0) {
+        options.max_pending_chunks = 1;
+    }
+
+    file = std::fopen(p_path.c_str(), "wb");
+    if (!file) {
+        _set_error("cannot open " + p_path + " for writing");
+        return false;
+    }
+
+    RecordingFileHeader header = {};
+    header.magic = RECORDING_FILE_MAGIC;
+    header.version = RECORDING_VERSION;
+    header.header_size = sizeof(RecordingFileHeader);
+    header.chunk_ticks = options.chunk_ticks;
+    header.created_usec = sensor_steady_usec();
+
+    file_offset = 0;
+    index.clear();
+    if (!_write_bytes(&header, sizeof(header))) {
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+
+    ticks_recorded.store(0);
+    ticks_dropped.store(0);
+    chunks_written.store(0);
+    bytes_written.store(sizeof(header));
+    building.clear();
+    stop_requested = false;
+    writer = std::thread(&SensorRecorder::_writer_loop, this);
+    return true;
+}
+
+void SensorRecorder::close() {
+    if (!file) {
+        return;
+    }
+
+    if (building.tick_count() > 0) {
+        _submit_building();
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stop_requested = true;
+    }
+    queue_cv.notify_all();
+    if (writer.joinable()) {
+        writer.join();
+    }
+
+    // Chunk index + trailer let readers seek without walking every chunk
+    RecordingTrailer trailer = {};
+    trailer.index_offset = file_offset;
+    trailer.chunk_count = static_cast<uint32_t>(index.size());
+    trailer.magic = RECORDING_INDEX_MAGIC;
+    if (!index.empty()) {
+        _write_bytes(index.data(), index.size() * sizeof(RecordingIndexEntry));
+    }
+    _write_bytes(&trailer, sizeof(trailer));
+
+    std::fclose(file);
+    file = nullptr;
+    index.clear();
+    pending.clear();
+    spare.clear();
+}
+
+void SensorRecorder::append_tick(uint64_t p_frame, uint64_t p_timestamp_usec, const int32_t *p_ids, const float *p_rgba, const float *p_luminance, uint32_t p_count) {
+    if (!file) {
+        return;
+    }
+
+    building.row_counts.push_back(p_count);
+    building.frames.push_back(p_frame);
+    building.timestamps.push_back(p_timestamp_usec);
+    building.ids.insert(building.ids.end(), p_ids, p_ids + p_count);
+    building.rgba.insert(building.rgba.end(), p_rgba, p_rgba + static_cast<size_t>(p_count) * 4);
+    building.luminance.insert(building.luminance.end(), p_luminance, p_luminance + p_count);
+
+    if (building.tick_count() >= options.chunk_ticks) {
+        _submit_building();
+    }
+}
+
+std::string SensorRecorder::get_last_error() const {
+    std::lock_guard<std::mutex> lock(error_mutex);
+    return last_error;
+}
+
+void SensorRecorder::_submit_building() {
+    const uint32_t ticks = building.tick_count();
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (pending.size() >= options.max_pending_chunks) {
+            // Writer cannot keep up: drop this chunk rather than stall the main thread
+            ticks_dropped.fetch_add(ticks);
+            building.clear();
+            return;
+        }
+
+        pending.emplace_back(std::move(building));
+        if (!spare.empty()) {
+            building = std::move(spare.back());
+            spare.pop_back();
+        } else {
+            building = Chunk();
+        }
+    }
+    building.clear();
+    ticks_recorded.fetch_add(ticks);
+    queue_cv.notify_one();
+}
+
+void SensorRecorder::_writer_loop() {
+    for (;;) {
+        Chunk chunk;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_cv.wait(lock, [this] { return stop_requested || !pending.empty(); });
+            if (pending.empty()) {
+                return; // Stop requested and queue drained
+            }
+            chunk = std::move(pending.front());
+            pending.pop_front();
+        }
+
+        _write_chunk(chunk);
+
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        spare.push_back(std::move(chunk));
+    }
+}
+
+void SensorRecorder::_encode_chunk(const Chunk &p_chunk, std::vector<uint8_t> &r_raw) const {
+    const uint32_t tick_count = p_chunk.tick_count();
+    const uint32_t row_count = static_cast<uint32_t>(p_chunk.ids.size());
+    const RecordingChunkLayout layout(tick_count, row_count);
+    r_raw.assign(layout.total, 0);
+
+    uint8_t *base = r_raw.data();
+    std::memcpy(base + layout.row_counts, p_chunk.row_counts.data(), tick_count * sizeof(uint32_t));
+    std::memcpy(base + layout.frames, p_chunk.frames.data(), tick_count * sizeof(uint64_t));
+    std::memcpy(base + layout.timestamps, p_chunk.timestamps.data(), tick_count * sizeof(uint64_t));
+
+    uint8_t *flags = base + layout.tick_flags;
+    int32_t *ids = reinterpret_cast<int32_t *>(base + layout.ids);
+    uint32_t *rgba = reinterpret_cast<uint32_t *>(base + layout.rgba);
+    uint32_t *lum = reinterpret_cast<uint32_t *>(base + layout.luminance);
+
+    size_t row = 0;
+    size_t prev_row = 0;
+    for (uint32_t t = 0; t < tick_count; ++t) {
+        const uint32_t count = p_chunk.row_counts[t];
+        const bool delta = options.delta && t > 0 && count == p_chunk.row_counts[t - 1];
+        flags[t] = delta ? RECORDING_TICK_DELTA : 0;
+
+        for (uint32_t i = 0; i < count; ++i) {
+            const size_t r = row + i;
+            if (delta) {
+                const size_t p = prev_row + i;
+                ids[r] = static_cast<int32_t>(static_cast<uint32_t>(p_chunk.ids[r]) - static_cast<uint32_t>(p_chunk.ids[p]));
+                for (int c = 0; c < 4; ++c) {
+                    rgba[r * 4 + c] = _float_bits(p_chunk.rgba[r * 4 + c]) ^ _float_bits(p_chunk.rgba[p * 4 + c]);
+                }
+                lum[r] = _float_bits(p_chunk.luminance[r]) ^ _float_bits(p_chunk.luminance[p]);
+            } else {
+                ids[r] = p_chunk.ids[r];
+                for (int c = 0; c < 4; ++c) {
+                    rgba[r * 4 + c] = _float_bits(p_chunk.rgba[r * 4 + c]);
+                }
+                lum[r] = _float_bits(p_chunk.luminance[r]);
+            }
+        }
+
+        prev_row = row;
+        row += count;
+    }
+}
+
+bool SensorRecorder::_write_chunk(const Chunk &p_chunk) {
+    const uint32_t tick_count = p_chunk.tick_count();
+    if (tick_count == 0) {
+        return true;
+    }
+
+    _encode_chunk(p_chunk, encode_buffer);
+
+    RecordingChunkHeader header = {};
+    header.magic = RECORDING_CHUNK_MAGIC;
+    header.codec = RECORDING_CODEC_NONE;
+    header.tick_count = tick_count;
+    header.row_count = static_cast<uint32_t>(p_chunk.ids.size());
+    header.first_frame = p_chunk.frames.front();
+    header.last_frame = p_chunk.frames.back();
+    header.raw_size = encode_buffer.size();
+
+    const uint8_t *payload = encode_buffer.data();
+    size_t payload_size = encode_buffer.size();
+    PackedByteArray compressed;
+    if (options.codec != RECORDING_CODEC_NONE) {
+        PackedByteArray raw;
+        raw.resize(static_cast<int64_t>(encode_buffer.size()));
+        std::memcpy(raw.ptrw(), encode_buffer.data(), encode_buffer.size());
+        compressed = raw.compress(_godot_compression_mode(options.codec));
+        // Keep the raw payload when compression does not pay off
+        if (compressed.size() > 0 && static_cast<size_t>(compressed.size()) < encode_buffer.size()) {
+            header.codec = options.codec;
+            payload = compressed.ptr();
+            payload_size = static_cast<size_t>(compressed.size());
+        }
+    }
+    header.stored_size = payload_size;
+
+    RecordingIndexEntry entry = {};
+    entry.offset = file_offset;
+    entry.first_frame = header.first_frame;
+    entry.last_frame = header.last_frame;
+    entry.tick_count = header.tick_count;
+    entry.row_count = header.row_count;
+
+    if (!_write_bytes(&header, sizeof(header)) || !_write_bytes(payload, payload_size)) {
+        return false;
+    }
+    index.push_back(entry);
+    chunks_written.fetch_add(1);
+    bytes_written.store(file_offset);
+    return true;
+}
+
+bool SensorRecorder::_write_bytes(const void *p_data, size_t p_size) {
+    if (std::fwrite(p_data, 1, p_size, file) != p_size) {
+        _set_error("write failed");
+        return false;
+    }
+    file_offset += p_size;
+    return true;
+}
+
+void SensorRecorder::_set_error(const std::string &p_error) {
+    std::lock_guard<std::mutex> lock(error_mutex);
+    last_error = p_error;
+}
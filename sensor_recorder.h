@@ -0,0 +1,99 @@
+#ifndef SENSOR_RECORDER_H
+#define SENSOR_RECORDER_H
+
+#include "sensor_recording_format.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace godot {
+
+// Streams per-tick sensor arrays into a chunked columnar file (sensor_recording_format.h).
+// append_tick() only copies into the chunk being built; full chunks are delta encoded,
+// compressed and written by a background thread. At most max_pending_chunks chunks wait for
+// the writer; when it falls further behind, whole chunks are dropped and counted.
+class SensorRecorder {
+public:
+    struct Options {
+        uint32_t chunk_ticks = 30;
+        RecordingCodec codec = RECORDING_CODEC_FASTLZ;
+        bool delta = true;
+        uint32_t max_pending_chunks = 8;
+    };
+
+    SensorRecorder() = default;
+    ~SensorRecorder();
+
+    SensorRecorder(const SensorRecorder &) = delete;
+    SensorRecorder &operator=(const SensorRecorder &) = delete;
+
+    // p_path is an OS path (globalize res:// and user:// paths first)
+    bool open(const std::string &p_path, const Options &p_options);
+    // Submits the partial chunk, waits for the writer and appends the chunk index
+    void close();
+    bool is_open() const { return file != nullptr; }
+
+    void append_tick(uint64_t p_frame, uint64_t p_timestamp_usec, const int32_t *p_ids, const float *p_rgba, const float *p_luminance, uint32_t p_count);
+
+    uint64_t get_ticks_recorded() const { return ticks_recorded.load(); }
+    uint64_t get_ticks_dropped() const { return ticks_dropped.load(); }
+    uint64_t get_chunks_written() const { return chunks_written.load(); }
+    uint64_t get_bytes_written() const { return bytes_written.load(); }
+    std::string get_last_error() const;
+
+private:
+    struct Chunk {
+        std::vector<uint32_t> row_counts;
+        std::vector<uint64_t> frames;
+        std::vector<uint64_t> timestamps;
+        std::vector<int32_t> ids;
+        std::vector<float> rgba;
+        std::vector<float> luminance;
+
+        uint32_t tick_count() const { return static_cast<uint32_t>(row_counts.size()); }
+        void clear();
+    };
+
+    Options options;
+    FILE *file = nullptr;
+
+    Chunk building; // Main thread only
+
+    // Shared with the writer thread
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<Chunk> pending;
+    std::vector<Chunk> spare; // Recycled chunks, keeps their capacity
+    bool stop_requested = false;
+    std::thread writer;
+
+    // Writer thread only
+    std::vector<uint8_t> encode_buffer;
+    std::vector<RecordingIndexEntry> index;
+    uint64_t file_offset = 0;
+
+    std::atomic<uint64_t> ticks_recorded{0};
+    std::atomic<uint64_t> ticks_dropped{0};
+    std::atomic<uint64_t> chunks_written{0};
+    std::atomic<uint64_t> bytes_written{0};
+    mutable std::mutex error_mutex;
+    std::string last_error;
+
+    void _submit_building();
+    void _writer_loop();
+    bool _write_chunk(const Chunk &p_chunk);
+    void _encode_chunk(const Chunk &p_chunk, std::vector<uint8_t> &r_raw) const;
+    bool _write_bytes(const void *p_data, size_t p_size);
+    void _set_error(const std::string &p_error);
+};
+
+} // namespace godot
+
+#endif // SENSOR_RECORDER_H
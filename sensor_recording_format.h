@@ -0,0 +1,118 @@
+#ifndef SENSOR_RECORDING_FORMAT_H
+#define SENSOR_RECORDING_FORMAT_H
+
+// On-disk layout of LightSensorManager recordings (*.lsrec). Native-endian.
+//
+//   RecordingFileHeader                        64 bytes
+//   { RecordingChunkHeader, payload }*         payload is stored_size bytes
+//   RecordingIndexEntry[chunk_count]           written on close
+//   RecordingTrailer                           16 bytes, last in the file
+//
+// A chunk holds up to chunk_ticks consecutive ticks. Its payload, after decompression
+// (codec) to raw_size bytes, is a set of columns, each starting 8-byte aligned:
+//
+//   uint32 row_counts[tick_count]   sensors recorded on each tick
+//   uint8  tick_flags[tick_count]   RECORDING_TICK_DELTA: rows encoded against the previous tick
+//   uint64 frames[tick_count]       Godot process frame
+//   uint64 timestamps[tick_count]   CLOCK_MONOTONIC microseconds
+//   int32  ids[row_count]
+//   uint32 rgba[row_count * 4]      float bit patterns
+//   uint32 luminance[row_count]     float bit patterns
+//
+// A delta tick has the same row count as the tick before it in the chunk. Its ids are stored
+// as the difference to the previous tick's id in the same row and its color/luminance bits
+// XORed with the previous tick's bits, so static sensors encode as zeros. The first tick of
+// every chunk is stored raw, so chunks decode independently.
+//
+// Files without a valid trailer (e.g. after a crash) can still be read by walking the chunk
+// headers from the start of the file.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace godot {
+
+static constexpr uint32_t RECORDING_FILE_MAGIC = 0x4345524Cu;  // "LREC"
+static constexpr uint32_t RECORDING_CHUNK_MAGIC = 0x4B4E4843u; // "CHNK"
+static constexpr uint32_t RECORDING_INDEX_MAGIC = 0x58444E49u; // "INDX"
+static constexpr uint32_t RECORDING_VERSION = 1;
+
+enum RecordingCodec : uint8_t {
+    RECORDING_CODEC_NONE = 0,
+    RECORDING_CODEC_FASTLZ = 1,
+    RECORDING_CODEC_DEFLATE = 2,
+    RECORDING_CODEC_ZSTD = 3,
+};
+
+enum RecordingTickFlags : uint8_t {
+    RECORDING_TICK_DELTA = 0x1,
+};
+
+struct RecordingFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t chunk_ticks;
+    uint64_t created_usec;
+    uint8_t reserved[40];
+};
+
+struct RecordingChunkHeader {
+    uint32_t magic;
+    uint8_t codec;
+    uint8_t reserved0[3];
+    uint32_t tick_count;
+    uint32_t row_count;
+    uint64_t first_frame;
+    uint64_t last_frame;
+    uint64_t raw_size;
+    uint64_t stored_size;
+    uint8_t reserved[16];
+};
+
+struct RecordingIndexEntry {
+    uint64_t offset; // File offset of the RecordingChunkHeader
+    uint64_t first_frame;
+    uint64_t last_frame;
+    uint32_t tick_count;
+    uint32_t row_count;
+};
+
+struct RecordingTrailer {
+    uint64_t index_offset;
+    uint32_t chunk_count;
+    uint32_t magic;
+};
+
+static_assert(sizeof(RecordingFileHeader) == 64, "RecordingFileHeader layout changed");
+static_assert(sizeof(RecordingChunkHeader) == 64, "RecordingChunkHeader layout changed");
+static_assert(sizeof(RecordingIndexEntry) == 32, "RecordingIndexEntry layout changed");
+static_assert(sizeof(RecordingTrailer) == 16, "RecordingTrailer layout changed");
+
+// Column offsets inside a decompressed chunk payload
+struct RecordingChunkLayout {
+    size_t row_counts = 0;
+    size_t tick_flags = 0;
+    size_t frames = 0;
+    size_t timestamps = 0;
+    size_t ids = 0;
+    size_t rgba = 0;
+    size_t luminance = 0;
+    size_t total = 0;
+
+    RecordingChunkLayout(uint32_t p_tick_count, uint32_t p_row_count) {
+        auto align8 = [](size_t v) { return (v + 7) & ~static_cast<size_t>(7); };
+        row_counts = 0;
+        tick_flags = align8(row_counts + p_tick_count * sizeof(uint32_t));
+        frames = align8(tick_flags + p_tick_count);
+        timestamps = frames + p_tick_count * sizeof(uint64_t);
+        ids = timestamps + p_tick_count * sizeof(uint64_t);
+        rgba = align8(ids + static_cast<size_t>(p_row_count) * sizeof(int32_t));
+        luminance = rgba + static_cast<size_t>(p_row_count) * 4 * sizeof(uint32_t);
+        total = align8(luminance + static_cast<size_t>(p_row_count) * sizeof(uint32_t));
+    }
+};
+
+} // namespace godot
+
+#endif // SENSOR_RECORDING_FORMAT_H
@@ -0,0 +1,68 @@
+#ifndef SENSOR_SET_FORMAT_H
+#define SENSOR_SET_FORMAT_H
+
+// Packed layout of a LightSensorSet (the resource's `data` blob). Native-endian.
+//
+//   SensorSetHeader                            32 bytes
+//   float  positions[sensor_count * 3]         world x, y, z
+//   uint32 label_index[sensor_count]           into the label table
+//   uint16 group_index[sensor_count]           into the group table
+//   uint8  radius[sensor_count]                sample radius in pixels; 0: the manager's
+//   uint32 label_offsets[label_count + 1]      byte ranges of the labels in strings
+//   uint32 group_offsets[group_count + 1]      byte ranges of the groups in strings
+//   char   strings[strings_size]               UTF-8, not terminated
+//
+// Every column starts 8-byte aligned, so a loader can read the columns in place. Labels and
+// groups are deduplicated tables: sensors sharing a label share one entry.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace godot {
+
+static constexpr uint32_t SENSOR_SET_MAGIC = 0x5445534Cu; // "LSET"
+static constexpr uint32_t SENSOR_SET_VERSION = 1;
+static constexpr uint32_t SENSOR_SET_MAX_GROUPS = 0xFFFFu;
+static constexpr int SENSOR_SET_MAX_RADIUS = 16;
+
+struct SensorSetHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sensor_count;
+    uint32_t label_count;
+    uint32_t group_count;
+    uint32_t strings_size;
+    uint8_t reserved[8];
+};
+
+static_assert(sizeof(SensorSetHeader) == 32, "SensorSetHeader layout changed");
+
+// Column offsets inside the blob
+struct SensorSetLayout {
+    size_t positions = 0;
+    size_t label_index = 0;
+    size_t group_index = 0;
+    size_t radius = 0;
+    size_t label_offsets = 0;
+    size_t group_offsets = 0;
+    size_t strings = 0;
+    size_t total = 0;
+
+    SensorSetLayout() = default;
+    explicit SensorSetLayout(const SensorSetHeader &p_header) {
+        auto align8 = [](size_t v) { return (v + 7) & ~static_cast<size_t>(7); };
+        const size_t count = p_header.sensor_count;
+        positions = sizeof(SensorSetHeader);
+        label_index = align8(positions + count * 3 * sizeof(float));
+        group_index = align8(label_index + count * sizeof(uint32_t));
+        radius = align8(group_index + count * sizeof(uint16_t));
+        label_offsets = align8(radius + count);
+        group_offsets = align8(label_offsets + (static_cast<size_t>(p_header.label_count) + 1) * sizeof(uint32_t));
+        strings = align8(group_offsets + (static_cast<size_t>(p_header.group_count) + 1) * sizeof(uint32_t));
+        total = strings + p_header.strings_size;
+    }
+};
+
+} // namespace godot
+
+#endif // SENSOR_SET_FORMAT_H
@@ -0,0 +1,259 @@
+#include "sensor_shm_exporter.h"
+
+#include "sensor_clock.h"
+
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LSS_SHM_SUPPORTED 1
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#define LSS_SHM_NOTIFY_SUPPORTED 1
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+using namespace godot;
+
+SensorShmExporter::~SensorShmExporter() {
+    close();
+}
+
+bool SensorShmExporter::_fail(const std::string &p_error) {
+    last_error = p_error;
+    close();
+    return false;
+}
+
+#ifdef LSS_SHM_SUPPORTED
+
+bool SensorShmExporter::open(const std::string &p_name, uint32_t p_capacity, uint32_t p_slot_count, bool p_notify) {
+    close();
+    last_error.clear();
+
+    if (p_name.size() < 2 || p_name[0] != '/') {
+        last_error = "shared memory name must start with '/'";
+        return false;
+    }
+
+    name = p_name;
+    capacity = p_capacity > 0 ? p_capacity : 1;
+    slot_count = p_slot_count >= 2 ? p_slot_count : 2;
+    publish_count = 0;
+
+    // A previous run may have crashed without unlinking; readers still attached to it keep
+    // their (orphaned) mapping, so recreating is safe.
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        return _fail(std::string("shm_open failed: ") + std::strerror(errno));
+    }
+
+    mapped_size = lss_segment_size(capacity, slot_count);
+    if (ftruncate(fd, static_cast<off_t>(mapped_size)) != 0) {
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return _fail(std::string("ftruncate failed: ") + std::strerror(errno));
+    }
+
+    void *mem = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return _fail(std::string("mmap failed: ") + std::strerror(errno));
+    }
+
+    // ftruncate zero-fills, so every slot starts with an even (stable, empty) sequence
+    header = static_cast<lss_shm_header *>(mem);
+    header->version = LSS_SHM_VERSION;
+    header->header_size = sizeof(lss_shm_header);
+    header->slot_count = slot_count;
+    header->slot_capacity = capacity;
+    header->slot_size = static_cast<uint32_t>(lss_slot_size(capacity));
+    header->writer_pid = static_cast<uint32_t>(getpid());
+
+    uint32_t flags = 0;
+    if (p_notify) {
+        if (_open_notify()) {
+            std::strncpy(header->notify_path, notify_path.c_str(), LSS_SHM_NOTIFY_PATH_MAX - 1);
+            flags |= LSS_SHM_FLAG_NOTIFY;
+        } else {
+            // Readers can still poll publish_count; keep the error for the caller to report
+            _close_notify();
+        }
+    }
+    __atomic_store_n(&header->flags, flags, __ATOMIC_RELAXED);
+
+    // Magic last: readers treat a segment without it as not yet initialized
+    __atomic_store_n(&header->magic, LSS_SHM_MAGIC, __ATOMIC_RELEASE);
+    return true;
+}
+
+void SensorShmExporter::close() {
+    if (header) {
+        __atomic_fetch_or(&header->flags, LSS_SHM_FLAG_CLOSED, __ATOMIC_RELEASE);
+    }
+#ifdef LSS_SHM_NOTIFY_SUPPORTED
+    if (event_fd >= 0) {
+        // Wake blocked readers so they observe LSS_SHM_FLAG_CLOSED
+        const uint64_t one = 1;
+        ssize_t written = write(event_fd, &one, sizeof(one));
+        (void)written;
+    }
+#endif
+    _close_notify();
+
+    if (header) {
+        munmap(header, mapped_size);
+        header = nullptr;
+        shm_unlink(name.c_str());
+    }
+    mapped_size = 0;
+}
+
+void SensorShmExporter::publish(uint64_t p_frame, const int32_t *p_ids, const float *p_rgba, const float *p_luminance, uint32_t p_count) {
+    if (!header) {
+        return;
+    }
+
+    const uint32_t count = p_count < capacity ? p_count : capacity;
+    const uint64_t tick = publish_count;
+    uint8_t *slot = reinterpret_cast<uint8_t *>(header) + header->header_size + static_cast<size_t>(tick % slot_count) * header->slot_size;
+    lss_shm_slot_header *slot_header = reinterpret_cast<lss_shm_slot_header *>(slot);
+
+    // Seqlock write: odd while the payload is inconsistent
+    const uint64_t seq = __atomic_load_n(&slot_header->sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot_header->sequence, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    slot_header->tick = tick;
+    slot_header->frame = p_frame;
+    slot_header->timestamp_usec = sensor_steady_usec();
+    slot_header->count = count;
+    if (count > 0) {
+        std::memcpy(slot + lss_slot_ids_offset(capacity), p_ids, count * sizeof(int32_t));
+        std::memcpy(slot + lss_slot_colors_offset(capacity), p_rgba, count * 4 * sizeof(float));
+        std::memcpy(slot + lss_slot_luminance_offset(capacity), p_luminance, count * sizeof(float));
+    }
+
+    __atomic_store_n(&slot_header->sequence, seq + 2, __ATOMIC_RELEASE);
+    publish_count = tick + 1;
+    __atomic_store_n(&header->publish_count, publish_count, __ATOMIC_RELEASE);
+
+#ifdef LSS_SHM_NOTIFY_SUPPORTED
+    if (event_fd >= 0) {
+        _accept_notify_clients();
+        const uint64_t one = 1;
+        ssize_t written = write(event_fd, &one, sizeof(one));
+        (void)written; // EAGAIN only when the counter saturates, which no reader would notice
+    }
+#endif
+}
+
+#else // !LSS_SHM_SUPPORTED
+
+bool SensorShmExporter::open(const std::string &p_name, uint32_t p_capacity, uint32_t p_slot_count, bool p_notify) {
+    last_error = "shared memory export requires a POSIX platform";
+    return false;
+}
+
+void SensorShmExporter::close() {
+}
+
+void SensorShmExporter::publish(uint64_t p_frame, const int32_t *p_ids, const float *p_rgba, const float *p_luminance, uint32_t p_count) {
+}
+
+#endif // LSS_SHM_SUPPORTED
+
+#ifdef LSS_SHM_NOTIFY_SUPPORTED
+
+bool SensorShmExporter::_open_notify() {
+    event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (event_fd < 0) {
+        last_error = std::string("eventfd failed: ") + std::strerror(errno);
+        return false;
+    }
+
+    // "/light_data_sensor" -> "/tmp/light_data_sensor.notify"
+    notify_path = "/tmp" + name + ".notify";
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if (notify_path.size() >= sizeof(addr.sun_path) || notify_path.size() >= LSS_SHM_NOTIFY_PATH_MAX) {
+        last_error = "notification socket path too long";
+        return false;
+    }
+    std::memcpy(addr.sun_path, notify_path.c_str(), notify_path.size() + 1);
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        last_error = std::string("socket failed: ") + std::strerror(errno);
+        return false;
+    }
+    unlink(notify_path.c_str());
+    if (bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(listen_fd, 8) != 0) {
+        last_error = std::string("notification socket failed: ") + std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+void SensorShmExporter::_accept_notify_clients() {
+    // Non-blocking: each pending reader receives the eventfd via SCM_RIGHTS and is disconnected
+    for (;;) {
+        int client = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            return;
+        }
+
+        char byte = 0;
+        iovec iov = { &byte, 1 };
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+        msghdr msg = {};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(cmsg), &event_fd, sizeof(int));
+        sendmsg(client, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        ::close(client);
+    }
+}
+
+void SensorShmExporter::_close_notify() {
+    if (listen_fd >= 0) {
+        ::close(listen_fd);
+        listen_fd = -1;
+        unlink(notify_path.c_str());
+    }
+    if (event_fd >= 0) {
+        ::close(event_fd);
+        event_fd = -1;
+    }
+    notify_path.clear();
+}
+
+#else // !LSS_SHM_NOTIFY_SUPPORTED
+
+bool SensorShmExporter::_open_notify() {
+    last_error = "eventfd notification is only available on Linux";
+    return false;
+}
+
+void SensorShmExporter::_accept_notify_clients() {
+}
+
+void SensorShmExporter::_close_notify() {
+}
+
+#endif // LSS_SHM_NOTIFY_SUPPORTED
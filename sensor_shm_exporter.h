@@ -0,0 +1,59 @@
+#ifndef SENSOR_SHM_EXPORTER_H
+#define SENSOR_SHM_EXPORTER_H
+
+#include "sensor_shm_layout.h"
+
+#include <cstdint>
+#include <string>
+
+namespace godot {
+
+// Writer side of the shared-memory result export (layout in sensor_shm_layout.h).
+// Publishes one tick of packed sensor arrays per call into a POSIX shared-memory ring.
+// On Linux an eventfd can be handed to readers through a Unix socket so they can block
+// until the next tick instead of polling. Not available on Windows: open() fails.
+class SensorShmExporter {
+public:
+    SensorShmExporter() = default;
+    ~SensorShmExporter();
+
+    SensorShmExporter(const SensorShmExporter &) = delete;
+    SensorShmExporter &operator=(const SensorShmExporter &) = delete;
+
+    // p_name is a POSIX shm name ("/light_data_sensor"). Replaces any stale segment of that name.
+    bool open(const std::string &p_name, uint32_t p_capacity, uint32_t p_slot_count, bool p_notify);
+    // Marks the segment closed for attached readers, then unlinks it
+    void close();
+    bool is_open() const { return header != nullptr; }
+
+    // Copy one tick into the next ring slot. Entries beyond the capacity are dropped.
+    void publish(uint64_t p_frame, const int32_t *p_ids, const float *p_rgba, const float *p_luminance, uint32_t p_count);
+
+    uint32_t get_capacity() const { return capacity; }
+    uint64_t get_publish_count() const { return publish_count; }
+    const std::string &get_name() const { return name; }
+    const std::string &get_last_error() const { return last_error; }
+
+private:
+    std::string name;
+    std::string last_error;
+    lss_shm_header *header = nullptr;
+    size_t mapped_size = 0;
+    uint32_t capacity = 0;
+    uint32_t slot_count = 0;
+    uint64_t publish_count = 0;
+
+    // Notification (Linux only)
+    int event_fd = -1;
+    int listen_fd = -1;
+    std::string notify_path;
+
+    bool _open_notify();
+    void _accept_notify_clients();
+    void _close_notify();
+    bool _fail(const std::string &p_error);
+};
+
+} // namespace godot
+
+#endif // SENSOR_SHM_EXPORTER_H
@@ -0,0 +1,100 @@
+#ifndef SENSOR_SHM_LAYOUT_H
+#define SENSOR_SHM_LAYOUT_H
+
+/*
+ * Shared-memory layout of the LightSensorManager result export.
+ *
+ * Plain C so external readers can include it directly (see tools/shm_reader).
+ * All fields are native-endian and the segment is only meant for processes on the same host.
+ *
+ *   [lss_shm_header]                       256 bytes
+ *   [slot 0] [slot 1] ... [slot N-1]       header->slot_size bytes each
+ *
+ * Each slot:
+ *   [lss_shm_slot_header]                  64 bytes
+ *   int32_t  ids[slot_capacity]            at lss_slot_ids_offset()
+ *   float    colors[slot_capacity * 4]     RGBA, at lss_slot_colors_offset()
+ *   float    luminance[slot_capacity]      at lss_slot_luminance_offset()
+ *
+ * Publishing: tick T (starting at 0) is written into slot T % slot_count, then
+ * header->publish_count is set to T + 1. The latest tick is therefore publish_count - 1.
+ *
+ * Versioning: each slot is guarded by a seqlock. The writer makes sequence odd, writes the
+ * payload, then makes it even again. A reader loads sequence (acquire), skips the slot if it
+ * is odd, reads the payload, then loads sequence again; the read is valid only if both
+ * loads match. publish_count and sequence must be accessed with atomic 64-bit loads.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LSS_SHM_MAGIC 0x4D53534Cu /* "LSSM" in little-endian byte order */
+#define LSS_SHM_VERSION 1u
+#define LSS_SHM_DEFAULT_NAME "/light_data_sensor"
+#define LSS_SHM_NOTIFY_PATH_MAX 108
+
+/* header->flags */
+#define LSS_SHM_FLAG_NOTIFY 0x1u /* notify_path accepts connections and hands out an eventfd */
+#define LSS_SHM_FLAG_CLOSED 0x2u /* writer detached; reopen the segment by name */
+
+typedef struct lss_shm_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t header_size;   /* Offset of slot 0 */
+    uint32_t slot_count;
+    uint32_t slot_capacity; /* Maximum sensors per tick */
+    uint32_t slot_size;     /* Bytes per slot, including lss_shm_slot_header */
+    uint32_t writer_pid;
+    uint32_t flags;         /* LSS_SHM_FLAG_* (atomic) */
+    uint64_t publish_count; /* Ticks published so far (atomic) */
+    char notify_path[LSS_SHM_NOTIFY_PATH_MAX]; /* Unix socket path, empty without notification */
+    uint8_t reserved[108];
+} lss_shm_header;
+
+typedef struct lss_shm_slot_header {
+    uint64_t sequence;       /* Seqlock counter: odd while the slot is being written (atomic) */
+    uint64_t tick;           /* Publish index stored in this slot */
+    uint64_t frame;          /* Godot process frame of the snapshot */
+    uint64_t timestamp_usec; /* CLOCK_MONOTONIC time of publication, microseconds */
+    uint32_t count;          /* Valid entries in the arrays below */
+    uint32_t reserved0;
+    uint8_t reserved[24];
+} lss_shm_slot_header;
+
+static inline size_t lss_align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static inline size_t lss_slot_ids_offset(uint32_t capacity) {
+    (void)capacity;
+    return sizeof(lss_shm_slot_header);
+}
+
+static inline size_t lss_slot_colors_offset(uint32_t capacity) {
+    return lss_align_up(lss_slot_ids_offset(capacity) + (size_t)capacity * sizeof(int32_t), 16);
+}
+
+static inline size_t lss_slot_luminance_offset(uint32_t capacity) {
+    return lss_slot_colors_offset(capacity) + (size_t)capacity * 4 * sizeof(float);
+}
+
+static inline size_t lss_slot_size(uint32_t capacity) {
+    return lss_align_up(lss_slot_luminance_offset(capacity) + (size_t)capacity * sizeof(float), 64);
+}
+
+static inline size_t lss_segment_size(uint32_t capacity, uint32_t slot_count) {
+    return sizeof(lss_shm_header) + lss_slot_size(capacity) * (size_t)slot_count;
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+
+static_assert(sizeof(lss_shm_header) == 256, "lss_shm_header layout changed");
+static_assert(sizeof(lss_shm_slot_header) == 64, "lss_shm_slot_header layout changed");
+#endif
+
+#endif /* SENSOR_SHM_LAYOUT_H */
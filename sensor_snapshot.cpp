@@ -0,0 +1,363 @@
+#include "sensor_snapshot.h"
+
+#include "sensor_worker_pool.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace godot;
+
+namespace {
+
+// Multiply-rotate mixing over 64-bit words; only needs to detect change, not resist attacks
+inline uint64_t _hash_mix(uint64_t h, uint64_t v) {
+    h ^= v * 0x9E3779B97F4A7C15ULL;
+    h = (h << 27) | (h >> 37);
+    return h * 0xC2B2AE3D27D4EB4FULL;
+}
+
+inline uint64_t _hash_bytes(uint64_t h, const uint8_t *p_data, size_t p_len) {
+    size_t i = 0;
+    for (; i + 8 <= p_len; i += 8) {
+        uint64_t v;
+        std::memcpy(&v, p_data + i, 8);
+        h = _hash_mix(h, v);
+    }
+    if (i < p_len) {
+        uint64_t v = 0;
+        std::memcpy(&v, p_data + i, p_len - i);
+        h = _hash_mix(h, v);
+    }
+    return h;
+}
+
+// Clip the (2r+1)^2 square around (cx, cy) to the frame; false if nothing remains
+inline bool _clip_region(int p_width, int p_height, float p_center_x, float p_center_y, int p_radius, int &r_x0, int &r_y0, int &r_x1, int &r_y1) {
+    const int cx = static_cast<int>(p_center_x);
+    const int cy = static_cast<int>(p_center_y);
+    r_x0 = cx - p_radius < 0 ? 0 : cx - p_radius;
+    r_y0 = cy - p_radius < 0 ? 0 : cy - p_radius;
+    r_x1 = cx + p_radius >= p_width ? p_width - 1 : cx + p_radius;
+    r_y1 = cy + p_radius >= p_height ? p_height - 1 : cy + p_radius;
+    return r_x0 <= r_x1 && r_y0 <= r_y1;
+}
+
+} // namespace
+
+void SensorSnapshot::clear() {
+    width = 0;
+    height = 0;
+    frame = 0;
+    rgba8.clear();
+    linear_source = false;
+    sat_generation = 0;
+    sat_width = 0;
+    sat_height = 0;
+    tiles_x = 0;
+    tiles_y = 0;
+    last_changed_tiles = 0;
+    tile_hashes.clear();
+    tile_changed_generation.clear();
+}
+
+void SensorSnapshot::reserve(int p_width, int p_height) {
+    if (p_width <= 0 || p_height <= 0) {
+        return;
+    }
+    const size_t tile_count = static_cast<size_t>((p_width + TILE_SIZE - 1) / TILE_SIZE) * static_cast<size_t>((p_height + TILE_SIZE - 1) / TILE_SIZE);
+    rgba8.reserve(static_cast<size_t>(p_width) * static_cast<size_t>(p_height) * 4);
+    tile_hashes.reserve(tile_count);
+    tile_changed_generation.reserve(tile_count);
+    tile_scratch.reserve(tile_count);
+}
+
+bool SensorSnapshot::capture(const Ref<ViewportTexture> &p_texture, uint64_t p_frame) {
+    if (p_texture.is_null()) {
+        return false;
+    }
+
+    // PERFORMANCE WARNING: get_image() causes expensive CPU-GPU synchronization.
+    // Callers are expected to capture at most once per batch tick.
+    Ref<Image> img = p_texture->get_image();
+    return ingest_image(img, p_frame);
+}
+
+bool SensorSnapshot::ingest_image(const Ref<Image> &p_image, uint64_t p_frame) {
+    if (p_image.is_null()) {
+        return false;
+    }
+
+    const int img_width = p_image->get_width();
+    const int img_height = p_image->get_height();
+    if (img_width <= 0 || img_height <= 0) {
+        return false;
+    }
+
+    // HDR viewports hand back float images holding linear values; the conversion below
+    // keeps them linear, so they must not be decoded again when sampling
+    const Image::Format source_format = p_image->get_format();
+    const bool source_is_float = sensor_is_float_format(source_format);
+
+    // get_image() returns a fresh copy, so converting in place does not touch the viewport.
+    if (source_format != Image::FORMAT_RGBA8) {
+        p_image->convert(Image::FORMAT_RGBA8);
+    }
+
+    const PackedByteArray data = p_image->get_data();
+    const size_t expected = static_cast<size_t>(img_width) * static_cast<size_t>(img_height) * 4;
+    if (static_cast<size_t>(data.size()) < expected) {
+        return false;
+    }
+
+    if (expected > rgba8.capacity()) {
+        buffer_reallocations++;
+        reserve(img_width, img_height);
+    }
+    rgba8.resize(expected);
+    std::memcpy(rgba8.data(), data.ptr(), expected);
+    width = img_width;
+    height = img_height;
+    frame = p_frame;
+    linear_source = source_is_float;
+    _update_tile_signatures();
+    return true;
+}
+
+void SensorSnapshot::_update_tile_signatures() {
+    generation++;
+
+    const int new_tiles_x = (width + TILE_SIZE - 1) / TILE_SIZE;
+    const int new_tiles_y = (height + TILE_SIZE - 1) / TILE_SIZE;
+    const size_t tile_count = static_cast<size_t>(new_tiles_x) * static_cast<size_t>(new_tiles_y);
+    const bool resized = new_tiles_x != tiles_x || new_tiles_y != tiles_y || tile_hashes.size() != tile_count;
+    tiles_x = new_tiles_x;
+    tiles_y = new_tiles_y;
+
+    // Hash each tile row segment into its tile; rows are walked in memory order
+    tile_scratch.assign(tile_count, 0x84222325CBF29CE4ULL);
+    const size_t stride = static_cast<size_t>(width) * 4;
+    for (int y = 0; y < height; ++y) {
+        const uint8_t *row = rgba8.data() + static_cast<size_t>(y) * stride;
+        uint64_t *tile_row = tile_scratch.data() + static_cast<size_t>(y / TILE_SIZE) * tiles_x;
+        for (int tx = 0; tx < tiles_x; ++tx) {
+            const int x0 = tx * TILE_SIZE;
+            const int w = (x0 + TILE_SIZE <= width) ? TILE_SIZE : width - x0;
+            tile_row[tx] = _hash_bytes(tile_row[tx], row + static_cast<size_t>(x0) * 4, static_cast<size_t>(w) * 4);
+        }
+    }
+
+    if (resized) {
+        // New geometry: every tile counts as changed
+        tile_hashes.swap(tile_scratch);
+        tile_changed_generation.assign(tile_count, generation);
+        last_changed_tiles = static_cast<int>(tile_count);
+        return;
+    }
+
+    int changed = 0;
+    for (size_t i = 0; i < tile_count; ++i) {
+        if (tile_scratch[i] != tile_hashes[i]) {
+            tile_changed_generation[i] = generation;
+            ++changed;
+        }
+    }
+    tile_hashes.swap(tile_scratch);
+    last_changed_tiles = changed;
+}
+
+bool SensorSnapshot::is_region_unchanged_since(float p_center_x, float p_center_y, int p_radius, uint64_t p_generation) const {
+    if (!is_valid() || tile_changed_generation.empty()) {
+        return false;
+    }
+
+    int x0, y0, x1, y1;
+    if (!_clip_region(width, height, p_center_x, p_center_y, p_radius, x0, y0, x1, y1)) {
+        return true; // Nothing to sample; the cached (black) result stands
+    }
+
+    for (int ty = y0 / TILE_SIZE; ty <= y1 / TILE_SIZE; ++ty) {
+        const uint64_t *row = tile_changed_generation.data() + static_cast<size_t>(ty) * tiles_x;
+        for (int tx = x0 / TILE_SIZE; tx <= x1 / TILE_SIZE; ++tx) {
+            if (row[tx] > p_generation) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void SensorSnapshot::update_summed_area_tables(SensorColorMode p_mode, SensorWorkerPool *p_pool) {
+    if (!is_valid()) {
+        return;
+    }
+
+    const bool decoded = p_mode != SENSOR_COLOR_ENCODED && !linear_source;
+    const size_t tile_count = static_cast<size_t>(tiles_x) * static_cast<size_t>(tiles_y);
+    const bool rebuild_all = sat_width != width || sat_height != height || sat_decoded != decoded ||
+            sat_tile_generation.size() != tile_count;
+    if (rebuild_all) {
+        sat.resize(tile_count * SAT_TILE_ENTRIES);
+        sat_tile_generation.assign(tile_count, 0);
+        sat_width = width;
+        sat_height = height;
+        sat_decoded = decoded;
+    }
+
+    sat_dirty_tiles.clear();
+    for (size_t i = 0; i < tile_count; ++i) {
+        if (rebuild_all || tile_changed_generation[i] > sat_tile_generation[i]) {
+            sat_dirty_tiles.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    last_sat_rebuilt_tiles = static_cast<int>(sat_dirty_tiles.size());
+
+    // Tiles are independent, so a static view rebuilds nothing and a moving one only its
+    // dirty tiles, spread over the workers
+    const uint16_t *decode = decoded ? sensor_srgb8_to_linear_u16_table() : nullptr;
+    auto build = [this, decode](size_t p_begin, size_t p_end) {
+        for (size_t k = p_begin; k < p_end; ++k) {
+            _build_tile_table(sat_dirty_tiles[k], decode);
+        }
+    };
+    if (p_pool) {
+        p_pool->parallel_for(sat_dirty_tiles.size(), 16, build);
+    } else {
+        build(0, sat_dirty_tiles.size());
+    }
+    for (uint32_t tile : sat_dirty_tiles) {
+        sat_tile_generation[tile] = generation;
+    }
+    sat_generation = generation;
+}
+
+void SensorSnapshot::drop_summed_area_tables() {
+    sat.clear();
+    sat_tile_generation.clear();
+    sat_generation = 0;
+    sat_width = 0;
+    sat_height = 0;
+}
+
+bool SensorSnapshot::has_summed_area_tables(SensorColorMode p_mode) const {
+    return !sat.empty() && sat_generation == generation && sat_width == width && sat_height == height &&
+            sat_decoded == (p_mode != SENSOR_COLOR_ENCODED && !linear_source);
+}
+
+void SensorSnapshot::_build_tile_table(size_t p_tile, const uint16_t *p_decode) {
+    constexpr int SIDE = TILE_SIZE + 1;
+    const int tx = static_cast<int>(p_tile % static_cast<size_t>(tiles_x));
+    const int ty = static_cast<int>(p_tile / static_cast<size_t>(tiles_x));
+    const int x0 = tx * TILE_SIZE;
+    const int y0 = ty * TILE_SIZE;
+    const int w = std::min(TILE_SIZE, width - x0);
+    const int h = std::min(TILE_SIZE, height - y0);
+
+    uint32_t *table = sat.data() + p_tile * SAT_TILE_ENTRIES;
+    std::fill(table, table + SIDE * 3, 0u);
+    const size_t stride = static_cast<size_t>(width) * 4;
+    for (int y = 0; y < h; ++y) {
+        const uint8_t *px = rgba8.data() + static_cast<size_t>(y0 + y) * stride + static_cast<size_t>(x0) * 4;
+        uint32_t *above = table + static_cast<size_t>(y) * SIDE * 3;
+        uint32_t *row = above + SIDE * 3;
+        row[0] = row[1] = row[2] = 0;
+        uint32_t run_r = 0;
+        uint32_t run_g = 0;
+        uint32_t run_b = 0;
+        for (int x = 0; x < w; ++x, px += 4) {
+            run_r += p_decode ? p_decode[px[0]] : px[0];
+            run_g += p_decode ? p_decode[px[1]] : px[1];
+            run_b += p_decode ? p_decode[px[2]] : px[2];
+            const size_t e = static_cast<size_t>(x + 1) * 3;
+            row[e] = above[e] + run_r;
+            row[e + 1] = above[e + 1] + run_g;
+            row[e + 2] = above[e + 2] + run_b;
+        }
+    }
+}
+
+Color SensorSnapshot::_sample_region_sat(int p_x0, int p_y0, int p_x1, int p_y1, SensorColorMode p_mode) const {
+    constexpr int SIDE = TILE_SIZE + 1;
+    uint64_t sum_r = 0;
+    uint64_t sum_g = 0;
+    uint64_t sum_b = 0;
+    // Four lookups per tile touched, independent of the region size
+    for (int ty = p_y0 / TILE_SIZE; ty <= p_y1 / TILE_SIZE; ++ty) {
+        const int ly0 = std::max(p_y0 - ty * TILE_SIZE, 0);
+        const int ly1 = std::min(p_y1 - ty * TILE_SIZE, TILE_SIZE - 1) + 1;
+        for (int tx = p_x0 / TILE_SIZE; tx <= p_x1 / TILE_SIZE; ++tx) {
+            const int lx0 = std::max(p_x0 - tx * TILE_SIZE, 0);
+            const int lx1 = std::min(p_x1 - tx * TILE_SIZE, TILE_SIZE - 1) + 1;
+            const uint32_t *table = sat.data() + (static_cast<size_t>(ty) * tiles_x + tx) * SAT_TILE_ENTRIES;
+            const uint32_t *a = table + (static_cast<size_t>(ly0) * SIDE + lx0) * 3;
+            const uint32_t *b = table + (static_cast<size_t>(ly0) * SIDE + lx1) * 3;
+            const uint32_t *c = table + (static_cast<size_t>(ly1) * SIDE + lx0) * 3;
+            const uint32_t *d = table + (static_cast<size_t>(ly1) * SIDE + lx1) * 3;
+            sum_r += d[0] - b[0] - c[0] + a[0];
+            sum_g += d[1] - b[1] - c[1] + a[1];
+            sum_b += d[2] - b[2] - c[2] + a[2];
+        }
+    }
+
+    const uint32_t count = static_cast<uint32_t>((p_x1 - p_x0 + 1) * (p_y1 - p_y0 + 1));
+    const float scale = sat_decoded ? 65535.0f : 255.0f;
+    const float inv = 1.0f / (scale * static_cast<float>(count));
+    if (p_mode == SENSOR_COLOR_ENCODED) {
+        return Color(sum_r * inv, sum_g * inv, sum_b * inv, 1.0f);
+    }
+    return sensor_finish_linear_average(sum_r * inv, sum_g * inv, sum_b * inv, p_mode);
+}
+
+Color SensorSnapshot::sample_region(float p_center_x, float p_center_y, int p_radius, SensorColorMode p_mode) const {
+    if (!is_valid()) {
+        return Color(0, 0, 0, 1);
+    }
+
+    int x0, y0, x1, y1;
+    if (!_clip_region(width, height, p_center_x, p_center_y, p_radius, x0, y0, x1, y1)) {
+        return Color(0, 0, 0, 1);
+    }
+
+    if (has_summed_area_tables(p_mode)) {
+        return _sample_region_sat(x0, y0, x1, y1, p_mode);
+    }
+
+    const uint32_t count = static_cast<uint32_t>((x1 - x0 + 1) * (y1 - y0 + 1));
+    const size_t stride = static_cast<size_t>(width) * 4;
+
+    if (p_mode != SENSOR_COLOR_ENCODED && !linear_source) {
+        // Linear-light average: one table load per channel instead of an integer add
+        const float *lut = sensor_srgb8_to_linear_table();
+        float lin_r = 0.0f;
+        float lin_g = 0.0f;
+        float lin_b = 0.0f;
+        for (int y = y0; y <= y1; ++y) {
+            const uint8_t *px = rgba8.data() + static_cast<size_t>(y) * stride + static_cast<size_t>(x0) * 4;
+            for (int x = x0; x <= x1; ++x, px += 4) {
+                lin_r += lut[px[0]];
+                lin_g += lut[px[1]];
+                lin_b += lut[px[2]];
+            }
+        }
+        const float lin_inv = 1.0f / static_cast<float>(count);
+        return sensor_finish_linear_average(lin_r * lin_inv, lin_g * lin_inv, lin_b * lin_inv, p_mode);
+    }
+
+    uint32_t sum_r = 0;
+    uint32_t sum_g = 0;
+    uint32_t sum_b = 0;
+    for (int y = y0; y <= y1; ++y) {
+        const uint8_t *px = rgba8.data() + static_cast<size_t>(y) * stride + static_cast<size_t>(x0) * 4;
+        for (int x = x0; x <= x1; ++x, px += 4) {
+            sum_r += px[0];
+            sum_g += px[1];
+            sum_b += px[2];
+        }
+    }
+
+    const float inv = 1.0f / (255.0f * static_cast<float>(count));
+    if (p_mode == SENSOR_COLOR_LINEAR_SRGB) {
+        // Linear source averaged directly; only the output is encoded
+        return sensor_finish_linear_average(sum_r * inv, sum_g * inv, sum_b * inv, p_mode);
+    }
+    return Color(sum_r * inv, sum_g * inv, sum_b * inv, 1.0f);
+}
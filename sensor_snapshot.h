@@ -0,0 +1,95 @@
+#ifndef SENSOR_SNAPSHOT_H
+#define SENSOR_SNAPSHOT_H
+
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/viewport_texture.hpp>
+#include <godot_cpp/variant/color.hpp>
+
+#include "sensor_color_space.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+class SensorWorkerPool;
+
+// CPU copy of a single rendered viewport frame, stored as tightly packed RGBA8 rows.
+// One snapshot is taken per batch tick and every sensor region is sampled against it,
+// so the expensive get_image() readback happens once per tick instead of once per sensor.
+struct SensorSnapshot {
+    // Change detection granularity: one content hash per TILE_SIZE x TILE_SIZE tile
+    static constexpr int TILE_SIZE = 32;
+    static constexpr size_t SAT_TILE_ENTRIES = static_cast<size_t>(TILE_SIZE + 1) * (TILE_SIZE + 1) * 3;
+
+    int width = 0;
+    int height = 0;
+    uint64_t frame = 0; // Engine process frame the snapshot was captured on
+    std::vector<uint8_t> rgba8;
+    // Source image was a float (HDR) format: rgba8 holds linear values, not sRGB
+    bool linear_source = false;
+
+    // Tile signatures, refreshed on every ingest. generation increases monotonically (it is
+    // not reset by clear()), and tile_changed_generation records the ingest at which each tile
+    // last differed from the previous snapshot.
+    uint64_t generation = 0;
+    int tiles_x = 0;
+    int tiles_y = 0;
+    int last_changed_tiles = 0;
+    std::vector<uint64_t> tile_hashes;
+    std::vector<uint64_t> tile_changed_generation;
+
+    // Optional summed-area tables, one per tile so that partially changed frames only rebuild
+    // their dirty tiles and the sums fit in 32 bits. Each tile table is (TILE_SIZE + 1)^2 RGB
+    // entries with a zero first row and column. Values are the stored bytes, or the pixels
+    // decoded to 16-bit linear light for linear color modes.
+    std::vector<uint32_t> sat;
+    std::vector<uint64_t> sat_tile_generation; // Snapshot generation each tile table was built from
+    uint64_t sat_generation = 0; // Generation the tables were last brought up to date for
+    int sat_width = 0;
+    int sat_height = 0;
+    bool sat_decoded = false;
+    int last_sat_rebuilt_tiles = 0;
+
+    // Buffers only grow: a smaller frame reuses the existing capacity, so resolution changes
+    // back and forth settle without allocating. Counts ingests that had to grow a buffer.
+    uint64_t buffer_reallocations = 0;
+
+    bool is_valid() const { return width > 0 && height > 0 && !rgba8.empty(); }
+    // Drops the frame but keeps buffer capacity
+    void clear();
+    // Grow every buffer to fit a p_width x p_height frame ahead of the first ingest at that size
+    void reserve(int p_width, int p_height);
+
+    // Capture the current contents of a viewport texture (main thread only: calls get_image()).
+    bool capture(const Ref<ViewportTexture> &p_texture, uint64_t p_frame);
+    // Copy pixel data out of an already retrieved image, converting to RGBA8 when needed.
+    bool ingest_image(const Ref<Image> &p_image, uint64_t p_frame);
+
+    // Average the (2r+1)x(2r+1) square around (cx, cy), clipped to the frame bounds.
+    // Matches the per-node CPU path: integer center, RGB average, alpha forced to 1.
+    // Linear modes decode each 8-bit channel through the sRGB table before summing.
+    Color sample_region(float p_center_x, float p_center_y, int p_radius, SensorColorMode p_mode = SENSOR_COLOR_ENCODED) const;
+
+    // Bring the tile tables up to date for p_mode, rebuilding only tiles whose content changed
+    // since their table was built (all of them after a resize or mode change). Rebuilds are
+    // spread over p_pool when given; safe to call from a pool job.
+    void update_summed_area_tables(SensorColorMode p_mode, SensorWorkerPool *p_pool);
+    void drop_summed_area_tables();
+    // True when sample_region() can answer p_mode from the tables in O(tiles touched)
+    bool has_summed_area_tables(SensorColorMode p_mode) const;
+
+    // True if every tile touched by the region is unchanged since p_generation
+    bool is_region_unchanged_since(float p_center_x, float p_center_y, int p_radius, uint64_t p_generation) const;
+
+private:
+    std::vector<uint64_t> tile_scratch;
+    std::vector<uint32_t> sat_dirty_tiles;
+    void _update_tile_signatures();
+    void _build_tile_table(size_t p_tile, const uint16_t *p_decode);
+    Color _sample_region_sat(int p_x0, int p_y0, int p_x1, int p_y1, SensorColorMode p_mode) const;
+};
+
+} // namespace godot
+
+#endif // SENSOR_SNAPSHOT_H
@@ -0,0 +1,148 @@
+#include "sensor_task_graph.h"
+
+#include "sensor_clock.h"
+#include "sensor_worker_pool.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+using namespace godot;
+
+// Shared with pool helpers, which may still be queued after run() has returned; they only
+// touch the graph when they manage to claim a stage, which cannot happen once a run is over.
+struct SensorTaskGraph::RunState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<int> ready_worker;
+    std::deque<int> ready_caller;
+    size_t finished = 0;
+    size_t total = 0;
+};
+
+int SensorTaskGraph::add_stage(const char *p_name, std::function<void()> p_fn, std::initializer_list<int> p_dependencies, bool p_on_caller) {
+    if (stages.size() >= MAX_STAGES) {
+        return -1;
+    }
+
+    const int index = static_cast<int>(stages.size());
+    Stage stage;
+    stage.fn = std::move(p_fn);
+    stage.trace.name = p_name;
+    stage.trace.on_caller = p_on_caller;
+    for (int dependency : p_dependencies) {
+        if (dependency < 0 || dependency >= index) {
+            continue;
+        }
+        stage.trace.dependency_mask |= 1u << dependency;
+        stage.dependency_count++;
+        stages[dependency].dependents.push_back(index);
+    }
+    stages.push_back(std::move(stage));
+    return index;
+}
+
+void SensorTaskGraph::run(SensorWorkerPool *p_pool) {
+    if (stages.empty()) {
+        return;
+    }
+
+    auto state = std::make_shared<RunState>();
+    state->total = stages.size();
+    run_start_usec = sensor_steady_usec();
+    int helpers = 0;
+    for (size_t i = 0; i < stages.size(); ++i) {
+        Stage &stage = stages[i];
+        stage.remaining = stage.dependency_count;
+        stage.trace.start_usec = 0;
+        stage.trace.end_usec = 0;
+        if (stage.remaining == 0) {
+            if (stage.trace.on_caller) {
+                state->ready_caller.push_back(static_cast<int>(i));
+            } else {
+                state->ready_worker.push_back(static_cast<int>(i));
+                helpers++;
+            }
+        }
+    }
+    _submit_helpers(this, state, p_pool, helpers);
+
+    // The caller prefers its own stages, and otherwise helps with whatever is runnable
+    for (;;) {
+        int stage = -1;
+        uint8_t lane = LANE_CALLER;
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->cv.wait(lock, [&state] {
+                return state->finished == state->total || !state->ready_caller.empty() || !state->ready_worker.empty();
+            });
+            if (state->finished == state->total) {
+                break;
+            }
+            if (!state->ready_caller.empty()) {
+                stage = state->ready_caller.front();
+                state->ready_caller.pop_front();
+            } else {
+                stage = state->ready_worker.front();
+                state->ready_worker.pop_front();
+            }
+        }
+        _execute(stage, lane, state, p_pool);
+    }
+    last_run_usec = static_cast<uint32_t>(sensor_steady_usec() - run_start_usec);
+}
+
+void SensorTaskGraph::_execute(int p_stage, uint8_t p_lane, const std::shared_ptr<RunState> &p_state, SensorWorkerPool *p_pool) {
+    Stage &stage = stages[p_stage];
+    stage.trace.lane = p_lane;
+    stage.trace.start_usec = static_cast<uint32_t>(sensor_steady_usec() - run_start_usec);
+    stage.fn();
+    stage.trace.end_usec = static_cast<uint32_t>(sensor_steady_usec() - run_start_usec);
+
+    int helpers = 0;
+    {
+        std::lock_guard<std::mutex> lock(p_state->mutex);
+        for (int dependent : stage.dependents) {
+            Stage &next = stages[dependent];
+            if (--next.remaining == 0) {
+                if (next.trace.on_caller) {
+                    p_state->ready_caller.push_back(dependent);
+                } else {
+                    p_state->ready_worker.push_back(dependent);
+                    helpers++;
+                }
+            }
+        }
+        p_state->finished++;
+    }
+    // Past this point the run may be over and the graph gone: only p_state is safe to touch
+    _submit_helpers(this, p_state, p_pool, helpers);
+    p_state->cv.notify_all();
+}
+
+void SensorTaskGraph::_submit_helpers(SensorTaskGraph *p_graph, const std::shared_ptr<RunState> &p_state, SensorWorkerPool *p_pool, int p_count) {
+    if (!p_pool || p_pool->get_thread_count() == 0) {
+        return; // The caller runs everything
+    }
+    for (int i = 0; i < p_count; ++i) {
+        p_pool->submit([p_graph, p_state, p_pool]() {
+            int stage = -1;
+            {
+                std::lock_guard<std::mutex> lock(p_state->mutex);
+                if (p_state->ready_worker.empty()) {
+                    return; // The caller or another helper got there first
+                }
+                stage = p_state->ready_worker.front();
+                p_state->ready_worker.pop_front();
+            }
+            p_graph->_execute(stage, LANE_WORKER, p_state, p_pool);
+        });
+    }
+}
+
+void SensorTaskGraph::copy_trace(std::vector<StageTrace> &r_trace) const {
+    r_trace.resize(stages.size());
+    for (size_t i = 0; i < stages.size(); ++i) {
+        r_trace[i] = stages[i].trace;
+    }
+}
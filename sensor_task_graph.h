@@ -0,0 +1,76 @@
+#ifndef SENSOR_TASK_GRAPH_H
+#define SENSOR_TASK_GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+namespace godot {
+
+class SensorWorkerPool;
+
+// A fixed dependency graph of pipeline stages, built once and run once per batch.
+// Every stage whose dependencies have finished is runnable: helpers on SensorWorkerPool and
+// the calling thread claim runnable stages alike, so independent stages overlap and a graph
+// run from inside a pool job cannot starve waiting on busy workers. Stages marked on_caller
+// always run on the calling thread, in dependency order; use them for work tied to that
+// thread, such as taking and releasing a mutex around the stages that need it.
+// Timings of the last run are kept per stage for inspection.
+class SensorTaskGraph {
+public:
+    static constexpr int MAX_STAGES = 32;
+
+    enum Lane : uint8_t {
+        LANE_CALLER = 0,
+        LANE_WORKER = 1,
+    };
+
+    struct StageTrace {
+        const char *name = "";
+        uint32_t dependency_mask = 0; // Bit i: depends on stage i
+        uint32_t start_usec = 0; // Relative to the start of the run
+        uint32_t end_usec = 0;
+        uint8_t lane = LANE_CALLER;
+        bool on_caller = false;
+    };
+
+    SensorTaskGraph() = default;
+    SensorTaskGraph(const SensorTaskGraph &) = delete;
+    SensorTaskGraph &operator=(const SensorTaskGraph &) = delete;
+
+    // Dependencies must be stages added earlier. p_name must outlive the graph (a literal).
+    int add_stage(const char *p_name, std::function<void()> p_fn, std::initializer_list<int> p_dependencies = {}, bool p_on_caller = false);
+    size_t get_stage_count() const { return stages.size(); }
+
+    // Runs every stage once and returns when all have finished. p_pool may be null.
+    void run(SensorWorkerPool *p_pool);
+
+    // Copy of the last run's per-stage trace; reuses r_trace's capacity
+    void copy_trace(std::vector<StageTrace> &r_trace) const;
+    uint32_t get_last_run_usec() const { return last_run_usec; }
+
+private:
+    struct Stage {
+        std::function<void()> fn;
+        std::vector<int> dependents;
+        StageTrace trace;
+        int dependency_count = 0;
+        int remaining = 0; // Unfinished dependencies during a run
+    };
+
+    struct RunState;
+
+    std::vector<Stage> stages;
+    uint64_t run_start_usec = 0;
+    uint32_t last_run_usec = 0;
+
+    void _execute(int p_stage, uint8_t p_lane, const std::shared_ptr<RunState> &p_state, SensorWorkerPool *p_pool);
+    static void _submit_helpers(SensorTaskGraph *p_graph, const std::shared_ptr<RunState> &p_state, SensorWorkerPool *p_pool, int p_count);
+};
+
+} // namespace godot
+
+#endif // SENSOR_TASK_GRAPH_H
@@ -0,0 +1,59 @@
+#include "sensor_tick_arena.h"
+
+#include <algorithm>
+
+using namespace godot;
+
+void *SensorTickArena::allocate(size_t p_size, size_t p_align) {
+    if (p_size == 0) {
+        p_size = 1;
+    }
+
+    while (current < blocks.size()) {
+        Block &block = blocks[current];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+        const uintptr_t aligned = (base + block.used + p_align - 1) & ~(static_cast<uintptr_t>(p_align) - 1);
+        const size_t offset = static_cast<size_t>(aligned - base);
+        if (offset + p_size <= block.size) {
+            bytes_used += offset + p_size - block.used;
+            block.used = offset + p_size;
+            high_water = std::max(high_water, bytes_used);
+            return block.data.get() + offset;
+        }
+        current++;
+    }
+
+    _add_block(p_size + p_align);
+    return allocate(p_size, p_align);
+}
+
+void SensorTickArena::reset() {
+    if (blocks.size() > 1) {
+        // The tick outgrew the first block: replace them all with one block that fits it
+        blocks.clear();
+        _add_block(high_water);
+    }
+    for (Block &block : blocks) {
+        block.used = 0;
+    }
+    current = 0;
+    bytes_used = 0;
+    reset_count++;
+}
+
+size_t SensorTickArena::get_capacity() const {
+    size_t capacity = 0;
+    for (const Block &block : blocks) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+void SensorTickArena::_add_block(size_t p_min_size) {
+    Block block;
+    block.size = std::max(block_size, p_min_size);
+    block.data.reset(new uint8_t[block.size]);
+    blocks.push_back(std::move(block));
+    current = blocks.size() - 1;
+    block_allocations++;
+}
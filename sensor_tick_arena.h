@@ -0,0 +1,66 @@
+#ifndef SENSOR_TICK_ARENA_H
+#define SENSOR_TICK_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace godot {
+
+// Bump allocator for per-tick scratch (region copies, result staging). Allocations are
+// pointer bumps inside retained blocks; reset() at the end of the tick makes the whole arena
+// reusable without returning memory, so a steady-state tick touches the heap zero times.
+// Only trivially copyable, trivially destructible types may live here: nothing is destroyed.
+// Not thread-safe; one arena per owning thread.
+class SensorTickArena {
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    explicit SensorTickArena(size_t p_block_size = DEFAULT_BLOCK_SIZE) : block_size(p_block_size) {}
+
+    void *allocate(size_t p_size, size_t p_align = alignof(std::max_align_t));
+
+    template <typename T>
+    T *alloc_array(size_t p_count) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena memory is never destroyed");
+        T *items = static_cast<T *>(allocate(p_count * sizeof(T), alignof(T)));
+        for (size_t i = 0; i < p_count; ++i) {
+            new (items + i) T();
+        }
+        return items;
+    }
+
+    // Rewind every block. Blocks beyond the first are merged into one of the high-water size,
+    // so a tick that once spilled over settles into a single block.
+    void reset();
+
+    size_t get_bytes_used() const { return bytes_used; }
+    size_t get_high_water() const { return high_water; }
+    size_t get_capacity() const;
+    uint64_t get_block_allocations() const { return block_allocations; }
+    uint64_t get_reset_count() const { return reset_count; }
+
+private:
+    struct Block {
+        std::unique_ptr<uint8_t[]> data;
+        size_t size = 0;
+        size_t used = 0;
+    };
+
+    std::vector<Block> blocks;
+    size_t current = 0;
+    size_t block_size;
+    size_t bytes_used = 0;
+    size_t high_water = 0;
+    uint64_t block_allocations = 0;
+    uint64_t reset_count = 0;
+
+    void _add_block(size_t p_min_size);
+};
+
+} // namespace godot
+
+#endif // SENSOR_TICK_ARENA_H
@@ -0,0 +1,119 @@
+#include "sensor_worker_pool.h"
+
+#include <godot_cpp/classes/os.hpp>
+
+#include <algorithm>
+#include <memory>
+
+using namespace godot;
+
+static SensorWorkerPool *g_worker_pool = nullptr;
+static std::mutex g_worker_pool_mutex;
+
+SensorWorkerPool *SensorWorkerPool::get_singleton() {
+    std::lock_guard<std::mutex> lock(g_worker_pool_mutex);
+    if (!g_worker_pool) {
+        // Leave one core for the main thread and the renderer
+        const int cores = OS::get_singleton() ? OS::get_singleton()->get_processor_count() : 2;
+        g_worker_pool = new SensorWorkerPool(std::clamp(cores - 1, 1, 8));
+    }
+    return g_worker_pool;
+}
+
+void SensorWorkerPool::shutdown_singleton() {
+    std::lock_guard<std::mutex> lock(g_worker_pool_mutex);
+    delete g_worker_pool;
+    g_worker_pool = nullptr;
+}
+
+SensorWorkerPool::SensorWorkerPool(int p_threads) {
+    threads.reserve(p_threads);
+    for (int i = 0; i < p_threads; ++i) {
+        threads.emplace_back(&SensorWorkerPool::_worker_loop, this);
+    }
+}
+
+SensorWorkerPool::~SensorWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    queue_cv.notify_all();
+    for (std::thread &thread : threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+void SensorWorkerPool::submit(std::function<void()> p_job) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        jobs.push_back(std::move(p_job));
+    }
+    queue_cv.notify_one();
+}
+
+void SensorWorkerPool::_worker_loop() {
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_cv.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) {
+                return; // Stopping and drained
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+
+void SensorWorkerPool::parallel_for(size_t p_count, size_t p_min_batch, const std::function<void(size_t, size_t)> &p_fn) {
+    if (p_count == 0) {
+        return;
+    }
+
+    const size_t batch = std::max<size_t>(p_min_batch, 1);
+    const size_t batches = (p_count + batch - 1) / batch;
+    if (batches == 1 || threads.empty()) {
+        p_fn(0, p_count);
+        return;
+    }
+
+    // Batches are claimed from a shared counter by helpers and by the caller alike, so a
+    // parallel_for issued from inside a worker job cannot deadlock waiting on busy workers.
+    struct State {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+    auto state = std::make_shared<State>();
+
+    auto run = [state, batch, batches, p_count, &p_fn]() {
+        for (;;) {
+            const size_t index = state->next.fetch_add(1);
+            if (index >= batches) {
+                return;
+            }
+            const size_t begin = index * batch;
+            p_fn(begin, std::min(begin + batch, p_count));
+            if (state->done.fetch_add(1) + 1 == batches) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->cv.notify_all();
+            }
+        }
+    };
+
+    const size_t helpers = std::min(batches - 1, threads.size());
+    for (size_t i = 0; i < helpers; ++i) {
+        submit(run);
+    }
+    run();
+
+    // p_fn is captured by reference: wait until every claimed batch has finished
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [&state, batches] { return state->done.load() == batches; });
+}
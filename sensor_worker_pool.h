@@ -0,0 +1,77 @@
+#ifndef SENSOR_WORKER_POOL_H
+#define SENSOR_WORKER_POOL_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace godot {
+
+// Process-wide pool of worker threads shared by every sensor pipeline. Jobs must not
+// touch scene nodes; they receive plain data (images, region copies) and hand results
+// back to the main thread.
+class SensorWorkerPool {
+public:
+    // Created on first use, sized from the processor count; destroyed at module teardown
+    static SensorWorkerPool *get_singleton();
+    static void shutdown_singleton();
+
+    void submit(std::function<void()> p_job);
+    // Runs p_fn(begin, end) over [0, p_count) split across the pool and the calling thread
+    void parallel_for(size_t p_count, size_t p_min_batch, const std::function<void(size_t, size_t)> &p_fn);
+
+    int get_thread_count() const { return static_cast<int>(threads.size()); }
+
+private:
+    explicit SensorWorkerPool(int p_threads);
+    ~SensorWorkerPool();
+
+    std::vector<std::thread> threads;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<std::function<void()>> jobs;
+    bool stopping = false;
+
+    void _worker_loop();
+};
+
+// Bounded single-producer/single-consumer ring. One thread pushes, one thread pops; no locks.
+template <typename T, size_t N>
+class SpscRing {
+public:
+    bool push(T &&p_item) {
+        const size_t head = write_index.load(std::memory_order_relaxed);
+        const size_t next = (head + 1) % N;
+        if (next == read_index.load(std::memory_order_acquire)) {
+            return false; // Full
+        }
+        items[head] = std::move(p_item);
+        write_index.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &r_item) {
+        const size_t tail = read_index.load(std::memory_order_relaxed);
+        if (tail == write_index.load(std::memory_order_acquire)) {
+            return false; // Empty
+        }
+        r_item = std::move(items[tail]);
+        read_index.store((tail + 1) % N, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, N> items;
+    std::atomic<size_t> write_index{0};
+    std::atomic<size_t> read_index{0};
+};
+
+} // namespace godot
+
+#endif // SENSOR_WORKER_POOL_H
@@ -0,0 +1,290 @@
+#define _GNU_SOURCE
+#include "lss_shm_reader.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LSS_ACQUIRE_ATTEMPTS 16
+
+struct lss_reader {
+    const lss_shm_header *header;
+    size_t mapped_size;
+    uint64_t seen_count; /* publish_count covered by the last acquire/copy */
+    int notify_fd;
+    int notify_tried;
+};
+
+int lss_reader_open(const char *name, lss_reader **out_reader) {
+    *out_reader = NULL;
+
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return LSS_ERR_OPEN;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(lss_shm_header)) {
+        close(fd);
+        return LSS_ERR_OPEN;
+    }
+
+    void *mem = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) {
+        return LSS_ERR_OPEN;
+    }
+
+    const lss_shm_header *header = (const lss_shm_header *)mem;
+    if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != LSS_SHM_MAGIC || header->version != LSS_SHM_VERSION ||
+            header->slot_count == 0 || header->slot_size != lss_slot_size(header->slot_capacity) ||
+            (size_t)st.st_size < lss_segment_size(header->slot_capacity, header->slot_count)) {
+        munmap(mem, (size_t)st.st_size);
+        return LSS_ERR_FORMAT;
+    }
+
+    lss_reader *reader = (lss_reader *)calloc(1, sizeof(lss_reader));
+    if (!reader) {
+        munmap(mem, (size_t)st.st_size);
+        return LSS_ERR_OPEN;
+    }
+    reader->header = header;
+    reader->mapped_size = (size_t)st.st_size;
+    reader->notify_fd = -1;
+    *out_reader = reader;
+    return LSS_OK;
+}
+
+void lss_reader_close(lss_reader *reader) {
+    if (!reader) {
+        return;
+    }
+    if (reader->notify_fd >= 0) {
+        close(reader->notify_fd);
+    }
+    munmap((void *)reader->header, reader->mapped_size);
+    free(reader);
+}
+
+const lss_shm_header *lss_reader_header(const lss_reader *reader) {
+    return reader->header;
+}
+
+uint64_t lss_reader_publish_count(const lss_reader *reader) {
+    return __atomic_load_n(&reader->header->publish_count, __ATOMIC_ACQUIRE);
+}
+
+static int lss_is_closed(const lss_reader *reader) {
+    return (__atomic_load_n(&reader->header->flags, __ATOMIC_ACQUIRE) & LSS_SHM_FLAG_CLOSED) != 0;
+}
+
+static const uint8_t *lss_slot_ptr(const lss_reader *reader, uint64_t tick) {
+    const lss_shm_header *h = reader->header;
+    return (const uint8_t *)h + h->header_size + (size_t)(tick % h->slot_count) * h->slot_size;
+}
+
+/* Reads the slot metadata of the newest tick under the seqlock; payload pointers are set
+ * but the payload itself still has to be validated by the caller. */
+static int lss_acquire_meta(lss_reader *reader, lss_tick_view *view) {
+    const uint32_t capacity = reader->header->slot_capacity;
+
+    for (int attempt = 0; attempt < LSS_ACQUIRE_ATTEMPTS; ++attempt) {
+        if (lss_is_closed(reader)) {
+            return LSS_ERR_CLOSED;
+        }
+
+        const uint64_t published = lss_reader_publish_count(reader);
+        if (published == 0) {
+            return LSS_ERR_EMPTY;
+        }
+
+        const uint8_t *slot = lss_slot_ptr(reader, published - 1);
+        const lss_shm_slot_header *slot_header = (const lss_shm_slot_header *)slot;
+        const uint64_t seq = __atomic_load_n(&slot_header->sequence, __ATOMIC_ACQUIRE);
+        if (seq & 1) {
+            sched_yield();
+            continue;
+        }
+
+        view->tick = slot_header->tick;
+        view->frame = slot_header->frame;
+        view->timestamp_usec = slot_header->timestamp_usec;
+        view->count = slot_header->count < capacity ? slot_header->count : capacity;
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot_header->sequence, __ATOMIC_RELAXED) != seq) {
+            continue;
+        }
+
+        view->ids = (const int32_t *)(slot + lss_slot_ids_offset(capacity));
+        view->colors = (const float *)(slot + lss_slot_colors_offset(capacity));
+        view->luminance = (const float *)(slot + lss_slot_luminance_offset(capacity));
+        view->slot = slot_header;
+        view->sequence = seq;
+        return LSS_OK;
+    }
+    return LSS_ERR_BUSY;
+}
+
+int lss_reader_acquire_latest(lss_reader *reader, lss_tick_view *out_view) {
+    const int result = lss_acquire_meta(reader, out_view);
+    if (result == LSS_OK) {
+        reader->seen_count = out_view->tick + 1;
+    }
+    return result;
+}
+
+int lss_reader_view_valid(const lss_tick_view *view) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&view->slot->sequence, __ATOMIC_RELAXED) == view->sequence;
+}
+
+int lss_reader_copy_latest(lss_reader *reader, lss_tick_view *out_view, int32_t *ids, float *colors, float *luminance, uint32_t capacity) {
+    for (int attempt = 0; attempt < LSS_ACQUIRE_ATTEMPTS; ++attempt) {
+        lss_tick_view view;
+        const int result = lss_acquire_meta(reader, &view);
+        if (result != LSS_OK) {
+            return result;
+        }
+        if (view.count > capacity) {
+            return LSS_ERR_RANGE;
+        }
+
+        if (ids) {
+            memcpy(ids, view.ids, view.count * sizeof(int32_t));
+        }
+        if (colors) {
+            memcpy(colors, view.colors, view.count * 4 * sizeof(float));
+        }
+        if (luminance) {
+            memcpy(luminance, view.luminance, view.count * sizeof(float));
+        }
+
+        if (!lss_reader_view_valid(&view)) {
+            continue;
+        }
+
+        *out_view = view;
+        out_view->ids = NULL;
+        out_view->colors = NULL;
+        out_view->luminance = NULL;
+        reader->seen_count = view.tick + 1;
+        return LSS_OK;
+    }
+    return LSS_ERR_BUSY;
+}
+
+#ifdef __linux__
+
+int lss_reader_notify_fd(lss_reader *reader) {
+    if (reader->notify_fd >= 0) {
+        return reader->notify_fd;
+    }
+    if (!(__atomic_load_n(&reader->header->flags, __ATOMIC_ACQUIRE) & LSS_SHM_FLAG_NOTIFY)) {
+        return LSS_ERR_NOTIFY;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    const size_t path_len = strnlen(reader->header->notify_path, LSS_SHM_NOTIFY_PATH_MAX);
+    if (path_len == 0 || path_len >= sizeof(addr.sun_path)) {
+        return LSS_ERR_NOTIFY;
+    }
+    memcpy(addr.sun_path, reader->header->notify_path, path_len);
+
+    int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        return LSS_ERR_NOTIFY;
+    }
+    /* The writer hands out the eventfd on its next publish; give up after one second */
+    struct timeval tv = { 1, 0 };
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(sock);
+        return LSS_ERR_NOTIFY;
+    }
+
+    char byte;
+    struct iovec iov = { &byte, 1 };
+    union {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    const ssize_t received = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+    close(sock);
+    struct cmsghdr *cmsg = received > 0 ? CMSG_FIRSTHDR(&msg) : NULL;
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+        return LSS_ERR_NOTIFY;
+    }
+    memcpy(&reader->notify_fd, CMSG_DATA(cmsg), sizeof(int));
+    return reader->notify_fd;
+}
+
+#else
+
+int lss_reader_notify_fd(lss_reader *reader) {
+    (void)reader;
+    return LSS_ERR_NOTIFY;
+}
+
+#endif
+
+static uint64_t lss_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+int lss_reader_wait(lss_reader *reader, int timeout_ms) {
+    const uint64_t deadline = lss_now_ms() + (uint64_t)(timeout_ms > 0 ? timeout_ms : 0);
+
+    if (!reader->notify_tried) {
+        reader->notify_tried = 1;
+        lss_reader_notify_fd(reader);
+    }
+
+    for (;;) {
+        if (lss_is_closed(reader)) {
+            return LSS_ERR_CLOSED;
+        }
+        if (lss_reader_publish_count(reader) > reader->seen_count) {
+            return LSS_OK;
+        }
+
+        const uint64_t now = lss_now_ms();
+        if (now >= deadline) {
+            return LSS_ERR_TIMEOUT;
+        }
+
+        if (reader->notify_fd >= 0) {
+            struct pollfd pfd = { reader->notify_fd, POLLIN, 0 };
+            if (poll(&pfd, 1, (int)(deadline - now)) > 0) {
+                uint64_t counter;
+                ssize_t drained = read(reader->notify_fd, &counter, sizeof(counter));
+                (void)drained;
+            }
+        } else {
+            /* No notification channel: poll publish_count at 1 kHz */
+            struct timespec ts = { 0, 1000000 };
+            nanosleep(&ts, NULL);
+        }
+    }
+}
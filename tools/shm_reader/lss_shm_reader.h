@@ -0,0 +1,82 @@
+#ifndef LSS_SHM_READER_H
+#define LSS_SHM_READER_H
+
+/*
+ * Reader for the LightSensorManager shared-memory export.
+ * Segment layout and versioning rules: sensor_shm_layout.h (repository root).
+ *
+ * Typical use:
+ *
+ *   lss_reader *r;
+ *   if (lss_reader_open(LSS_SHM_DEFAULT_NAME, &r) != LSS_OK) ...
+ *   while (lss_reader_wait(r, 1000) == LSS_OK) {
+ *       lss_tick_view v;
+ *       if (lss_reader_acquire_latest(r, &v) != LSS_OK) continue;
+ *       ... read v.ids / v.colors / v.luminance in place ...
+ *       if (!lss_reader_view_valid(&v)) continue; // writer overwrote the slot meanwhile
+ *   }
+ *   lss_reader_close(r);
+ */
+
+#include "sensor_shm_layout.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    LSS_OK = 0,
+    LSS_ERR_OPEN = -1,    /* Segment missing or not mappable */
+    LSS_ERR_FORMAT = -2,  /* Bad magic or unsupported version */
+    LSS_ERR_EMPTY = -3,   /* Nothing published yet */
+    LSS_ERR_BUSY = -4,    /* Slot was being written; retry */
+    LSS_ERR_CLOSED = -5,  /* Writer detached; close and reopen */
+    LSS_ERR_TIMEOUT = -6, /* lss_reader_wait() timed out */
+    LSS_ERR_NOTIFY = -7,  /* Notification unavailable */
+    LSS_ERR_RANGE = -8    /* Caller buffer too small */
+};
+
+typedef struct lss_reader lss_reader;
+
+/* Zero-copy view into one slot. Pointers stay inside the shared mapping. */
+typedef struct lss_tick_view {
+    uint64_t tick;
+    uint64_t frame;
+    uint64_t timestamp_usec;
+    uint32_t count;
+    const int32_t *ids;
+    const float *colors;    /* count * 4 floats, RGBA */
+    const float *luminance; /* count floats */
+
+    /* Internal: used by lss_reader_view_valid() */
+    const lss_shm_slot_header *slot;
+    uint64_t sequence;
+} lss_tick_view;
+
+int lss_reader_open(const char *name, lss_reader **out_reader);
+void lss_reader_close(lss_reader *reader);
+const lss_shm_header *lss_reader_header(const lss_reader *reader);
+
+/* Ticks published so far; 0 when nothing was published yet */
+uint64_t lss_reader_publish_count(const lss_reader *reader);
+
+/* Fill a view of the newest complete tick. Retries internally a few times on LSS_ERR_BUSY. */
+int lss_reader_acquire_latest(lss_reader *reader, lss_tick_view *out_view);
+/* Non-zero if the slot behind the view has not been rewritten since it was acquired */
+int lss_reader_view_valid(const lss_tick_view *view);
+
+/* Copy the newest tick into caller buffers (colors needs 4 * capacity floats).
+ * Any buffer may be NULL. out_view is filled with metadata; its pointers are not set. */
+int lss_reader_copy_latest(lss_reader *reader, lss_tick_view *out_view, int32_t *ids, float *colors, float *luminance, uint32_t capacity);
+
+/* Block until a tick newer than the last acquired/copied one is published.
+ * Uses the writer's eventfd when available (Linux), otherwise polls publish_count. */
+int lss_reader_wait(lss_reader *reader, int timeout_ms);
+/* Connect to the writer's notification socket and receive its eventfd (Linux only). */
+int lss_reader_notify_fd(lss_reader *reader);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* LSS_SHM_READER_H */
@@ -0,0 +1,118 @@
+/*
+ * Test reader for the LightSensorManager shared-memory export.
+ *
+ *   lss_test_reader [name] [ticks]
+ *
+ * Attaches to the segment (default LSS_SHM_DEFAULT_NAME), waits for `ticks` new ticks
+ * (default 60) and checks the invariants a consumer relies on: ticks and frames never go
+ * backwards, counts fit the slot capacity, colors and luminance are finite and in range.
+ * Exits non-zero on the first violation.
+ */
+
+#include "lss_shm_reader.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int check_tick(const lss_tick_view *view, const int32_t *ids, const float *colors, const float *luminance) {
+    for (uint32_t i = 0; i < view->count; ++i) {
+        for (int c = 0; c < 4; ++c) {
+            const float v = colors[i * 4 + c];
+            if (!isfinite(v) || v < 0.0f || v > 1.0f) {
+                fprintf(stderr, "tick %llu: sensor %d color component %d out of range (%f)\n",
+                        (unsigned long long)view->tick, ids[i], c, v);
+                return 0;
+            }
+        }
+        if (!isfinite(luminance[i]) || luminance[i] < 0.0f || luminance[i] > 1.0f) {
+            fprintf(stderr, "tick %llu: sensor %d luminance out of range (%f)\n",
+                    (unsigned long long)view->tick, ids[i], luminance[i]);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    const char *name = argc > 1 ? argv[1] : LSS_SHM_DEFAULT_NAME;
+    const long ticks = argc > 2 ? strtol(argv[2], NULL, 10) : 60;
+
+    lss_reader *reader;
+    int result = lss_reader_open(name, &reader);
+    if (result != LSS_OK) {
+        fprintf(stderr, "cannot open %s (error %d)\n", name, result);
+        return 1;
+    }
+
+    const lss_shm_header *header = lss_reader_header(reader);
+    const uint32_t capacity = header->slot_capacity;
+    printf("%s: writer pid %u, %u slots x %u sensors, notify %s\n", name, header->writer_pid,
+            header->slot_count, capacity, lss_reader_notify_fd(reader) >= 0 ? header->notify_path : "off");
+
+    int32_t *ids = (int32_t *)malloc(capacity * sizeof(int32_t));
+    float *colors = (float *)malloc(capacity * 4 * sizeof(float));
+    float *luminance = (float *)malloc(capacity * sizeof(float));
+    if (!ids || !colors || !luminance) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    int status = 0;
+    uint64_t last_tick = 0;
+    uint64_t last_frame = 0;
+    uint64_t skipped = 0;
+    int have_last = 0;
+    for (long n = 0; n < ticks; ++n) {
+        result = lss_reader_wait(reader, 2000);
+        if (result != LSS_OK) {
+            fprintf(stderr, "wait failed after %ld ticks (error %d)\n", n, result);
+            status = 1;
+            break;
+        }
+
+        lss_tick_view view;
+        result = lss_reader_copy_latest(reader, &view, ids, colors, luminance, capacity);
+        if (result == LSS_ERR_BUSY) {
+            continue;
+        }
+        if (result != LSS_OK) {
+            fprintf(stderr, "read failed (error %d)\n", result);
+            status = 1;
+            break;
+        }
+
+        if (have_last && (view.tick <= last_tick || view.frame < last_frame)) {
+            fprintf(stderr, "tick %llu frame %llu went backwards (previous %llu / %llu)\n",
+                    (unsigned long long)view.tick, (unsigned long long)view.frame,
+                    (unsigned long long)last_tick, (unsigned long long)last_frame);
+            status = 1;
+            break;
+        }
+        if (!check_tick(&view, ids, colors, luminance)) {
+            status = 1;
+            break;
+        }
+
+        if (have_last) {
+            skipped += view.tick - last_tick - 1;
+        }
+        last_tick = view.tick;
+        last_frame = view.frame;
+        have_last = 1;
+
+        printf("tick %llu frame %llu t=%llu us: %u sensors", (unsigned long long)view.tick,
+                (unsigned long long)view.frame, (unsigned long long)view.timestamp_usec, view.count);
+        if (view.count > 0) {
+            printf(", #%d lum %.3f rgb(%.3f %.3f %.3f)", ids[0], luminance[0], colors[0], colors[1], colors[2]);
+        }
+        printf("\n");
+    }
+
+    printf("%s (%llu ticks missed)\n", status == 0 ? "OK" : "FAILED", (unsigned long long)skipped);
+    free(ids);
+    free(colors);
+    free(luminance);
+    lss_reader_close(reader);
+    return status;
+}